@@ -1,12 +1,15 @@
 #include "Mantaray/Core/Window.hpp"
 #include "Mantaray/Core/KeyCodes.hpp"
 #include "Mantaray/Core/InputManager.hpp"
+#include "Mantaray/Core/InputRecording.hpp"
+#include "Mantaray/Core/SpriteAnimation.hpp"
 #include "Mantaray/OpenGL/Drawables.hpp"
 #include "Mantaray/OpenGL/ObjectLibrary.hpp"
 
 #include <iostream>
 #include <vector>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 using namespace MR;
@@ -96,30 +99,57 @@ inline void Update(float deltaTime) {
     }
 } 
 
-int main()
+// --record <file> saves the session, --replay <file> plays it back, add --unthrottled to replay without vsync.
+// --threaded renders on a separate thread.
+int main(int argc, char** argv)
 {
-    srand(time(NULL));
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    bool unthrottled = false;
+    bool threaded = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--unthrottled") == 0) {
+            unthrottled = true;
+        }
+        else if (strcmp(argv[i], "--threaded") == 0) {
+            threaded = true;
+        }
+    }
 
     window = Window::CreateWindow("Snake", Vector2u(320, 288), Vector2u(160, 144), Vector2f(gridSize.x, gridSize.y));
     window->setClearColor(MR::Color(48, 98, 48));
-    
-    InputManager::AddKeyToWatch(MR_KEY_ESCAPE);
-    InputManager::AddKeyToWatch(MR_KEY_SPACE);
 
-    InputManager::AddKeyToWatch(MR_KEY_W);
-    InputManager::AddKeyToWatch(MR_KEY_A);
-    InputManager::AddKeyToWatch(MR_KEY_S);
-    InputManager::AddKeyToWatch(MR_KEY_D);
+    unsigned int seed = time(NULL);
+    bool replaying = replayPath != nullptr && InputRecording::StartReplay(replayPath, unthrottled);
+    if (replaying) {
+        seed = InputRecording::GetSeed();
+    }
+    else if (recordPath != nullptr) {
+        InputRecording::StartRecording(recordPath, seed);
+    }
+    srand(seed);
     
     Texture* tileSheet = ObjectLibrary::CreateTexture("spriteSheet", "Content/snake.png");
 
+    Vector2u sheetSize = Vector2u(tileSheet->getWidth(), tileSheet->getHeight());
+    Vector2u tileSize = Vector2u(8, 8);
+
     Sprite snakeNodeSprite = Sprite(tileSheet);
     snakeNodeSprite.absoluteSize = true;
-    snakeNodeSprite.sourceRectangle = Rectanglef(0, .75f, .25f, .25f);
+    snakeNodeSprite.sourceRectangle = AnimationClip::GetGridCell(sheetSize, tileSize, 0);
 
     Sprite appleSprite = Sprite(tileSheet);
     appleSprite.absoluteSize = true;
-    appleSprite.sourceRectangle = Rectanglef(.25f, .75f, .25f, .25f);
+    appleSprite.sourceRectangle = AnimationClip::GetGridCell(sheetSize, tileSize, 1);
+
+    // Started once the textures are loaded, the game thread gives up the GL context
+    window->setThreadedRendering(threaded);
 
     float deltaTime;
     while (!window->getShouldClose()) {
@@ -148,5 +178,9 @@ int main()
         window->endFrame();
     }
 
+    if (replaying) {
+        FrameStats average = window->getAverageFrameStats();
+        std::cout << "Replayed " << InputRecording::GetFrameIndex() << " frames, average frame time " << average.frameTime * 1000.f << " ms" << std::endl;
+    }
     return 0;
 }
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Mantaray/Core/MappedFile.hpp"
+
+namespace MR {
+// Read only archive of many small files, memory mapped as a whole.
+// Layout: header, entry data on 16 byte boundaries, an index sorted by name hash and finally the
+// names the index points into. Entries are stored raw or as one LZ4 block. All fields are little endian.
+class AssetPack {
+    public:
+        enum Compression {
+            COMPRESSION_NONE = 0,
+            COMPRESSION_LZ4 = 1
+        };
+
+        struct Header {
+            char magic[4];
+            uint32_t version;
+            uint32_t entryCount;
+            uint32_t reserved;
+            uint64_t indexOffset;
+            uint64_t namesOffset;
+        };
+
+        struct Entry {
+            uint64_t hash;
+            uint64_t offset;
+            uint64_t storedSize;
+            uint64_t size;
+            uint32_t nameOffset;
+            uint32_t nameLength;
+            uint32_t compression;
+            uint32_t reserved;
+        };
+
+        struct Source {
+            // Name the entry is looked up by, relative to the working directory
+            std::string name;
+            std::string filePath;
+        };
+
+        static const uint32_t Version = 1;
+
+        // Uses forward slashes and strips leading "./" so lookups match however the path was written
+        static std::string NormalizeName(std::string name);
+        static uint64_t HashName(const std::string& normalizedName);
+        // compress stores an entry as LZ4 only when that saves at least an eighth of its size
+        static bool Write(std::string packPath, std::vector<Source>& sources, bool compress = true);
+
+        AssetPack();
+        AssetPack(std::string path);
+
+        bool open(std::string path);
+        void close();
+        bool isOpen();
+
+        std::string getPath();
+        unsigned int getEntryCount();
+        const Entry* findEntry(std::string name);
+
+        // Zero copy access for entries stored raw. Compressed entries are decompressed into storage and
+        // data points there. Either way data stays valid while the pack is open and storage is untouched.
+        bool read(std::string name, const unsigned char*& data, size_t& size, std::vector<unsigned char>& storage);
+        bool read(std::string name, std::string& content);
+
+    private:
+        bool decompress(const Entry* entry, unsigned char* destination);
+
+    private:
+        MappedFile m_File;
+        std::string m_Path = "";
+        const Header* m_Header = nullptr;
+        const Entry* m_Entries = nullptr;
+        const char* m_Names = nullptr;
+};
+}
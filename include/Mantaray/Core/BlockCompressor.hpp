@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Mantaray/Core/Vector.hpp"
+
+namespace MR {
+enum BlockFormat {
+    // Opaque RGB, 8 bytes per 4x4 block (S3TC DXT1)
+    BLOCK_FORMAT_BC1,
+    // RGB with interpolated alpha, 16 bytes per block (S3TC DXT5)
+    BLOCK_FORMAT_BC3,
+    // Single channel, 8 bytes per block (RGTC1)
+    BLOCK_FORMAT_BC4
+};
+
+// CPU encoder and decoder for 4x4 block compressed textures.
+// Input is 8 bit data with 1 to 4 channels interpreted like Image::getPixel, BC4 encodes the red channel.
+// Partial blocks at the right and top edge repeat the last row/column.
+class BlockCompressor {
+    public:
+        static unsigned int GetBlockByteSize(BlockFormat format);
+        static size_t GetCompressedSize(Vector2u size, BlockFormat format);
+
+        // Rows are spread over at most threadCount JobSystem threads, 0 uses all of them and 1 the calling thread only
+        static bool Compress(const unsigned char* source, Vector2u size, int nrChannels, BlockFormat format, std::vector<unsigned char>& destination, unsigned int threadCount = 0);
+        // Writes 4 channel data, BC4 is expanded to (r, 0, 0, 255) and BC1 alpha is opaque
+        static void Decompress(const unsigned char* source, Vector2u size, BlockFormat format, unsigned char* destination);
+
+        // Peak signal to noise ratio in dB over the first nrChannels channels of two equally sized buffers
+        static double ComputePSNR(const unsigned char* a, const unsigned char* b, size_t pixelCount, int nrChannels, int stride = 4);
+};
+}
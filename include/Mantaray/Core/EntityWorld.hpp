@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Mantaray/Core/Vector.hpp"
+#include "Mantaray/Core/Color.hpp"
+#include "Mantaray/Core/Shapes.hpp"
+#include "Mantaray/Core/JobSystem.hpp"
+#include "Mantaray/Core/SpriteAnimation.hpp"
+
+namespace MR {
+// Reference to an entity of an EntityWorld. Like Handle the generation changes when the entity is
+// destroyed, so a stale reference is detected instead of reaching whatever reuses the slot.
+struct Entity {
+    public:
+        bool isNull() const {
+            return generation == 0;
+        }
+
+        bool operator==(Entity b) const {
+            return (this->index == b.index && this->generation == b.generation);
+        }
+        bool operator!=(Entity b) const {
+            return (this->index != b.index || this->generation != b.generation);
+        }
+
+    public:
+        uint32_t index = 0;
+        uint32_t generation = 0;
+};
+
+struct TransformComponent {
+    Vector2f position = Vector2f(0, 0);
+    Vector2f size = Vector2f(1, 1);
+    float rotation = 0;
+    Vector2f rotationCenter = Vector2f(.5f, .5f);
+};
+
+// Same meaning as the fields of Drawable, without the size multiplied by the texture size
+// unless absoluteSize is set
+struct SpriteComponent {
+    class Texture* texture = nullptr;
+    class Shader* shader = nullptr;
+    Rectanglef sourceRectangle = Rectanglef(0, 0, 1, 1);
+    bool absoluteSize = false;
+};
+
+// Up to ChunkCapacity entities of one archetype. Each component present in the archetype is a
+// separate contiguous array indexed by row, arrays of missing components are nullptr.
+class EntityChunk {
+    friend class EntityWorld;
+
+    public:
+        unsigned int size() const { return m_Count; }
+        unsigned int getComponents() const { return m_Components; }
+
+        const Entity* getEntities() { return m_Entities.data(); }
+        TransformComponent* getTransforms() { return m_Transforms.empty() ? nullptr : m_Transforms.data(); }
+        SpriteComponent* getSprites() { return m_Sprites.empty() ? nullptr : m_Sprites.data(); }
+        Color* getColors() { return m_Colors.empty() ? nullptr : m_Colors.data(); }
+        int* getLayers() { return m_Layers.empty() ? nullptr : m_Layers.data(); }
+        AnimationState* getAnimations() { return m_Animations.empty() ? nullptr : m_Animations.data(); }
+
+    private:
+        EntityChunk(unsigned int components);
+
+    private:
+        unsigned int m_Components;
+        unsigned int m_Count = 0;
+        // Allocated at full capacity, pointers into a chunk stay valid until entities are added or removed
+        std::vector<Entity> m_Entities;
+        std::vector<TransformComponent> m_Transforms;
+        std::vector<SpriteComponent> m_Sprites;
+        std::vector<Color> m_Colors;
+        std::vector<int> m_Layers;
+        std::vector<AnimationState> m_Animations;
+};
+
+// Entities stored by archetype, the set of components they have. Each archetype keeps its entities
+// densely packed in chunks, so systems stream through plain arrays instead of chasing one object per
+// entity. Removing an entity moves the last one of its archetype into the gap, which reorders rows
+// and invalidates component pointers of that archetype.
+//
+//     world.forEachChunk(EntityWorld::COMPONENT_TRANSFORM, [&](EntityChunk& chunk) {
+//         TransformComponent* transforms = chunk.getTransforms();
+//         for (unsigned int i = 0; i < chunk.size(); i++) { ... }
+//     });
+//
+// Entities must not be created, destroyed or change components while chunks are being iterated.
+class EntityWorld {
+    public:
+        enum Component {
+            COMPONENT_TRANSFORM = 1 << 0,
+            COMPONENT_SPRITE = 1 << 1,
+            COMPONENT_COLOR = 1 << 2,
+            COMPONENT_LAYER = 1 << 3,
+            // Advanced by AnimatorPool::update, which writes the sprite's source rectangle
+            COMPONENT_ANIMATION = 1 << 4,
+            COMPONENT_RENDERABLE = COMPONENT_TRANSFORM | COMPONENT_SPRITE | COMPONENT_COLOR | COMPONENT_LAYER,
+            COMPONENT_ALL = (1 << 5) - 1
+        };
+
+        static const unsigned int ChunkCapacity = 1024;
+
+        EntityWorld();
+        ~EntityWorld();
+        EntityWorld(const EntityWorld&) = delete;
+        EntityWorld& operator=(const EntityWorld&) = delete;
+
+        // New components start out with their defaults, white for color and 0 for layer
+        Entity createEntity(unsigned int components = COMPONENT_RENDERABLE);
+        // Copies a Sprite into an entity with the renderable components
+        Entity createEntity(const struct Sprite& sprite, int layer = 0);
+        void destroyEntity(Entity entity);
+        bool isAlive(Entity entity);
+        void clear();
+
+        unsigned int getComponents(Entity entity);
+        // Moves the entity to the archetype of the new component set, shared components keep their values
+        void setComponents(Entity entity, unsigned int components);
+        void addComponents(Entity entity, unsigned int components);
+        void removeComponents(Entity entity, unsigned int components);
+
+        // nullptr if the entity is stale or lacks the component
+        TransformComponent* getTransform(Entity entity);
+        SpriteComponent* getSprite(Entity entity);
+        Color* getColor(Entity entity);
+        int* getLayer(Entity entity);
+        AnimationState* getAnimation(Entity entity);
+
+        unsigned int getEntityCount();
+
+        // Calls function(EntityChunk&) for every non empty chunk whose archetype has all of the
+        // required and none of the excluded components
+        template<typename Function>
+        void forEachChunk(unsigned int required, const Function& function, unsigned int excluded = 0) {
+            for (unsigned int components = 0; components < ArchetypeCount; components++) {
+                if ((components & required) != required || (components & excluded) != 0) {
+                    continue;
+                }
+                for (EntityChunk* chunk : m_Archetypes[components]) {
+                    function(*chunk);
+                }
+            }
+        }
+
+        // forEachChunk with the chunks spread over the JobSystem
+        template<typename Function>
+        void parallelForEachChunk(unsigned int required, const Function& function, unsigned int excluded = 0) {
+            std::vector<EntityChunk*>& chunks = m_QueryChunks;
+            chunks.clear();
+            forEachChunk(required, [&chunks](EntityChunk& chunk) { chunks.push_back(&chunk); }, excluded);
+            JobSystem::ParallelFor(chunks.size(), 1, [&chunks, &function](unsigned int begin, unsigned int end) {
+                for (unsigned int i = begin; i < end; i++) {
+                    function(*chunks[i]);
+                }
+            });
+        }
+
+    private:
+        static const unsigned int ArchetypeCount = COMPONENT_ALL + 1;
+
+        struct EntityRecord {
+            uint32_t generation;
+            uint32_t components;
+            uint32_t chunk;
+            uint32_t row;
+        };
+
+        EntityRecord* findRecord(Entity entity);
+        // Appends a row with default components and returns the chunk index
+        uint32_t addRow(unsigned int components, uint32_t entityIndex, uint32_t& outRow);
+        // Moves the last row of the archetype into the given row
+        void removeRow(unsigned int components, uint32_t chunk, uint32_t row);
+
+    private:
+        std::vector<EntityChunk*> m_Archetypes[ArchetypeCount];
+        std::vector<EntityRecord> m_Records;
+        std::vector<uint32_t> m_FreeRecords;
+        unsigned int m_EntityCount = 0;
+        std::vector<EntityChunk*> m_QueryChunks;
+};
+}
@@ -1,12 +1,46 @@
 #pragma once
 
 #include <string>
+#include <vector>
+
+#include "Mantaray/Core/MappedFile.hpp"
 
 namespace MR{
+// Read only file contents returned by FileSystem::MapFile. Large files are memory mapped, small ones are
+// read into an owned buffer and packed files point into their pack.
+class FileView {
+    friend class FileSystem;
+
+    public:
+        bool isValid();
+        const unsigned char* getData();
+        size_t getSize();
+
+    private:
+        MappedFile m_Mapping;
+        std::vector<unsigned char> m_Buffer;
+        const unsigned char* m_Data = nullptr;
+        size_t m_Size = 0;
+        bool m_Valid = false;
+};
+
 class FileSystem {
     public:
         static std::string GetWorkingDirectory();
+        static bool MapFile(std::string path, FileView& view, bool absolutePath = false);
         static bool ReadFile(std::string path, std::string& content, bool absolutePath = false);
         static bool ReadImage(std::string path, unsigned char*& data, int& width, int& height, int& nrChannels, bool flipVertically = true, bool absolutePath = false);
+        // Creates a single directory level, succeeds if it already exists
+        static bool MakeDirectory(std::string path, bool absolutePath = false);
+
+        // Relative paths are looked up in mounted packs first, the most recently mounted pack wins.
+        // Packs should be mounted before other threads start loading.
+        static bool MountPack(std::string packPath, bool absolutePath = false);
+        static void UnmountPacks();
+        // Zero copy view into a mounted pack, see AssetPack::read
+        static bool ReadPackedFile(std::string path, const unsigned char*& data, size_t& size, std::vector<unsigned char>& storage);
+
+    private:
+        static std::vector<class AssetPack*> MountedPacks;
 };
 }
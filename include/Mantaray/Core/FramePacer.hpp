@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+
+namespace MR {
+// Controls how frames are presented and how the simulation advances between them.
+//
+// The frame limiter is called by Window::endFrame after the buffer swap. It sleeps for most of the
+// remaining frame time and spins for the rest; the sleep stops short by a margin learned from how
+// much the OS oversleeps, which keeps the pacing stable at 60/120/144 Hz. Deadlines advance by a
+// fixed period, so an early frame does not shift later ones, and a frame that misses its deadline
+// by more than a period resynchronizes instead of bursting to catch up.
+//
+// The fixed timestep accumulator is fed by Window::update:
+//     float deltaTime = window->update();
+//     while (FramePacer::StepFixed()) simulate(FramePacer::GetFixedTimestep());
+//     render(FramePacer::GetInterpolationAlpha());
+class FramePacer {
+    public:
+        enum VSyncMode {
+            VSYNC_OFF,
+            VSYNC_ON,
+            // Waits for the vertical blank unless the frame is late, falls back to VSYNC_ON if unsupported
+            VSYNC_ADAPTIVE
+        };
+
+        static void SetVSyncMode(VSyncMode vsyncMode);
+        static VSyncMode GetVSyncMode();
+
+        // 0 renders uncapped
+        static void SetTargetFrameRate(float framesPerSecond);
+        static float GetTargetFrameRate();
+        static void WaitForNextFrame();
+        // Estimated sleep overshoot in seconds, the limiter spins for this long before each deadline
+        static float GetSleepMargin();
+
+        // Accumulated time beyond maxStepsPerFrame steps is dropped so a long stall cannot snowball
+        static void SetFixedTimestep(float step, unsigned int maxStepsPerFrame = 8);
+        static float GetFixedTimestep();
+        // Does nothing until StepFixed was called once, so apps without a fixed step never drop steps
+        static void Accumulate(float deltaTime);
+        // Consumes one step and returns true while a full step is accumulated
+        static bool StepFixed();
+        // Fraction of a step left in the accumulator, for blending the last two simulated states
+        static float GetInterpolationAlpha();
+        static unsigned int GetDroppedStepCount();
+        static void ResetAccumulator();
+
+    private:
+        static VSyncMode CurrentVSyncMode;
+        static float TargetFrameRate;
+        static bool HasDeadline;
+        static std::chrono::steady_clock::time_point NextDeadline;
+        static double SleepMargin;
+
+        static float FixedTimestep;
+        static unsigned int MaxStepsPerFrame;
+        static double Accumulator;
+        static unsigned int DroppedStepCount;
+        static bool FixedStepping;
+};
+}
@@ -1,33 +1,79 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 
 #include "Mantaray/Core/Vector.hpp"
 #include "Mantaray/Core/Color.hpp"
+#include "Mantaray/Core/Shapes.hpp"
+#include "Mantaray/Core/ImageResampler.hpp"
 
 namespace MR {
 class Texture;
 
 class Image {
     friend class Texture;
+    friend class TextureContainer;
 
     public:
+        enum SwizzleConstant {
+            SWIZZLE_ZERO = -1,
+            SWIZZLE_ONE = -2
+        };
+
         Image();
         Image(std::string pathToImage, bool flipVertically = true);
         Image(std::vector<unsigned char>& imageData, unsigned int width, unsigned int height, int nrChannels);
+        Image(Vector2u size, int nrChannels = 4);
+        Image(const Image& other);
+        Image(Image&& other);
         ~Image();
 
-        void loadFromFile(std::string pathToImage, bool flipVertically = true);
+        Image& operator=(const Image& other);
+        Image& operator=(Image&& other);
+
+        void loadFromFile(std::string pathToImage, bool flipVertically = true, bool absolutePath = false);
         void unloadData();
 
         Color getPixel(Vector2u coordinate);
-        
+
         void setPixel(Vector2u coordinate, unsigned char colorValue);
         void setPixel(Vector2u coordinate, Color color);
 
+        unsigned char* getRow(unsigned int y);
+        void forEachRow(std::function<void(unsigned int y, unsigned char* row)> callback);
+        void forEachRow(Rectangleu region, std::function<void(unsigned int y, unsigned char* row)> callback);
+
+        void fillRect(Rectangleu region, Color color);
+        void blit(Image& source, Vector2i destination);
+        void blit(Image& source, Rectangleu sourceRegion, Vector2i destination);
+        void blitAlphaBlended(Image& source, Vector2i destination);
+        void blitAlphaBlended(Image& source, Rectangleu sourceRegion, Vector2i destination);
+
+        void flipVertically();
+        void flipVertically(Image& target);
+
+        void convertChannels(int nrChannels);
+        void convertChannels(int nrChannels, Image& target);
+
+        void premultiplyAlpha();
+        void premultiplyAlpha(Image& target);
+
+        void swizzle(int r, int g, int b, int a);
+        void swizzle(int r, int g, int b, int a, Image& target);
+
+        void resize(Vector2u size, ResampleFilter filter = FILTER_BILINEAR, bool gammaCorrect = false);
+        void resize(Vector2u size, ResampleFilter filter, Image& target, bool gammaCorrect = false);
+        void generateMipChain(std::vector<Image>& mipChain, ResampleFilter filter = FILTER_BOX, bool gammaCorrect = true);
+
         int getWidth();
         int getHeight();
+        int getNrChannels();
+
+    private:
+        void allocate(Vector2u size, int nrChannels);
+        bool clipRegion(Image& source, Rectanglei& sourceRegion, Vector2i& destination);
 
     private:
         unsigned char* m_ImageData = nullptr;
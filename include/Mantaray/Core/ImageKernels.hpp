@@ -0,0 +1,30 @@
+#pragma once
+
+namespace MR {
+// Pixel kernels behind the Image conversion methods.
+// Every kernel has a scalar implementation; SSE2/SSSE3/AVX2 (x86) or NEON (ARM) paths
+// are selected at runtime or compile time where available.
+class ImageKernels {
+    public:
+        // Copies rowCount rows of rowSize bytes in reversed order. source and destination may be the same buffer.
+        static void FlipRows(const unsigned char* source, unsigned char* destination, unsigned int rowSize, unsigned int rowCount);
+
+        // Converts between 1, 2, 3 and 4 channel layouts with the same semantics as Image::getPixel/setPixel:
+        // 1 channel expands to grey, 2 channels are red/green, missing channels are 0 and alpha is opaque.
+        // source and destination must not overlap.
+        static void ConvertChannels(const unsigned char* source, int sourceChannels, unsigned char* destination, int destinationChannels, unsigned int pixelCount);
+
+        // Multiplies the color channels by alpha. Only meaningful for 4 channel data, other layouts are copied.
+        static void PremultiplyAlpha(const unsigned char* source, unsigned char* destination, int nrChannels, unsigned int pixelCount);
+
+        // Reorders channels, destination channel i receives source channel mapping[i].
+        // A mapping entry of -1 writes 0x00, -2 writes 0xFF. source and destination may be the same buffer.
+        static void Swizzle(const unsigned char* source, unsigned char* destination, int nrChannels, const int mapping[4], unsigned int pixelCount);
+
+        // Fills pixelCount pixels with one nrChannels wide pixel value.
+        static void FillPixels(unsigned char* destination, const unsigned char* pixel, int nrChannels, unsigned int pixelCount);
+
+        // Source-over blends 4 channel, non-premultiplied source pixels onto destination pixels with 1 to 4 channels.
+        static void BlendPixels(const unsigned char* source, unsigned char* destination, int destinationChannels, unsigned int pixelCount);
+};
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Mantaray/Core/Vector.hpp"
+
+namespace MR {
+enum ResampleFilter {
+    FILTER_BOX,
+    FILTER_BILINEAR,
+    FILTER_MITCHELL,
+    FILTER_LANCZOS
+};
+
+// Separable two pass resampler working on 8 bit images with 1 to 4 channels.
+// Rows are filtered in float with SSE/NEON and spread over the JobSystem.
+class ImageResampler {
+    public:
+        // gammaCorrect filters sRGB encoded color in linear space.
+        // alphaAware premultiplies 4 channel data before filtering so transparent pixels do not bleed their color.
+        static void Resample(
+            const unsigned char* source, Vector2u sourceSize,
+            unsigned char* destination, Vector2u destinationSize,
+            int nrChannels, ResampleFilter filter,
+            bool gammaCorrect = false, bool alphaAware = true
+        );
+};
+}
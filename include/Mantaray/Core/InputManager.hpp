@@ -1,11 +1,40 @@
 #pragma once
 
-#include <unordered_map>
+#include <cstdint>
 #include <vector>
 
 #include "Mantaray/Core/Vector.hpp"
+#include "Mantaray/Core/KeyCodes.hpp"
 
 namespace MR {
+// A single input change as delivered by GLFW, time is the glfwGetTime value when it arrived
+struct InputEvent {
+    enum Type {
+        EVENT_KEY,
+        EVENT_MOUSE_BUTTON,
+        EVENT_CURSOR,
+        EVENT_SCROLL
+    };
+
+    enum Action {
+        ACTION_RELEASE,
+        ACTION_PRESS,
+        ACTION_REPEAT
+    };
+
+    Type type = EVENT_KEY;
+    // Key or mouse button code, unused for cursor and scroll events
+    int code = 0;
+    Action action = ACTION_RELEASE;
+    int mods = 0;
+    // Cursor position or scroll offset
+    Vector2d value = Vector2d(0, 0);
+    double time = 0.0;
+};
+
+// Collects input through GLFW callbacks into a fixed size queue. Update applies the queued events
+// in arrival order to flat state tables indexed by key code, so a key pressed and released within
+// one frame still reports both GetKeyDown and GetKeyUp for that frame.
 class InputManager{
     public:
         enum CursorMode {
@@ -13,11 +42,14 @@ class InputManager{
             HIDDEN,
             DISABLED
         };
+        static const unsigned int MaxEventsPerFrame = 256;
+
         static void SetWindowHandle(class GLFWwindow* windowHandle);
         static class GLFWwindow* GetWindowHandle();
 
         static void Update(float deltaTime);
 
+        // Every key is tracked, kept so existing code keeps compiling
         static void AddKeyToWatch(int keyCode);
 
         static bool GetKey(int keyCode);
@@ -25,20 +57,61 @@ class InputManager{
         static bool GetKeyUp(int keyCode);
         static void GetMousePosition(Vector2d &mousePos);
         static Vector2d GetMousePosition();
+        // Rereads the cursor from the window so it can be drawn as late in the frame as possible.
+        // Ignored while live input is disabled, replays keep their recorded position.
+        static void LatchMousePosition();
         static void GetMouseDelta(Vector2d &mouseDelta);
         static Vector2d GetMouseDelta();
+        static Vector2d GetScrollDelta();
         static bool GetMouseButton(int mouseButtonCode);
+        static bool GetMouseButtonDown(int mouseButtonCode);
+        static bool GetMouseButtonUp(int mouseButtonCode);
         static void SetCursorMode(CursorMode cursorMode);
-        
+
+        // Events applied by the last Update, in the order they arrived
+        static const std::vector<InputEvent>& GetEvents();
+        // Number of events discarded because more than MaxEventsPerFrame arrived between two updates
+        static unsigned int GetDroppedEventCount();
+
+        // Queues an event as if it came from GLFW, it is applied by the next Update
+        static void InjectEvent(const InputEvent& event);
+        // While disabled the GLFW callbacks are ignored, used to replay recorded input
+        static void SetLiveInputEnabled(bool enabled);
+        static bool IsLiveInputEnabled();
+        // Releases every key and button, drops queued events and moves the cursor
+        static void ResetState(Vector2d mousePosition);
+
+    private:
+        struct ButtonState {
+            bool held;
+            // Update counts at which the last press and release were applied
+            uint32_t pressedFrame;
+            uint32_t releasedFrame;
+        };
+
+        static void QueueEvent(const InputEvent& event);
+        static void QueueLiveEvent(const InputEvent& event);
+        static void ApplyEvent(const InputEvent& event);
+        static ButtonState* FindState(int code);
+
+        static void OnKey(class GLFWwindow* window, int key, int scancode, int action, int mods);
+        static void OnMouseButton(class GLFWwindow* window, int button, int action, int mods);
+        static void OnCursorPosition(class GLFWwindow* window, double x, double y);
+        static void OnScroll(class GLFWwindow* window, double x, double y);
 
     private:
         static class GLFWwindow* WindowHandle;
 
-        static std::vector<int> WatchedKeys;
-        static std::unordered_map<int, float> WatchedKeysElapsedTime;
-        static std::unordered_map<int, bool> WatchedKeysDown;
-        static std::unordered_map<int, bool> WatchedKeysUp;
+        static ButtonState KeyStates[MR_KEY_LAST + 1];
+        static ButtonState MouseButtonStates[MR_MOUSE_BUTTON_LAST + 1];
+        static uint32_t Frame;
+        static std::vector<InputEvent> PendingEvents;
+        static std::vector<InputEvent> FrameEvents;
+        static unsigned int DroppedEventCount;
+        static bool LiveInputEnabled;
+        static Vector2d MousePosition;
         static Vector2d LastMousePosition;
         static Vector2d DeltaMousePosition;
+        static Vector2d ScrollDelta;
 };
 }
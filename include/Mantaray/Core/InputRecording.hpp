@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Mantaray/Core/InputManager.hpp"
+
+namespace MR {
+// Records the InputManager event stream together with the frame deltas returned by Window::update,
+// and plays it back in place of GLFW input and wall time. Window::update drives both modes, so a
+// replayed session sees the same input on the same frames with the same deltas.
+//
+// File layout: a Header, then per frame the float delta and a 2 byte event count followed by the
+// events. An event stores its type, action and mods in one byte each and how long before the frame
+// update it arrived as a float, then a 2 byte code for keys and buttons or two doubles for cursor
+// and scroll events.
+class InputRecording {
+    public:
+        static const uint32_t Version = 1;
+
+        struct Header {
+            char magic[4];
+            uint32_t version;
+            uint32_t seed;
+            uint32_t frameCount;
+            double mouseX;
+            double mouseY;
+        };
+
+        // The seed is stored for the application to reseed its random generators on replay
+        static bool StartRecording(std::string path, uint32_t seed = 0);
+        static void StopRecording();
+        static bool IsRecording();
+
+        // Unthrottled replays disable vsync and are not limited by the recorded deltas.
+        // The window is asked to close after the last frame if closeWhenDone is set.
+        static bool StartReplay(std::string path, bool unthrottled = false, bool closeWhenDone = true);
+        static void StopReplay();
+        static bool IsReplaying();
+        static bool IsUnthrottled();
+        static bool ShouldCloseWhenDone();
+
+        static uint32_t GetSeed();
+        // Sum of the recorded or replayed deltas, the virtual clock of the session
+        static double GetTime();
+        static unsigned int GetFrameIndex();
+        // 0 if the recording was not stopped cleanly, the replay then runs to the end of the data
+        static unsigned int GetFrameCount();
+
+        // Called by Window::update after the events of a frame were applied, updateTime is the
+        // glfwGetTime value the event times are relative to
+        static void RecordFrame(float deltaTime, const std::vector<InputEvent>& events, double updateTime);
+        // Queues the events of the next frame and returns its delta, false once the recording ended
+        static bool ReplayFrame(float& deltaTime);
+
+    private:
+        static void FlushBuffer();
+
+    private:
+        static bool Recording;
+        static bool Replaying;
+        static bool Unthrottled;
+        static bool CloseWhenDone;
+        static std::ofstream File;
+        static std::vector<unsigned char> Buffer;
+        static size_t ReadOffset;
+        static uint32_t Seed;
+        static unsigned int FrameIndex;
+        static unsigned int FrameCount;
+        static double Time;
+        static std::vector<InputEvent> InitialEvents;
+};
+}
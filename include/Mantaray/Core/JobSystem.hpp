@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace MR {
+typedef void (*JobFunction)(void* data, unsigned int begin, unsigned int end);
+
+// A job runs function(data, begin, end). Ranges wider than grain are split in half while executing,
+// the upper half goes back on the deque where idle workers can steal it.
+struct Job {
+    JobFunction function = nullptr;
+    void* data = nullptr;
+    unsigned int begin = 0;
+    unsigned int end = 0;
+    unsigned int grain = 0;
+    class JobCounter* counter = nullptr;
+};
+
+// Counts the unfinished jobs of a batch. Jobs submitted with a counter as their dependency start
+// once it drops to zero.
+class JobCounter {
+    friend class JobSystem;
+
+    public:
+        JobCounter() {}
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        bool isDone() const {
+            return m_Pending.load(std::memory_order_acquire) == 0;
+        }
+
+    private:
+        std::atomic<unsigned int> m_Pending{0};
+        std::mutex m_Mutex;
+        std::vector<Job> m_Continuations;
+};
+
+// Work stealing thread pool. Every pool thread owns a Chase-Lev deque: it pushes and pops its own
+// jobs at the bottom without locks while other threads steal from the top. Threads outside the pool
+// submit to a shared queue. Waiting never blocks a thread that could run jobs, Wait and ParallelFor
+// execute queued jobs until the counter is done, so the thread that initialized the pool takes part.
+//
+//     JobSystem::ParallelFor(rowCount, 16, [&](unsigned int begin, unsigned int end) { ... });
+//
+// Each deque holds DequeCapacity jobs, a push to a full deque runs the job right away instead.
+class JobSystem {
+    public:
+        static const unsigned int DequeCapacity = 4096;
+
+        // workerCount 0 starts one worker per additional hardware thread. Called implicitly with the
+        // default on first use, the calling thread becomes the pool's main thread.
+        static void Initialize(unsigned int workerCount = 0);
+        static void Shutdown();
+        static bool IsInitialized();
+        // Workers plus the main thread
+        static unsigned int GetThreadCount();
+
+        // Adds one to counter unless it is nullptr. Runs once dependency is done if one is given.
+        static void Run(JobFunction function, void* data, unsigned int begin, unsigned int end, unsigned int grain,
+                        JobCounter* counter, JobCounter* dependency = nullptr);
+        // Runs queued jobs on the calling thread until the counter is done. A counter has to be waited
+        // on before it is destroyed, even one already seen done through isDone.
+        static void Wait(JobCounter& counter);
+        // Runs one queued job if there is any
+        static bool TryRunJob();
+
+        // Calls function(begin, end) over [0, count) in ranges of at most grainSize and returns once all are done
+        template<typename Function>
+        static void ParallelFor(unsigned int count, unsigned int grainSize, const Function& function) {
+            if (count == 0) {
+                return;
+            }
+            if (count <= grainSize) {
+                function(0u, count);
+                return;
+            }
+            JobCounter counter;
+            JobSystem::Dispatch(count, grainSize, function, counter);
+            JobSystem::Wait(counter);
+        }
+
+        // ParallelFor without waiting, function has to stay alive until counter is done
+        template<typename Function>
+        static void Dispatch(unsigned int count, unsigned int grainSize, const Function& function, JobCounter& counter, JobCounter* dependency = nullptr) {
+            JobSystem::Run(&JobSystem::InvokeRange<Function>, (void*)&function, 0, count, grainSize, &counter, dependency);
+        }
+
+    private:
+        template<typename Function>
+        static void InvokeRange(void* data, unsigned int begin, unsigned int end) {
+            (*(const Function*)data)(begin, end);
+        }
+
+        static void Push(const Job& job);
+        static bool FindJob(Job& job);
+        static void Execute(Job job);
+        static void Finish(JobCounter* counter);
+        static void WorkerMain(unsigned int index);
+        static void EnsureInitialized();
+        static void Start(unsigned int workerCount);
+};
+}
@@ -123,6 +123,7 @@
 #define MR_KEY_RIGHT_ALT          346
 #define MR_KEY_RIGHT_SUPER        347
 #define MR_KEY_MENU               348
+#define MR_KEY_LAST               MR_KEY_MENU
 
 /* Mouse Buttons */
 #define MR_MOUSE_BUTTON_1         0
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+
+namespace MR {
+// Compressor and decompressor for the LZ4 block format (no frame header or checksums).
+// Output is compatible with LZ4_decompress_safe of the reference implementation.
+class LZ4 {
+    public:
+        static size_t GetCompressBound(size_t sourceSize);
+        // Returns the compressed size, 0 if destinationCapacity is too small
+        static size_t Compress(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t destinationCapacity);
+        // Fails on malformed input or if the output does not exactly fill destinationSize
+        static bool Decompress(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t destinationSize);
+};
+}
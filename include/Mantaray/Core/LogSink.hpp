@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+#include "Mantaray/Core/Logger.hpp"
+
+namespace MR {
+// Destination for formatted log lines. Sinks are only called by one thread at a time,
+// line is the formatted message without a trailing newline.
+class LogSink {
+    public:
+        virtual ~LogSink();
+        virtual void write(Logger::LogLevel logLevel, float time, const char* line, size_t length) = 0;
+        // Called when the queue runs empty and on Logger::Flush
+        virtual void flush();
+};
+
+// Writes to stdout with a color per level, only warnings and errors are flushed right away
+class ConsoleSink : public LogSink {
+    public:
+        void write(Logger::LogLevel logLevel, float time, const char* line, size_t length) override;
+        void flush() override;
+};
+
+// Appends to a file and rotates it once it grows past maxBytes: path becomes path.1,
+// path.1 becomes path.2 and so on, keeping at most maxFiles old files.
+class RotatingFileSink : public LogSink {
+    public:
+        RotatingFileSink(std::string path, size_t maxBytes = 1 << 20, unsigned int maxFiles = 3);
+        ~RotatingFileSink();
+
+        void write(Logger::LogLevel logLevel, float time, const char* line, size_t length) override;
+        void flush() override;
+        bool isOpen();
+
+    private:
+        void rotate();
+
+    private:
+        std::string m_Path;
+        size_t m_MaxBytes;
+        unsigned int m_MaxFiles;
+        FILE* m_File = nullptr;
+        size_t m_Size = 0;
+};
+}
@@ -1,8 +1,26 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 
+// Messages below this severity are compiled out of MR_LOG, 0 keeps debug messages,
+// 1 info, 2 warnings and 3 only errors
+#ifndef MR_LOG_MIN_SEVERITY
+#define MR_LOG_MIN_SEVERITY 0
+#endif
+
+// Only builds the message when the level passes both filters
+#define MR_LOG(name, message, level) \
+    do { \
+        if (MR::Logger::IsEnabled(level)) { \
+            MR::Logger::Log(name, message, level); \
+        } \
+    } while (0)
+
 namespace MR {
+// Messages are copied into a fixed size record and handed to the sinks. In asynchronous mode the
+// records go through a lock free ring buffer and are formatted and written on a background thread,
+// so logging only costs the copy on the calling thread.
 class Logger {
     public:
         enum LogLevel {
@@ -12,11 +30,47 @@ class Logger {
             LOG_DEBUG
         };
 
+        // What a producer does when the ring buffer is full
+        enum OverflowPolicy {
+            // The message is discarded and counted, the count is reported once there is room again
+            OVERFLOW_DROP,
+            // The producer waits for the background thread to make room
+            OVERFLOW_BLOCK
+        };
+
         Logger(std::string name);
-        void Log(std::string message, Logger::LogLevel logLevel = LOG_INFO);
-        static void Log(std::string name, std::string message, Logger::LogLevel logLevel = LOG_INFO);
-        
+        void Log(const std::string& message, Logger::LogLevel logLevel = LOG_INFO);
+        const std::string& getName();
+
+        static void Log(const std::string& name, const std::string& message, Logger::LogLevel logLevel = LOG_INFO);
+
+        static constexpr int Severity(LogLevel logLevel) {
+            return (logLevel == LOG_DEBUG) ? 0 : (int)logLevel + 1;
+        }
+        static inline bool IsEnabled(LogLevel logLevel) {
+            return Severity(logLevel) >= MR_LOG_MIN_SEVERITY && Severity(logLevel) >= MinimumSeverity.load(std::memory_order_relaxed);
+        }
+        // Messages less severe than this are discarded at runtime, debug < info < warning < error
+        static void SetLevel(LogLevel minimumLevel);
+
+        // Starts the background thread, capacity is rounded up to a power of two records
+        static void StartAsync(unsigned int capacity = 1024, OverflowPolicy policy = OVERFLOW_DROP);
+        // Writes everything still queued and returns to writing on the calling thread
+        static void StopAsync();
+        static bool IsAsync();
+        static void SetOverflowPolicy(OverflowPolicy policy);
+        // Blocks until every message logged before the call has reached the sinks
+        static void Flush();
+        static unsigned long long GetDroppedCount();
+
+        // The logger owns added sinks, a console sink is installed until the sinks are changed
+        static void AddSink(class LogSink* sink);
+        static void ClearSinks();
+
+    private:
+        static std::atomic<int> MinimumSeverity;
+
     private:
         std::string m_Name = "";
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace MR {
+// Read only memory mapping of a whole file, unmapped when the object is destroyed.
+class MappedFile {
+    public:
+        MappedFile();
+        MappedFile(std::string path);
+        MappedFile(MappedFile&& other);
+        ~MappedFile();
+
+        MappedFile& operator=(MappedFile&& other);
+
+        bool open(std::string path);
+        void close();
+
+        bool isOpen();
+        const unsigned char* getData();
+        size_t getSize();
+
+    private:
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        void reset();
+
+    private:
+        const unsigned char* m_Data = nullptr;
+        size_t m_Size = 0;
+        // File descriptor or HANDLE, kept platform neutral so the layout does not depend on the platform defines
+        intptr_t m_File = -1;
+        void* m_Mapping = nullptr;
+};
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Mantaray/Core/Vector.hpp"
+#include "Mantaray/OpenGL/Objects/SpriteBatch.hpp"
+
+namespace MR {
+// Reference to a node of a SceneGraph, stale once the node is destroyed
+struct SceneNode {
+    public:
+        bool isNull() const {
+            return generation == 0;
+        }
+
+        bool operator==(SceneNode b) const {
+            return (this->index == b.index && this->generation == b.generation);
+        }
+        bool operator!=(SceneNode b) const {
+            return (this->index != b.index || this->generation != b.generation);
+        }
+
+    public:
+        uint32_t index = 0;
+        uint32_t generation = 0;
+};
+
+// Placement of a node relative to its parent, applied as scale, then rotation, then translation
+struct NodeTransform {
+    Vector2f position = Vector2f(0, 0);
+    Vector2f scale = Vector2f(1, 1);
+    float rotation = 0;
+};
+
+// Node hierarchy with cached world transforms.
+//
+// Node data lives in flat arrays in depth first order, so a parent always comes before its
+// children and every subtree is one contiguous range. Changing a local transform only flags the
+// node, update recomputes the flagged subtrees and skips every range without a flagged node in it.
+// Creating, destroying or reparenting nodes is O(1) and the order is rebuilt once on the next update.
+//
+// Nodes may reference a Sprite or a Polygon, its fields are then relative to the node. draw submits
+// them in traversal order, parents before children and siblings in creation order. Sprites using
+// the default shader that follow each other with the same texture are merged into one instanced draw.
+// Rotated nodes with a non uniform scale are drawn without shearing their children.
+class SceneGraph {
+    public:
+        SceneGraph();
+        SceneGraph(const SceneGraph&) = delete;
+        SceneGraph& operator=(const SceneGraph&) = delete;
+
+        // A null parent attaches the node at the top level
+        SceneNode createNode(SceneNode parent = SceneNode());
+        SceneNode createNode(struct Sprite* sprite, SceneNode parent = SceneNode());
+        SceneNode createNode(struct Polygon* polygon, SceneNode parent = SceneNode());
+        // Destroys the node together with all of its descendants
+        void destroyNode(SceneNode node);
+        bool isAlive(SceneNode node);
+        void clear();
+        unsigned int getNodeCount();
+
+        // The node becomes the last child of parent and keeps its local transform
+        void setParent(SceneNode node, SceneNode parent);
+        SceneNode getParent(SceneNode node);
+
+        // The drawables are not owned by the graph and have to outlive their node
+        void setSprite(SceneNode node, struct Sprite* sprite);
+        void setPolygon(SceneNode node, struct Polygon* polygon);
+        void clearDrawable(SceneNode node);
+
+        // Hidden nodes are skipped together with their descendants
+        void setVisible(SceneNode node, bool visible);
+        bool getVisible(SceneNode node);
+
+        NodeTransform getLocalTransform(SceneNode node);
+        void setLocalTransform(SceneNode node, NodeTransform transform);
+        void setPosition(SceneNode node, Vector2f position);
+        void setRotation(SceneNode node, float rotation);
+        void setScale(SceneNode node, Vector2f scale);
+
+        // Brings the world transforms up to date first
+        Vector2f getWorldPosition(SceneNode node);
+        float getWorldRotation(SceneNode node);
+        Vector2f getWorldScale(SceneNode node);
+        Vector2f transformPoint(SceneNode node, Vector2f localPoint);
+
+        void update();
+        // World transforms recomputed by the last update
+        unsigned int getUpdatedCount();
+        void draw(class RenderTexture& target);
+
+    private:
+        struct WorldTransform {
+            float a = 1, b = 0, c = 0, d = 1;
+            float x = 0, y = 0;
+        };
+
+        enum DrawableType : uint8_t {
+            DRAWABLE_NONE,
+            DRAWABLE_SPRITE,
+            DRAWABLE_POLYGON
+        };
+
+        enum NodeFlags : uint8_t {
+            FLAG_DIRTY = 1 << 0,
+            // Set on every ancestor of a dirty node, update descends into these ranges only
+            FLAG_CHILD_DIRTY = 1 << 1,
+            FLAG_VISIBLE = 1 << 2
+        };
+
+        // Indexed by node index, links the tree while the depth first order is out of date
+        struct NodeRecord {
+            uint32_t generation = 1;
+            bool alive = false;
+            uint32_t position = 0;
+            uint32_t parent = 0;
+            uint32_t firstChild = 0;
+            uint32_t lastChild = 0;
+            uint32_t nextSibling = 0;
+            uint32_t previousSibling = 0;
+        };
+
+        NodeRecord* findRecord(SceneNode node);
+        SceneNode attachNode(SceneNode parent, struct Drawable* drawable, DrawableType type);
+        void link(uint32_t index, uint32_t parent);
+        void unlink(uint32_t index);
+        void markDirty(uint32_t position);
+        void rebuildOrder();
+        WorldTransform& getWorldTransform(SceneNode node);
+        void flushSprites(class RenderTexture& target, class Texture* texture);
+
+    private:
+        // Index 0 is the hidden root, every top level node is its child
+        std::vector<NodeRecord> m_Records;
+        std::vector<uint32_t> m_FreeRecords;
+        unsigned int m_NodeCount = 0;
+        bool m_OrderDirty = false;
+        unsigned int m_UpdatedCount = 0;
+
+        // Depth first order, position 0 is the root
+        std::vector<uint32_t> m_Indices;
+        std::vector<uint32_t> m_ParentPositions;
+        std::vector<uint32_t> m_SubtreeSizes;
+        std::vector<NodeTransform> m_LocalTransforms;
+        std::vector<WorldTransform> m_WorldTransforms;
+        std::vector<uint8_t> m_Flags;
+        std::vector<struct Drawable*> m_Drawables;
+        std::vector<DrawableType> m_DrawableTypes;
+
+        std::vector<uint32_t> m_Stack;
+        std::vector<SpriteInstance> m_Instances;
+};
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Mantaray/Core/Vector.hpp"
+#include "Mantaray/Core/Shapes.hpp"
+
+namespace MR {
+// Frames of a sprite sheet animation as source rectangles in texture coordinates
+struct AnimationClip {
+    public:
+        enum LoopMode {
+            // Stops on the last frame
+            LOOP_NONE,
+            LOOP_REPEAT,
+            // Plays forwards and backwards without repeating the first and last frame
+            LOOP_PING_PONG
+        };
+
+        void addFrame(Rectanglef sourceRectangle, float duration);
+        float getLength();
+
+        // Cells are numbered row by row starting at the top left, as the sheet looks in an image viewer.
+        // Assumes the image was flipped when loaded, which is the default.
+        static Rectanglef GetGridCell(Vector2u sheetSize, Vector2u cellSize, unsigned int index);
+        static AnimationClip FromGrid(
+            Vector2u sheetSize,
+            Vector2u cellSize,
+            unsigned int firstCell,
+            unsigned int frameCount,
+            float frameDuration,
+            LoopMode loopMode = LOOP_REPEAT
+        );
+        // Regions in pixels with the origin at the top left, as atlas packers export them
+        static AnimationClip FromRegions(
+            Vector2u sheetSize,
+            const std::vector<Rectangleu>& regions,
+            float frameDuration,
+            LoopMode loopMode = LOOP_REPEAT
+        );
+
+    public:
+        std::vector<Rectanglef> frames;
+        // Seconds per frame
+        std::vector<float> durations;
+        LoopMode loopMode = LOOP_REPEAT;
+};
+
+// Playback state of one animated sprite, kept in AnimatorPool or as an EntityWorld component.
+// A default state plays clip 0 from its first frame, AnimatorPool::play picks another clip.
+struct AnimationState {
+    enum Flags {
+        ANIMATION_PAUSED = 1 << 0,
+        ANIMATION_FINISHED = 1 << 1,
+        // The frame is written on the next update even if it did not change
+        ANIMATION_RESTARTED = 1 << 2
+    };
+
+    uint32_t clip = 0;
+    // Index into the clip's play order, ping pong clips step back through their frames
+    uint32_t step = 0;
+    // Seconds left until the next frame, 0 on a restarted state takes the duration of the current frame
+    float remaining = 0;
+    float speed = 1;
+    uint32_t flags = ANIMATION_RESTARTED;
+};
+
+// Reference to an animator of an AnimatorPool, stale once the animator is destroyed
+struct Animator {
+    public:
+        bool isNull() const {
+            return generation == 0;
+        }
+
+        bool operator==(Animator b) const {
+            return (this->index == b.index && this->generation == b.generation);
+        }
+        bool operator!=(Animator b) const {
+            return (this->index != b.index || this->generation != b.generation);
+        }
+
+    public:
+        uint32_t index = 0;
+        uint32_t generation = 0;
+};
+
+// Clips and the animators playing them. The frames of all clips are flattened into one table and
+// the animator states are packed densely, update advances all of them in a single pass and only
+// touches a target when its frame changes.
+//
+// Animators write into a Rectanglef they point at, usually a Sprite's sourceRectangle. Entities
+// with COMPONENT_ANIMATION are advanced by update(EntityWorld&) instead, which writes straight into
+// the sprite components the SpriteRenderer streams into its instance data.
+class AnimatorPool {
+    public:
+        AnimatorPool();
+        AnimatorPool(const AnimatorPool&) = delete;
+        AnimatorPool& operator=(const AnimatorPool&) = delete;
+
+        // Returns the clip index used to play it, clips without frames are rejected with ~0u
+        unsigned int addClip(const AnimationClip& clip);
+        unsigned int getClipCount();
+        // Frames of the clip, 0 for an unknown clip
+        unsigned int getFrameCount(unsigned int clip);
+
+        // The target has to stay valid until the animator is destroyed or retargeted
+        Animator createAnimator(unsigned int clip, Rectanglef* target, float speed = 1.f);
+        void destroyAnimator(Animator animator);
+        bool isAlive(Animator animator);
+        unsigned int getAnimatorCount();
+        void setTarget(Animator animator, Rectanglef* target);
+        // nullptr for stale animators, valid until animators are created or destroyed
+        AnimationState* getState(Animator animator);
+
+        // Starts the clip from its first frame, also used to set up animation components
+        void play(Animator animator, unsigned int clip);
+        void play(AnimationState& state, unsigned int clip);
+        void setPaused(Animator animator, bool paused);
+        void setSpeed(Animator animator, float speed);
+        bool isFinished(Animator animator);
+        // Index of the frame shown within the clip
+        unsigned int getFrame(Animator animator);
+        unsigned int getFrame(const AnimationState& state);
+
+        void update(float deltaTime);
+        void update(class EntityWorld& world, float deltaTime);
+
+    private:
+        struct ClipData {
+            uint32_t firstFrame;
+            uint32_t frameCount;
+            uint32_t stepCount;
+            AnimationClip::LoopMode loopMode;
+            // Duration of one pass through the steps
+            float cycleLength;
+        };
+
+        // Advances count states, calls write(i, sourceRectangle) for every state whose frame changed
+        template<typename Write>
+        void advance(AnimationState* states, unsigned int count, float deltaTime, const Write& write);
+
+    private:
+        std::vector<ClipData> m_Clips;
+        std::vector<Rectanglef> m_Frames;
+        std::vector<float> m_Durations;
+
+        // Dense, index i of every array belongs to the same animator
+        std::vector<AnimationState> m_States;
+        std::vector<Rectanglef*> m_Targets;
+        std::vector<uint32_t> m_DenseRecords;
+
+        struct AnimatorRecord {
+            uint32_t generation;
+            // ~0u while the record is free
+            uint32_t dense;
+        };
+        std::vector<AnimatorRecord> m_Records;
+        std::vector<uint32_t> m_FreeRecords;
+};
+}
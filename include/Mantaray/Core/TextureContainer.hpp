@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Mantaray/Core/Vector.hpp"
+#include "Mantaray/Core/MappedFile.hpp"
+#include "Mantaray/Core/BlockCompressor.hpp"
+
+namespace MR {
+class Image;
+
+// Engine native texture file (.mrtex) holding every mip level ready for upload.
+// Layout: header, one level entry per mip level, then the pixel data of each level starting on
+// a 16 byte boundary. Rows are tightly packed and stored bottom up like Image data, block compressed
+// levels hold their 4x4 blocks in the same order.
+// All fields are little endian.
+class TextureContainer {
+    public:
+        enum PixelFormat {
+            PIXEL_FORMAT_UNORM8 = 0,
+            PIXEL_FORMAT_BC1 = 1,
+            PIXEL_FORMAT_BC3 = 2,
+            PIXEL_FORMAT_BC4 = 3
+        };
+
+        struct Header {
+            char magic[4];
+            uint32_t version;
+            uint32_t width;
+            uint32_t height;
+            uint32_t pixelFormat;
+            uint32_t nrChannels;
+            uint32_t levelCount;
+            uint32_t reserved;
+        };
+
+        struct Level {
+            uint64_t offset;
+            uint64_t size;
+            uint32_t width;
+            uint32_t height;
+        };
+
+        static const uint32_t Version = 1;
+
+        // Path of the cooked file belonging to a source image
+        static std::string GetCookedPath(std::string sourcePath);
+        // True if the cooked file exists and is not older than its source
+        static bool IsFresh(std::string sourcePath, std::string cookedPath);
+        // Writes the given mip chain, all levels need the channel count of level 0.
+        // Block compressed formats are encoded here on at most threadCount threads, see BlockCompressor::Compress.
+        static bool Write(std::string path, std::vector<Image>& mipChain, PixelFormat pixelFormat = PIXEL_FORMAT_UNORM8, unsigned int threadCount = 0);
+        static bool IsBlockCompressed(PixelFormat pixelFormat);
+        static BlockFormat GetBlockFormat(PixelFormat pixelFormat);
+
+        TextureContainer();
+        TextureContainer(std::string path);
+
+        // Maps the file and validates the header and level table, the pixel data is not touched
+        bool open(std::string path);
+        // Reads a container held in memory, data has to outlive the container
+        bool open(const unsigned char* data, size_t size, std::string name);
+        void close();
+        bool isOpen();
+
+        Vector2u getSize();
+        int getNrChannels();
+        PixelFormat getPixelFormat();
+        unsigned int getLevelCount();
+        Vector2u getLevelSize(unsigned int level);
+        size_t getLevelByteSize(unsigned int level);
+        // Points straight into the mapping, valid until the container is closed
+        const unsigned char* getLevelData(unsigned int level);
+
+    private:
+        bool validate(const unsigned char* data, size_t size, std::string path);
+
+    private:
+        MappedFile m_File;
+        const unsigned char* m_Data = nullptr;
+        const Header* m_Header = nullptr;
+        const Level* m_Levels = nullptr;
+};
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Mantaray/Core/Image.hpp"
+#include "Mantaray/Core/TextureContainer.hpp"
+
+namespace MR {
+// CPU side of loading a texture file: a cooked container from a mounted pack or from disk,
+// or the decoded source image. Loading touches no GL state, so it can run on any thread and be
+// handed to Texture::setFromSource on the GL thread afterwards.
+class TextureSource {
+    friend class Texture;
+
+    public:
+        TextureSource();
+        TextureSource(std::string pathToTexture);
+
+        bool load(std::string pathToTexture);
+        bool isLoaded();
+        std::string getPath();
+
+    private:
+        TextureSource(const TextureSource&) = delete;
+        TextureSource& operator=(const TextureSource&) = delete;
+
+        bool decodeImage();
+
+    private:
+        std::string m_Path = "";
+        std::vector<unsigned char> m_PackStorage;
+        TextureContainer m_Container;
+        Image m_Image;
+};
+}
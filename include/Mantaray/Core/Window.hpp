@@ -1,5 +1,6 @@
 #pragma once
 
+#include <deque>
 #include <string>
 
 #include "Mantaray/Core/Vector.hpp"
@@ -8,9 +9,13 @@
 #include "Mantaray/Core/Timer.hpp"
 #include "Mantaray/Core/Logger.hpp"
 #include "Mantaray/OpenGL/Drawables.hpp"
+#include "Mantaray/OpenGL/FrameStatistics.hpp"
+#include "Mantaray/OpenGL/FramePacket.hpp"
 
 namespace MR {
 class Window {
+    friend class RenderThread;
+
     public:
         Window();
         ~Window();
@@ -44,6 +49,10 @@ class Window {
         void draw(Sprite& sprite);
         void draw(Polygon& polygon);
         void draw(class Canvas*& canvas);
+        // Draws the sprites of every entity through the SpriteRenderer
+        void draw(class EntityWorld& world);
+        // Updates the graph and draws its nodes in traversal order
+        void draw(class SceneGraph& sceneGraph);
 
         void drawLine(Vector2f p1, Vector2f p2, float thickness = 1.f, Color color = Color(0xFF));
 
@@ -69,11 +78,35 @@ class Window {
 
         Rectanglei getViewportRect();
 
+        FrameStats getFrameStats();
+        FrameStats getAverageFrameStats();
+        FrameStats getFrameStatsPercentile(float percentile);
+        void setFrameStatsHistorySize(unsigned int frameCount);
+
+        // Waits after each swap until at most maxFramesInFlight frames are queued on the GPU, so the
+        // driver cannot buffer frames ahead and input is polled closer to presentation. The mouse
+        // position is also reread right before the composite.
+        void setLowLatencyMode(bool enabled, unsigned int maxFramesInFlight = 1);
+        bool getLowLatencyMode();
+
+        // Drawn on top of everything at the mouse position latched during display, nullptr hides it
+        void setCursorSprite(Sprite* cursorSprite);
+
+        // Moves GL work to a RenderThread, draws are recorded and rendered while the next frame is
+        // simulated. packetCount 2 double buffers the frames, 3 triple buffers them. See RenderThread
+        // for the rules on GL work outside of draw calls.
+        void setThreadedRendering(bool enabled, unsigned int packetCount = 2);
+        bool getThreadedRendering();
+
     protected:
         static void OnWindowResized(class GLFWwindow* window, int width, int height);
         void initialize(std::string title, Vector2u size, Vector2u resolution, Vector2f coordinateScale, bool shouldKeepAspectRatio = true);
         void calculateViewDestination(int windowWidth, int windowHeight);
-        void display();
+        PresentInfo preparePresent();
+        void presentFrame(const PresentInfo& present);
+        void finishFrame(const PresentInfo& present);
+        void display(const PresentInfo& present);
+        void limitFramesInFlight(double inputTime);
     
     private:
         Logger m_Logger = Logger("Window");
@@ -83,10 +116,23 @@ class Window {
         class Shader* m_DisplayShader;
         Color m_ClearColor = Color(0x00);
         Timer m_Timer;
+        Timer m_FrameTimer;
         bool m_ShouldKeepAspectRatio;
+        // Vsync and the frame limiter are off while an unthrottled input replay runs
+        bool m_Unthrottled = false;
+        int m_SwapIntervalBeforeReplay = 1;
         float m_PrefferedAspectRatio;
         Vector2i m_lastWindowedPosition = Vector2i();
         Vector2i m_lastWindowedSize = Vector2i();
         Rectanglei m_ViewportRect;
+        struct InFlightFrame {
+            struct __GLsync* fence;
+            double inputTime;
+        };
+        std::deque<InFlightFrame> m_FramesInFlight;
+        double m_InputTime = 0.0;
+        bool m_LowLatency = false;
+        unsigned int m_MaxFramesInFlight = 1;
+        Sprite* m_CursorSprite = nullptr;
 };
 }
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Mantaray/OpenGL/Objects/Texture.hpp"
+
+namespace MR {
+// Loads a list of named assets into the ObjectLibrary. Files are read and decoded concurrently as
+// JobSystem jobs while the calling thread, which needs the GL context, creates the objects as soon
+// as their data is ready. Shaders are issued first with deferred status checks so their compilation
+// overlaps the texture work.
+//
+// Manifest format, one asset per line, '#' starts a comment:
+//     shader <name> <vertex shader path> <fragment shader path> [fallback shader name]
+//     texture <name> <image path> [nearest|linear] [clamp|repeat|mirrored] [mipmaps] [mask]
+//     vertexarray <name> <mesh path>
+// Mesh files are text with one entry per line: "v x y" for a vertex, "t u v" for a texture
+// coordinate and "i a b c ..." for indices.
+class AssetLoader {
+    public:
+        enum AssetType {
+            ASSET_SHADER,
+            ASSET_TEXTURE,
+            ASSET_VERTEX_ARRAY
+        };
+
+        struct AssetTiming {
+            std::string name;
+            AssetType type;
+            // Seconds spent reading and decoding on a worker
+            float loadTime = 0.f;
+            // Seconds spent creating the GL object on the calling thread
+            float createTime = 0.f;
+            bool succeeded = false;
+        };
+
+        AssetLoader();
+        ~AssetLoader();
+
+        bool loadManifest(std::string manifestPath, bool absolutePath = false);
+        void addShader(std::string name, std::string vertexShaderPath, std::string fragmentShaderPath, std::string fallbackName = "");
+        void addTexture(std::string name, std::string imagePath, const TextureDescriptor& descriptor = TextureDescriptor());
+        void addVertexArray(std::string name, std::string meshPath);
+        void clear();
+
+        // Loads everything added so far on the JobSystem, returns false if any asset failed to load.
+        bool load();
+
+        const std::vector<AssetTiming>& getTimings();
+        float getTotalTime();
+
+    private:
+        struct Asset;
+
+        void readAsset(Asset& asset);
+        void createAsset(Asset& asset);
+        bool isPendingFallback(Asset& asset);
+
+    private:
+        std::vector<Asset*> m_Assets;
+        std::vector<AssetTiming> m_Timings;
+        float m_TotalTime = 0.f;
+};
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 
 #include "Mantaray/Core/Vector.hpp"
@@ -21,9 +22,24 @@ class Context {
         static void BindFramebuffer(unsigned int frameBufferID);
         static void BindVertexArray(unsigned int vertexArrayID);
         static void UseProgram(unsigned int shaderProgramID);
+
+        // 0 presents immediately, 1 waits for every vertical blank, -1 is adaptive vsync.
+        // Without a current context, as on the game thread while rendering is threaded, the
+        // interval is applied by ApplyPendingSwapInterval before the next swap.
+        static void SetSwapInterval(int interval);
+        static void ApplyPendingSwapInterval();
+        // The interval as set, even while a context without adaptive vsync falls back to 1
+        static int GetSwapInterval();
+        // True if the driver accepts a negative interval, tearing instead of waiting when a frame is late
+        static bool SupportsAdaptiveSwap();
     
+    private:
+        static void ApplySwapInterval();
+
     private:
         static bool IsInitialized;
         static GLState State; 
+        static std::atomic<int> SwapInterval;
+        static std::atomic<bool> SwapIntervalPending;
 };
 }
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Mantaray/Core/Vector.hpp"
+#include "Mantaray/Core/Color.hpp"
+#include "Mantaray/Core/Shapes.hpp"
+#include "Mantaray/OpenGL/Objects/SpriteBatch.hpp"
+
+namespace MR {
+// Camera of a render target at the moment a draw was issued
+struct RenderView {
+    Vector2f coordinateScale = Vector2f(1, 1);
+    Vector2f offset = Vector2f(0, 0);
+    float scale = 1.f;
+    Vector2f scaleCenter = Vector2f(.5f, .5f);
+};
+
+// One draw call as plain data, executed right away or recorded into a FramePacket for the render thread
+struct DrawCommand {
+    enum Type {
+        COMMAND_CLEAR,
+        COMMAND_TEXTURE,
+        COMMAND_VERTEX_ARRAY,
+        COMMAND_CANVAS,
+        COMMAND_SPRITE_INSTANCES,
+        COMMAND_UNIFORM
+    };
+
+    Type type = COMMAND_CLEAR;
+    class RenderTexture* target = nullptr;
+    class Texture* texture = nullptr;
+    class VertexArray* vertexArray = nullptr;
+    class Shader* shader = nullptr;
+    class Canvas* canvas = nullptr;
+    Vector2f position = Vector2f(0, 0);
+    Vector2f size = Vector2f(1, 1);
+    bool absoluteSize = true;
+    float rotation = 0.f;
+    Vector2f rotationCenter = Vector2f(0, 0);
+    Rectanglef sourceRectangle = Rectanglef(0, 0, 1, 1);
+    Color color = Color(0xFFu);
+    RenderView view;
+    // Index into FramePacket::uniforms for COMMAND_UNIFORM
+    unsigned int uniform = 0;
+    // COMMAND_SPRITE_INSTANCES draws instanceCount instances from instances, or from
+    // FramePacket::instances starting at instanceOffset once the command has been recorded
+    const SpriteInstance* instances = nullptr;
+    unsigned int instanceOffset = 0;
+    unsigned int instanceCount = 0;
+};
+
+// A Shader setter called on the game thread while rendering is threaded
+struct UniformCommand {
+    enum Type {
+        UNIFORM_INTEGER,
+        UNIFORM_FLOAT,
+        UNIFORM_VECTOR2F,
+        UNIFORM_VECTOR3F,
+        UNIFORM_VECTOR4F,
+        UNIFORM_MATRIX4,
+        UNIFORM_TEXTURE,
+        UNIFORM_RENDER_TEXTURE
+    };
+
+    Type type = UNIFORM_INTEGER;
+    std::string name;
+    int integer = 0;
+    float values[16];
+    class Texture* texture = nullptr;
+    class RenderTexture* renderTexture = nullptr;
+};
+
+// Everything Window needs to composite and present a frame, captured on the game thread
+struct PresentInfo {
+    Vector2i windowSize = Vector2i(0, 0);
+    Rectanglei viewportRect;
+    class Shader* displayShader = nullptr;
+    double inputTime = 0.0;
+    float frameTime = 0.f;
+};
+
+struct FramePacket {
+    public:
+        void clear() {
+            commands.clear();
+            instances.clear();
+            uniformCount = 0;
+            culledObjects = 0;
+        }
+
+        // Names keep their storage between frames, only the count is reset
+        UniformCommand& addUniform(const std::string& name, UniformCommand::Type type) {
+            if (uniformCount == uniforms.size()) {
+                uniforms.push_back(UniformCommand());
+            }
+            UniformCommand& uniform = uniforms[uniformCount++];
+            uniform.name.assign(name);
+            uniform.type = type;
+            return uniform;
+        }
+
+    public:
+        std::vector<DrawCommand> commands;
+        std::vector<UniformCommand> uniforms;
+        std::vector<SpriteInstance> instances;
+        unsigned int uniformCount = 0;
+        // Objects skipped while recording, added to the statistics of the frame the packet renders
+        unsigned int culledObjects = 0;
+        PresentInfo present;
+};
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+namespace MR {
+struct FrameStats {
+    public:
+        unsigned int drawCalls = 0;
+        unsigned int verticesSubmitted = 0;
+        unsigned int indicesSubmitted = 0;
+        unsigned int shaderSwitches = 0;
+        unsigned int textureBinds = 0;
+        unsigned int framebufferSwitches = 0;
+        unsigned int vertexArrayBinds = 0;
+        unsigned int uniformUploads = 0;
+        unsigned long long bufferBytesUploaded = 0;
+        unsigned int culledObjects = 0;
+        float frameTime = 0.f;
+        // Seconds from polling input to the GPU finishing the composite of a frame, set in the frame
+        // whose swap observed the completion and 0 when none completed
+        float inputLatency = 0.f;
+};
+
+class FrameStatistics {
+    public:
+        static void EndFrame(float frameTime);
+        // Held by Window around EndFrame and its stats getters, frames end on the render thread while it runs
+        static std::mutex& GetMutex();
+
+        static void SetHistorySize(unsigned int frameCount);
+        static unsigned int GetHistorySize();
+        static unsigned int GetRecordedFrameCount();
+
+        static FrameStats& GetCurrent();
+        static FrameStats GetLastFrame();
+        static FrameStats GetAverage();
+        static FrameStats GetPercentile(float percentile);
+
+        // Frame times since the last reset in buckets of bucketWidth seconds, the last bucket also
+        // counts every longer frame. Unlike the history it covers the whole session.
+        static void SetHistogramBuckets(float bucketWidth, unsigned int bucketCount);
+        static float GetHistogramBucketWidth();
+        static const std::vector<unsigned long long>& GetFrameTimeHistogram();
+        // Upper edge of the bucket holding the given fraction of all counted frames
+        static float GetHistogramPercentile(float percentile);
+        static void ResetHistogram();
+
+        static inline void AddDrawCall(unsigned int vertices, unsigned int indices) {
+            Current.drawCalls++;
+            Current.verticesSubmitted += vertices;
+            Current.indicesSubmitted += indices;
+        }
+        static inline void AddShaderSwitch() { Current.shaderSwitches++; }
+        static inline void AddTextureBind() { Current.textureBinds++; }
+        static inline void AddFramebufferSwitch() { Current.framebufferSwitches++; }
+        static inline void AddVertexArrayBind() { Current.vertexArrayBinds++; }
+        static inline void AddUniformUpload() { Current.uniformUploads++; }
+        static inline void AddBufferUpload(unsigned long long bytes) { Current.bufferBytesUploaded += bytes; }
+        static inline void AddCulledObjects(unsigned int count) { Current.culledObjects += count; }
+
+    private:
+        static FrameStats Current;
+        static std::mutex Mutex;
+        static std::vector<FrameStats> History;
+        static unsigned int HistorySize;
+        static unsigned int HistoryHead;
+        static unsigned int HistoryCount;
+        static std::vector<unsigned long long> Histogram;
+        static float HistogramBucketWidth;
+        static unsigned long long HistogramTotal;
+};
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+namespace MR {
+// Typed reference to an ObjectLibrary entry, resolved with ObjectLibrary::Get.
+// The slot generation changes whenever an entry is deleted, so a handle kept past
+// its object resolves to nullptr instead of to whatever reuses the slot.
+// Only ObjectLibrary::GetHandle makes handles, after checking the entry's type, so
+// a handle cannot be pointed at a slot holding a different type.
+template <class T>
+class Handle {
+    friend class ObjectLibrary;
+
+    public:
+        Handle() {}
+
+        bool isNull() const {
+            return generation == 0;
+        }
+
+        bool operator==(Handle<T> b) const {
+            return (this->index == b.index && this->generation == b.generation);
+        }
+        bool operator!=(Handle<T> b) const {
+            return (this->index != b.index || this->generation != b.generation);
+        }
+
+    private:
+        Handle(uint32_t index, uint32_t generation) {
+            this->index = index;
+            this->generation = generation;
+        }
+
+    private:
+        uint32_t index = 0;
+        // Live slots never have generation 0, a default constructed handle is null
+        uint32_t generation = 0;
+};
+}
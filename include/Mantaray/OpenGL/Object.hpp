@@ -1,28 +1,52 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
 namespace MR {
 class Object {
     friend class ObjectChain;
 
     public:
+        enum ObjectType {
+            OBJECT_GENERIC,
+            OBJECT_SHADER,
+            OBJECT_TEXTURE,
+            OBJECT_RENDER_TEXTURE,
+            // Color attachment of a RenderTexture, counted apart so each render target is one
+            // OBJECT_RENDER_TEXTURE, the memory of render targets is reported under this type
+            OBJECT_RENDER_ATTACHMENT,
+            OBJECT_VERTEX_ARRAY,
+            OBJECT_SPRITE_BATCH,
+            OBJECT_TYPE_COUNT
+        };
+
         Object();
         virtual ~Object();
 
         virtual void bind();
         virtual void unbind();
+
+        virtual ObjectType getObjectType();
+        // GPU memory held directly by this object, as reported by the last upload
+        size_t getByteEstimate();
     
     protected:
         virtual void allocate();
         virtual void release();
         void link();
         void unlink();
+        // Keeps the per type totals in the ObjectChain in step, call after every allocation change
+        void setByteSize(size_t byteSize);
 
     private:
-        void destroy();
+        // The game thread has no current context while the render thread runs
+        void warnWithoutContext();
 
     private: 
         bool m_HasAllocatedData = false;
-        Object* m_Previous = nullptr;
-        Object* m_Next = nullptr;
+        // Slot in the ObjectChain, only valid while the object holds allocated data
+        uint32_t m_ChainIndex = 0;
+        size_t m_ByteSize = 0;
 };
 }
@@ -1,17 +1,51 @@
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
+#include "Mantaray/OpenGL/Object.hpp"
+
 namespace MR {
+// Tracks every object holding GL data so it can be released before the context goes away.
+// Entries live in a pool with a free list and are threaded into a creation ordered list by index,
+// linking and unlinking are O(1) and TearDown walks the list iteratively from the newest object.
 class ObjectChain {
     public:
         static void Initialize();
         static void TearDown();
         static void Link(class Object* link);
         static void UnLink(class Object* link);
+        // Updates the totals when a linked object changes its size, used by Object::setByteSize
+        static void TrackBytes(class Object* object, size_t byteSize);
+
+        static unsigned int GetLiveCount();
+        static unsigned int GetLiveCount(Object::ObjectType type);
+        // Running totals of Object::getByteEstimate over the live objects, kept up to date on every upload
+        static unsigned long long GetByteEstimate(Object::ObjectType type);
+        static unsigned long long GetByteEstimate();
+
+        // Link and unlink only build their debug messages while this is enabled
+        static void SetLoggingEnabled(bool enabled);
+
+    private:
+        struct Entry {
+            class Object* object;
+            uint32_t previous;
+            uint32_t next;
+            Object::ObjectType type;
+        };
+
+        static void LogObject(const char* action, class Object* object);
 
     private:
         static bool Initialized;
-        static class Object* ChainHead;
-        static class Object* ChainTail;
+        static bool LoggingEnabled;
+        static std::vector<Entry> Entries;
+        static std::vector<uint32_t> FreeEntries;
+        static uint32_t ChainHead;
+        static uint32_t ChainTail;
+        static unsigned int LiveCounts[Object::OBJECT_TYPE_COUNT];
+        static unsigned long long ByteTotals[Object::OBJECT_TYPE_COUNT];
         static class Logger Logger;
 };
 }
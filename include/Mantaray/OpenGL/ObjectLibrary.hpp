@@ -1,25 +1,54 @@
 #pragma once
 
+#include <cstdint>
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 #include "Mantaray/Core/Vector.hpp"
+#include "Mantaray/OpenGL/Handle.hpp"
+#include "Mantaray/OpenGL/Objects/Texture.hpp"
 
 namespace MR {
 class ObjectLibrary {
     public:
-        static class Shader* CreateShader(std::string name, std::string vertexShaderPath, std::string fragmentShaderPath);
-        static class Shader* CreateShader(std::string name, const char* vertexShaderSource, const char* fragmentShaderSource);
-        static class Texture* CreateTexture(std::string name, std::string imagePath);
-        static class Texture* CreateTexture(std::string name, class Image &image);
-        static class Texture* CreateTexture(std::string name, Vector2u resolution, int nrChannels = 4);
+        static class Shader* CreateShader(std::string name, std::string vertexShaderPath, std::string fragmentShaderPath, class Shader* fallback = nullptr);
+        static class Shader* CreateShader(std::string name, const char* vertexShaderSource, const char* fragmentShaderSource, class Shader* fallback = nullptr);
+        static class Texture* CreateTexture(std::string name, std::string imagePath, const TextureDescriptor& descriptor = TextureDescriptor());
+        static class Texture* CreateTexture(std::string name, class Image &image, const TextureDescriptor& descriptor = TextureDescriptor());
+        static class Texture* CreateTexture(std::string name, class TextureSource &source, const TextureDescriptor& descriptor = TextureDescriptor());
+        static class Texture* CreateTexture(std::string name, Vector2u resolution, int nrChannels = 4, const TextureDescriptor& descriptor = TextureDescriptor());
         static class RenderTexture* CreateRenderTexture(std::string name, Vector2u resolution);
         static class RenderTexture* CreateRenderTexture(std::string name, Vector2u resolution, Vector2f coordinateScale);
         static class VertexArray* CreateVertexArray(std::string name);
         
         template<typename T>
         static bool FindObject(std::string name, T*& outObject);
+        template<typename T>
+        static bool FindObject(uint32_t nameID, T*& outObject);
+        static bool HasObject(std::string name);
         static bool DeleteObject(std::string name);
+        template<typename T>
+        static bool DeleteObject(Handle<T> handle);
+
+        // Names are hashed once here, the ID can then be used for lookups without touching the string
+        static uint32_t InternName(std::string name);
+        static std::string GetName(uint32_t nameID);
+
+        // The type is checked once when the handle is made, a null handle is returned on a miss
+        template<typename T>
+        static Handle<T> GetHandle(std::string name);
+        template<typename T>
+        static Handle<T> GetHandle(uint32_t nameID);
+
+        // Resolves a handle with a bounds check and a generation compare, nullptr for stale handles
+        template<typename T>
+        static inline T* Get(Handle<T> handle) {
+            if (handle.index >= Slots.size() || Slots[handle.index].generation != handle.generation) {
+                return nullptr;
+            }
+            return static_cast<T*>(Slots[handle.index].object);
+        }
 
         static void InitializeDefaultEntries();
 
@@ -27,9 +56,29 @@ class ObjectLibrary {
         static class VertexArray* DefaultVertexArray;
         static class Shader* DefaultTexturedShader;
         static class Shader* DefaultColoredShader;
+        // Instanced quads for bulk sprite submission and the shader reading their per instance data
+        static class SpriteBatch* DefaultSpriteBatch;
+        static class Shader* DefaultSpriteShader;
+
+    private:
+        struct Slot {
+            class Object* object;
+            uint32_t generation;
+            uint32_t nameID;
+        };
+
+        static class Object* FindEntry(uint32_t nameID, uint32_t& slotIndex);
+        static void AddEntry(std::string name, class Object* object);
+        static void RemoveEntry(uint32_t slotIndex);
+        static uint32_t LookupName(const std::string& name);
 
     private:
-        static std::unordered_map<std::string, class Object*> Library;
+        static std::vector<Slot> Slots;
+        static std::vector<uint32_t> FreeSlots;
+        static std::unordered_map<std::string, uint32_t> NameIDs;
+        static std::vector<std::string> Names;
+        // Slot index + 1 for every name ID, 0 while the name has no entry
+        static std::vector<uint32_t> NameSlots;
         static class Logger Logger;
 };
 }
@@ -3,6 +3,7 @@
 #include <glm/fwd.hpp>
 
 #include "Mantaray/OpenGL/Object.hpp"
+#include "Mantaray/OpenGL/FramePacket.hpp"
 #include "Mantaray/OpenGL/Objects/Texture.hpp"
 #include "Mantaray/Core/Vector.hpp"
 #include "Mantaray/Core/Color.hpp"
@@ -13,6 +14,7 @@ class RenderTexture : public Object {
     friend class Shader;
     friend class Canvas;
     friend class Window;
+    friend class RenderThread;
     
     public:
         RenderTexture(Vector2u resolution);
@@ -21,6 +23,7 @@ class RenderTexture : public Object {
 
         void bind() override;
         void unbind() override;
+        ObjectType getObjectType() override;
 
         int getWidth();
         int getHeight();
@@ -38,6 +41,9 @@ class RenderTexture : public Object {
         Vector2f getScaleCenter();
         void setScaleCenter(Vector2f scaleCenter);
 
+        // The area in coordinate space the current view covers
+        Rectanglef getVisibleArea();
+
         void clear(Color color = Color(0x00u));
 
         void draw(struct Sprite& sprite);
@@ -66,6 +72,9 @@ class RenderTexture : public Object {
             Rectanglef sourceRectangle = Rectanglef(0, 0, 1, 1)
         );
         void draw(class Canvas* canvas);
+        // Draws every instance with one instanced draw call, see SpriteBatch for the instance layout.
+        // The instances are copied when the draw is recorded for the render thread.
+        void draw(const SpriteInstance* instances, unsigned int count, class Texture* texture, class Shader* shader = nullptr);
 
         void drawLine(Vector2f p1, Vector2f p2, float thickness = 1.f, Color color = Color(0xFF));
     
@@ -75,8 +84,20 @@ class RenderTexture : public Object {
         void release() override;
 
     protected:
+        // Draws become commands that run right away, or on the render thread while rendering is threaded
+        void submit(DrawCommand& command);
+        void execute(const DrawCommand& command);
+        void clearNow(Color color);
+        void drawTexture(const DrawCommand& command);
+        void drawVertexArray(const DrawCommand& command);
+        void drawCanvas(const DrawCommand& command);
+        void drawSpriteInstances(const DrawCommand& command);
+
+        RenderView getView();
         glm::mat4 createProjectionMatrix(bool scaled = true, bool shifted = true);
+        static glm::mat4 CreateProjectionMatrix(RenderView view, bool scaled = true, bool shifted = true);
         glm::mat4 createModelMatrix(Vector2f position, Vector2f size, float rotation, Vector2f rotationCenter);
+        class Shader* resolveShader(class Shader* shader);
     
     protected:
         unsigned int m_FBO, m_RBO;
@@ -91,5 +112,7 @@ class RenderTexture : public Object {
         static class VertexArray* DefaultVertexArray;
         static class Shader* DefaultTexturedShader;
         static class Shader* DefaultColoredShader;
+        static class SpriteBatch* DefaultSpriteBatch;
+        static class Shader* DefaultSpriteShader;
 };
 }
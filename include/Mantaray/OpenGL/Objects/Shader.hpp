@@ -22,6 +22,7 @@ class Shader : public Object {
 
         void bind() override;
         void unbind() override;
+        ObjectType getObjectType() override;
         void setupForDraw();
 
         void setUniformInteger(std::string uniformName, int value);
@@ -32,6 +33,20 @@ class Shader : public Object {
         void setUniformMatrix4(std::string uniformName, glm::mat4 value);
         void setTexture(std::string textureUniformName, int slot, class Texture &texture);
         void setRenderTexture(std::string textureUniformName, int slot, class RenderTexture &texture);
+
+        // Polls a program that is still being built without blocking, true once it linked successfully
+        bool isReady();
+        bool hasFailed();
+        // Blocks until the driver is done with the program, binding or setting uniforms does this implicitly
+        bool waitUntilReady();
+        // Used for drawing while this shader is not ready, draws pick their default shader when none is set
+        void setFallback(Shader* fallback);
+        Shader* getFallback();
+
+        // Shaders created while enabled return right after issuing their compile and link,
+        // status checks are deferred to first use so the driver can build them in parallel
+        static void SetAsyncCompilation(bool enabled);
+        static bool IsAsyncCompilation();
         
         static unsigned int CompileShader(Shader::ShaderType shaderType, const char* source);
         static unsigned int LinkShader(unsigned int vertexShader, unsigned int fragmentShader);
@@ -41,13 +56,31 @@ class Shader : public Object {
         void release() override;
 
     private:
-        void compileShader(Shader::ShaderType shaderType, const char* source);
+        enum BuildState {
+            BUILD_PENDING,
+            BUILD_READY,
+            BUILD_FAILED
+        };
+
+        void buildProgram(const char* vertexSource, int vertexLength, const char* fragmentSource, int fragmentLength);
+        void compileShader(Shader::ShaderType shaderType, const char* source, int length = -1);
         void linkShader();
+        void finishBuild();
+        bool checkCompileStatus(Shader::ShaderType shaderType);
+        bool checkLinkStatus();
         int getUniformLocation(std::string uniformName);
 
+        static bool HasParallelCompile();
+
     private:
         unsigned int m_FragmentShaderID, m_VertexShaderID, m_ShaderProgramID;
+        BuildState m_BuildState = BUILD_READY;
+        Shader* m_Fallback = nullptr;
+        // Kept for the program cache until the deferred status checks have run
+        std::string m_VertexSource, m_FragmentSource;
         std::unordered_map<std::string, int> m_Uniforms = std::unordered_map<std::string, int>();
         std::unordered_map<int, unsigned int> m_TextureSlots = std::unordered_map<int, unsigned int>();
+
+        static bool AsyncCompilation;
 };
 }
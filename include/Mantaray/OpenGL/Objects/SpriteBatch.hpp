@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Mantaray/Core/Color.hpp"
+#include "Mantaray/OpenGL/Object.hpp"
+
+namespace MR {
+// Per instance vertex data of an instanced sprite draw. Matches the layout the sprite shader
+// reads, a custom shader has to declare the same attributes:
+//     layout (location = 0) in vec2 vertexPosition;   unit quad corner, also the texture coordinate
+//     layout (location = 1) in vec4 instanceTransform; position.xy, size.xy
+//     layout (location = 2) in vec3 instanceRotation;  rotation, rotationCenter.xy
+//     layout (location = 3) in vec4 instanceSource;    source rectangle x, y, width, height
+//     layout (location = 4) in vec4 instanceColor;
+struct SpriteInstance {
+    float position[2];
+    float size[2];
+    float rotation;
+    // Relative to size like Drawable::rotationCenter
+    float rotationCenter[2];
+    float sourceRectangle[4];
+    Color color;
+};
+
+// A unit quad drawn once per SpriteInstance with a single instanced draw call. The instance buffer
+// is orphaned on every draw, so the driver never has to wait for the previous draw to finish reading it.
+class SpriteBatch : public Object {
+    public:
+        SpriteBatch();
+        ~SpriteBatch();
+
+        void draw(const SpriteInstance* instances, unsigned int count);
+
+        void bind() override;
+        void unbind() override;
+        ObjectType getObjectType() override;
+
+    protected:
+        void allocate() override;
+        void release() override;
+
+    private:
+        unsigned int m_VAO, m_QuadVBO, m_EBO, m_InstanceVBO;
+        // Instances the buffer can hold, grown in powers of two
+        unsigned int m_Capacity = 0;
+};
+}
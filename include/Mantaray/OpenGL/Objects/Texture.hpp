@@ -1,39 +1,133 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "Mantaray/Core/Vector.hpp"
+#include "Mantaray/Core/Shapes.hpp"
+#include "Mantaray/Core/BlockCompressor.hpp"
 #include "Mantaray/OpenGL/Object.hpp"
 
 namespace MR {
+// Storage format and sampler state of a texture.
+// FORMAT_AUTO picks the 8 bit format matching the uploaded channel count.
+struct TextureDescriptor {
+    enum Format {
+        FORMAT_AUTO,
+        FORMAT_R8,
+        FORMAT_RG8,
+        FORMAT_RGB8,
+        FORMAT_RGBA8,
+        FORMAT_RGB565,
+        FORMAT_RGBA4
+    };
+
+    enum Swizzle {
+        SWIZZLE_NONE,
+        // Single channel data sampled as (1, 1, 1, r), used for fonts and masks
+        SWIZZLE_WHITE_ALPHA,
+        // Single channel data sampled as (r, r, r, 1)
+        SWIZZLE_GREY
+    };
+
+    enum Filter {
+        FILTER_NEAREST,
+        FILTER_LINEAR
+    };
+
+    enum Wrap {
+        WRAP_CLAMP,
+        WRAP_REPEAT,
+        WRAP_MIRRORED_REPEAT
+    };
+
+    TextureDescriptor(Format format = FORMAT_AUTO, Filter filter = FILTER_NEAREST, Wrap wrap = WRAP_CLAMP);
+
+    static TextureDescriptor Mask();
+
+    Format format;
+    Swizzle swizzle = SWIZZLE_NONE;
+    Filter minFilter;
+    Filter magFilter;
+    // Filter between mip levels, only used when the texture has more than one level
+    Filter mipFilter = FILTER_LINEAR;
+    Wrap wrapS;
+    Wrap wrapT;
+    // Number of mip levels, 0 means a full chain down to 1x1
+    unsigned int mipLevels = 1;
+    // Fills levels above 0 with glGenerateMipmap after every upload, a mipLevels of 0 or 1 generates
+    // the full chain
+    bool generateMipmaps = false;
+};
+
 class Texture : public Object {
     friend class RenderTexture;
+    friend class TextureResidency;
 
     public:
         Texture();
-        Texture(std::string pathToTexture);
-        Texture(class Image &image);
-        Texture(Vector2u resolution, int channels = 4);
+        Texture(std::string pathToTexture, const TextureDescriptor& descriptor = TextureDescriptor());
+        Texture(class Image &image, const TextureDescriptor& descriptor = TextureDescriptor());
+        Texture(class TextureSource &source, const TextureDescriptor& descriptor = TextureDescriptor());
+        Texture(Vector2u resolution, int channels = 4, const TextureDescriptor& descriptor = TextureDescriptor());
         ~Texture();
 
+        // Sampler state is applied immediately, a format change takes effect on the next upload
+        void setDescriptor(const TextureDescriptor& descriptor);
+        const TextureDescriptor& getDescriptor();
+
+        // Uses the cooked .mrtex file next to the source when it is present and up to date
+        void loadFromFile(std::string pathToTexture);
+        bool setFromContainer(class TextureContainer &container);
+        // Uploads a source loaded on any thread, decodes the source image if the cooked data cannot be used
+        bool setFromSource(class TextureSource &source);
         void setFromImage(class Image &image);
+        // Encodes the image on the CPU, falls back to an uncompressed upload if the format is not supported by the driver
+        void setFromImage(class Image &image, BlockFormat format);
+        bool setCompressed(const unsigned char* blockData, Vector2u size, BlockFormat format);
+        void setFromMipChain(std::vector<class Image> &mipChain);
+        void updateRegion(class Image &image, Rectangleu region);
+        void updateRegion(class Image &image, Rectangleu sourceRegion, Vector2u destination);
 
         int getWidth();
         int getHeight();
         unsigned int getTextureID();
+        // False while the TextureResidency has evicted the storage, the next draw reloads it
+        bool isResident();
 
         void bind() override;
         void unbind() override;
+        ObjectType getObjectType() override;
 
     protected:
         void allocate() override;
         void release() override;
 
     private:
-        void uploadTextureData(unsigned char* textureData, int width, int height, int nrChannels);
+        // Color attachments of render targets are accounted as OBJECT_RENDER_ATTACHMENT and never evicted
+        Texture(Vector2u resolution, ObjectType objectType);
+
+        bool uploadSource(class TextureSource &source);
+        bool uploadContainer(class TextureContainer &container);
+        // Frees the storage of every level but keeps the texture name, so bound slots stay valid
+        void evict();
+        void reload();
+        // Called when the contents stop matching the source file, which makes the texture unevictable
+        void forgetSource();
+        void uploadTextureData(const unsigned char* textureData, int width, int height, int nrChannels);
+        bool uploadLevel(const unsigned char* textureData, int width, int height, int nrChannels, int level);
+        bool uploadCompressedLevel(const unsigned char* blockData, int width, int height, BlockFormat format, int level);
+        void applySamplerState();
+        void trackLevelBytes(size_t byteSize, int level);
 
     private:
         unsigned int m_TextureID = 0;
         Vector2u m_Size = Vector2u(0, 0);
+        TextureDescriptor m_Descriptor;
+        unsigned int m_LevelCount = 1;
+        ObjectType m_ObjectType = OBJECT_TEXTURE;
+        // File the contents were loaded from, empty if they cannot be reloaded
+        std::string m_SourcePath = "";
+        bool m_Evicted = false;
 };
 }
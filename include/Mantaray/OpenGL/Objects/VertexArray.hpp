@@ -23,6 +23,7 @@ class VertexArray : public Object {
 
         void bind() override;
         void unbind() override;
+        ObjectType getObjectType() override;
 
     protected:
         void allocate() override;
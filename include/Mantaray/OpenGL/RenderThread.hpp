@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Mantaray/OpenGL/FramePacket.hpp"
+
+namespace MR {
+// Optional dedicated GL thread, enabled with Window::setThreadedRendering.
+//
+// While it runs the render thread owns the GL context. Draw calls and Shader setters made on the game
+// thread are recorded into a FramePacket instead of reaching GL, Window::endFrame hands the packet over
+// and the game thread goes on to simulate the next frame while the previous one renders. With
+// packetCount 2 the game thread runs at most one frame ahead, 3 allows a second frame to be queued.
+//
+// Anything else that touches GL from the game thread has to hold the context through
+// AcquireContext/ReleaseContext. ObjectLibrary, AssetLoader::load and the Texture upload functions
+// take it themselves, other GL work, such as constructing objects directly or reading pixels, has to
+// be wrapped by the caller. Acquiring waits for every submitted packet to be rendered, so no queued
+// draw can reference a deleted object, and draws made while the context is held run immediately.
+// Both are no-ops when the thread is not running and nest on the same thread.
+class RenderThread {
+    public:
+        // Holds the context for the enclosing scope
+        class ScopedContext {
+            public:
+                ScopedContext() { RenderThread::AcquireContext(); }
+                ~ScopedContext() { RenderThread::ReleaseContext(); }
+                ScopedContext(const ScopedContext&) = delete;
+                ScopedContext& operator=(const ScopedContext&) = delete;
+        };
+
+        static void Start(class GLFWwindow* window, unsigned int packetCount = 2);
+        static void Stop();
+        static bool IsRunning() { return Running; }
+        // True if GL work issued on the calling thread has to be recorded
+        static bool IsRecording() { return Running && ContextDepth == 0; }
+
+        static FramePacket& GetRecordingPacket();
+        static UniformCommand& RecordUniform(class Shader* shader, const std::string& name, UniformCommand::Type type);
+        // Blocks while every packet is queued or rendering
+        static void Submit(const PresentInfo& present);
+        // Waits until every submitted packet has been rendered
+        static void Synchronize();
+
+        static void AcquireContext();
+        static void ReleaseContext();
+
+    private:
+        static void Run();
+        static void Execute(FramePacket& packet);
+
+    private:
+        static class GLFWwindow* WindowHandle;
+        static std::thread Thread;
+        static std::mutex Mutex;
+        static std::condition_variable Condition;
+        static std::vector<FramePacket> Packets;
+        static unsigned long long SubmittedCount;
+        static unsigned long long RenderedCount;
+        static bool Running;
+        static bool StopRequested;
+        static bool ContextRequested;
+        static bool ContextReleased;
+        static thread_local unsigned int ContextDepth;
+};
+}
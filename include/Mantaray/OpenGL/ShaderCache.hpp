@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+
+namespace MR {
+// On disk cache of linked program binaries (ARB_get_program_binary).
+// Entries are keyed by the shader sources and the driver vendor, renderer and version strings,
+// so driver updates and source edits simply miss. Binaries the driver rejects count as misses
+// and are replaced after the program was rebuilt from source.
+class ShaderCache {
+    public:
+        // Cache files go to <working directory>/ShaderCache/ unless another directory is set
+        static void SetDirectory(std::string directory, bool absolutePath = false);
+        static std::string GetDirectory();
+        static void SetEnabled(bool enabled);
+        // False if disabled or the driver offers no binary formats
+        static bool IsAvailable();
+
+        // Loads a cached binary into program, returns false on a miss
+        static bool Load(unsigned int program, const char* vertexSource, int vertexLength, const char* fragmentSource, int fragmentLength);
+        // Stores the binary of a successfully linked program
+        static void Store(unsigned int program, const char* vertexSource, int vertexLength, const char* fragmentSource, int fragmentLength);
+
+        static unsigned int GetHitCount();
+        static unsigned int GetMissCount();
+        static unsigned int GetRejectedCount();
+        static void ResetCounters();
+
+    private:
+        static unsigned long long ComputeKey(const char* vertexSource, int vertexLength, const char* fragmentSource, int fragmentLength);
+        static std::string GetEntryPath(unsigned long long key);
+
+    private:
+        static std::string Directory;
+        static bool Enabled;
+        static int Availability;
+        static unsigned int HitCount;
+        static unsigned int MissCount;
+        static unsigned int RejectedCount;
+};
+}
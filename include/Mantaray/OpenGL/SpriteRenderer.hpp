@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include "Mantaray/OpenGL/Objects/SpriteBatch.hpp"
+
+namespace MR {
+// Render system of an EntityWorld. Draws every entity with a transform and a sprite by streaming
+// through the archetype chunks, entities outside the visible area are culled and the rest are
+// grouped into one instanced draw per layer, shader and texture.
+//
+// Layers draw in ascending order, entities without a layer component are on layer 0. Within a
+// layer groups draw in the order their first entity was found, so overlapping sprites with
+// different textures on the same layer have no defined order.
+class SpriteRenderer {
+    public:
+        static void Render(class EntityWorld& world, class RenderTexture& target);
+
+        // Culling tests a bounding box of each sprite against RenderTexture::getVisibleArea.
+        // The culled count shows up in FrameStats::culledObjects.
+        static void SetCulling(bool enabled);
+        static bool GetCulling();
+
+    private:
+        struct Batch {
+            int layer;
+            class Texture* texture;
+            class Shader* shader;
+            unsigned int order;
+            std::vector<SpriteInstance> instances;
+        };
+
+        static unsigned int FindBatch(int layer, class Texture* texture, class Shader* shader);
+
+    private:
+        static bool Culling;
+        // Kept between frames so the instance arrays do not have to grow again
+        static std::vector<Batch> Batches;
+        static unsigned int BatchCount;
+        static std::vector<unsigned int> DrawOrder;
+};
+}
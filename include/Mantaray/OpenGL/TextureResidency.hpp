@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace MR {
+// Keeps the memory of file backed textures under a budget. Textures loaded from a file or cooked
+// container are tracked by GL name; at the end of a frame the least recently drawn ones are evicted
+// until the OBJECT_TEXTURE total of the ObjectChain fits the budget, and an evicted texture is
+// reloaded from its source the next time a shader draws with it. Textures drawn in the current
+// frame, render targets and textures whose contents did not come from a file are never evicted.
+class TextureResidency {
+    friend class Texture;
+
+    public:
+        // Disabling reloads every evicted texture
+        static void SetEnabled(bool enabled);
+        static inline bool IsEnabled() { return Enabled; }
+        // Texture bytes allowed before evicting, 0 means no limit
+        static void SetBudget(unsigned long long bytes);
+        static unsigned long long GetBudget();
+        static unsigned long long GetResidentBytes();
+
+        // Marks the texture as drawn this frame and reloads it if it was evicted
+        static inline void Touch(unsigned int textureID) {
+            if (Enabled) {
+                MarkUsed(textureID);
+            }
+        }
+        // Evicts down to the budget and starts a new frame, called by Window::endFrame
+        static void EndFrame();
+
+        static unsigned int GetTrackedCount();
+        static unsigned int GetEvictedCount();
+        static unsigned int GetEvictionCount();
+        static unsigned int GetReloadCount();
+        static void ResetCounters();
+
+    private:
+        struct Entry {
+            class Texture* texture;
+            uint64_t lastUsedFrame;
+        };
+
+        static void Register(class Texture* texture);
+        static void Unregister(class Texture* texture);
+        static void MarkUsed(unsigned int textureID);
+
+    private:
+        static bool Enabled;
+        static unsigned long long Budget;
+        static uint64_t CurrentFrame;
+        // Indexed by GL texture name, which drivers hand out densely from 1
+        static std::vector<Entry> Entries;
+        static unsigned int TrackedCount;
+        static unsigned int EvictionCount;
+        static unsigned int ReloadCount;
+};
+}
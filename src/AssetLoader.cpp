@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+
+#include "Mantaray/OpenGL/AssetLoader.hpp"
+#include "Mantaray/OpenGL/ObjectLibrary.hpp"
+#include "Mantaray/OpenGL/RenderThread.hpp"
+#include "Mantaray/OpenGL/Objects/Shader.hpp"
+#include "Mantaray/OpenGL/Objects/Texture.hpp"
+#include "Mantaray/OpenGL/Objects/VertexArray.hpp"
+#include "Mantaray/Core/FileSystem.hpp"
+#include "Mantaray/Core/JobSystem.hpp"
+#include "Mantaray/Core/TextureSource.hpp"
+#include "Mantaray/Core/Timer.hpp"
+#include "Mantaray/Core/Logger.hpp"
+
+using namespace MR;
+
+struct AssetLoader::Asset {
+    AssetType type;
+    std::string name;
+    std::string paths[2];
+    std::string fallbackName;
+    TextureDescriptor descriptor;
+
+    // Filled by a worker, released once the object has been created
+    std::string vertexSource;
+    std::string fragmentSource;
+    TextureSource* texture = nullptr;
+    std::vector<Vector2f> vertices;
+    std::vector<Vector2f> textureCoordinates;
+    std::vector<int> indices;
+
+    bool read = false;
+    bool created = false;
+    AssetTiming timing;
+};
+
+static std::string formatMilliseconds(float seconds) {
+    std::ostringstream stream;
+    stream.precision(2);
+    stream << std::fixed << seconds * 1000.f << " ms";
+    return stream.str();
+}
+
+static bool readMesh(std::string path, std::vector<Vector2f>& vertices, std::vector<Vector2f>& textureCoordinates, std::vector<int>& indices) {
+    std::string content;
+    if (!FileSystem::ReadFile(path, content)) {
+        return false;
+    }
+    std::istringstream lines(content);
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        std::istringstream tokens(line);
+        std::string kind;
+        if (!(tokens >> kind)) {
+            continue;
+        }
+        Vector2f value;
+        int index;
+        if (kind == "v" && tokens >> value.x >> value.y) {
+            vertices.push_back(value);
+        }
+        else if (kind == "t" && tokens >> value.x >> value.y) {
+            textureCoordinates.push_back(value);
+        }
+        else if (kind == "i" && tokens >> index) {
+            do {
+                indices.push_back(index);
+            } while (tokens >> index);
+        }
+        else if (kind[0] != '#') {
+            Logger::Log("AssetLoader", "Invalid mesh entry in " + path + " line " + std::to_string(lineNumber), Logger::LOG_ERROR);
+            return false;
+        }
+    }
+    if (vertices.empty()) {
+        Logger::Log("AssetLoader", "Mesh has no vertices: " + path, Logger::LOG_ERROR);
+        return false;
+    }
+    return true;
+}
+
+AssetLoader::AssetLoader() {
+}
+
+AssetLoader::~AssetLoader() {
+    clear();
+}
+
+bool AssetLoader::loadManifest(std::string manifestPath, bool absolutePath) {
+    std::string content;
+    if (!FileSystem::ReadFile(manifestPath, content, absolutePath)) {
+        return false;
+    }
+
+    bool valid = true;
+    std::istringstream lines(content);
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        std::istringstream tokens(line);
+        std::vector<std::string> words;
+        std::string word;
+        while (tokens >> word) {
+            words.push_back(word);
+        }
+        if (words.empty()) {
+            continue;
+        }
+
+        bool validLine = true;
+        if (words[0] == "shader" && (words.size() == 4 || words.size() == 5)) {
+            addShader(words[1], words[2], words[3], words.size() == 5 ? words[4] : "");
+        }
+        else if (words[0] == "texture" && words.size() >= 3) {
+            bool mask = std::find(words.begin() + 3, words.end(), "mask") != words.end();
+            TextureDescriptor descriptor = mask ? TextureDescriptor::Mask() : TextureDescriptor();
+            for (unsigned int i = 3; i < words.size(); i++) {
+                if (words[i] == "nearest" || words[i] == "linear") {
+                    descriptor.minFilter = (words[i] == "linear") ? TextureDescriptor::FILTER_LINEAR : TextureDescriptor::FILTER_NEAREST;
+                    descriptor.magFilter = descriptor.minFilter;
+                }
+                else if (words[i] == "clamp" || words[i] == "repeat" || words[i] == "mirrored") {
+                    descriptor.wrapS = TextureDescriptor::WRAP_CLAMP;
+                    if (words[i] == "repeat") descriptor.wrapS = TextureDescriptor::WRAP_REPEAT;
+                    if (words[i] == "mirrored") descriptor.wrapS = TextureDescriptor::WRAP_MIRRORED_REPEAT;
+                    descriptor.wrapT = descriptor.wrapS;
+                }
+                else if (words[i] == "mipmaps") {
+                    descriptor.mipLevels = 0;
+                    descriptor.generateMipmaps = true;
+                }
+                else if (words[i] != "mask") {
+                    validLine = false;
+                }
+            }
+            if (validLine) {
+                addTexture(words[1], words[2], descriptor);
+            }
+        }
+        else if (words[0] == "vertexarray" && words.size() == 3) {
+            addVertexArray(words[1], words[2]);
+        }
+        else {
+            validLine = false;
+        }
+
+        if (!validLine) {
+            Logger::Log("AssetLoader", "Invalid manifest entry in " + manifestPath + " line " + std::to_string(lineNumber), Logger::LOG_ERROR);
+            valid = false;
+        }
+    }
+    return valid;
+}
+
+void AssetLoader::addShader(std::string name, std::string vertexShaderPath, std::string fragmentShaderPath, std::string fallbackName) {
+    Asset* asset = new Asset();
+    asset->type = ASSET_SHADER;
+    asset->name = name;
+    asset->paths[0] = vertexShaderPath;
+    asset->paths[1] = fragmentShaderPath;
+    asset->fallbackName = fallbackName;
+    m_Assets.push_back(asset);
+}
+
+void AssetLoader::addTexture(std::string name, std::string imagePath, const TextureDescriptor& descriptor) {
+    Asset* asset = new Asset();
+    asset->type = ASSET_TEXTURE;
+    asset->name = name;
+    asset->paths[0] = imagePath;
+    asset->descriptor = descriptor;
+    m_Assets.push_back(asset);
+}
+
+void AssetLoader::addVertexArray(std::string name, std::string meshPath) {
+    Asset* asset = new Asset();
+    asset->type = ASSET_VERTEX_ARRAY;
+    asset->name = name;
+    asset->paths[0] = meshPath;
+    m_Assets.push_back(asset);
+}
+
+void AssetLoader::clear() {
+    for (Asset* asset : m_Assets) {
+        delete asset->texture;
+        delete asset;
+    }
+    m_Assets.clear();
+}
+
+bool AssetLoader::load() {
+    Timer totalTimer;
+    totalTimer.start();
+    m_Timings.clear();
+
+    // Shaders are read first so their compiles are in flight while the textures are decoded and uploaded
+    std::vector<Asset*> order;
+    for (Asset* asset : m_Assets) {
+        if (!asset->created) {
+            order.push_back(asset);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [](const Asset* a, const Asset* b) {
+        return a->type == ASSET_SHADER && b->type != ASSET_SHADER;
+    });
+
+    std::mutex readMutex;
+    std::condition_variable readCondition;
+    std::vector<Asset*> readAssets;
+    JobCounter readCounter;
+    auto readJob = [&](unsigned int begin, unsigned int end) {
+        for (unsigned int index = begin; index < end; index++) {
+            readAsset(*order[index]);
+            std::lock_guard<std::mutex> lock(readMutex);
+            readAssets.push_back(order[index]);
+            readCondition.notify_one();
+        }
+    };
+    JobSystem::Dispatch(order.size(), 1, readJob, readCounter);
+
+    // GL objects are created on this thread in the order their data arrives, shaders wait for their fallback
+    RenderThread::AcquireContext();
+    bool asyncCompilation = Shader::IsAsyncCompilation();
+    Shader::SetAsyncCompilation(true);
+    std::vector<Asset*> waiting;
+    size_t receivedCount = 0;
+    size_t createdCount = 0;
+    while (createdCount < order.size()) {
+        if (receivedCount < order.size()) {
+            std::unique_lock<std::mutex> lock(readMutex);
+            while (readAssets.empty()) {
+                // Reads are run here too instead of idling, without workers nothing else would run them
+                lock.unlock();
+                bool ranJob = JobSystem::TryRunJob();
+                lock.lock();
+                if (!ranJob && readAssets.empty()) {
+                    readCondition.wait_for(lock, std::chrono::milliseconds(1));
+                }
+            }
+            waiting.insert(waiting.end(), readAssets.begin(), readAssets.end());
+            receivedCount += readAssets.size();
+            readAssets.clear();
+        }
+
+        bool progress = true;
+        while (progress) {
+            progress = false;
+            for (size_t i = 0; i < waiting.size(); i++) {
+                if (isPendingFallback(*waiting[i])) {
+                    continue;
+                }
+                createAsset(*waiting[i]);
+                createdCount++;
+                waiting.erase(waiting.begin() + i);
+                i--;
+                progress = true;
+            }
+        }
+
+        if (receivedCount == order.size() && !waiting.empty()) {
+            Logger::Log("AssetLoader", "Shader fallbacks form a cycle, creating " + waiting[0]->name + " without one", Logger::LOG_WARNING);
+            waiting[0]->fallbackName = "";
+        }
+    }
+    Shader::SetAsyncCompilation(asyncCompilation);
+    RenderThread::ReleaseContext();
+
+    JobSystem::Wait(readCounter);
+
+    bool succeeded = true;
+    const AssetTiming* slowest = nullptr;
+    for (Asset* asset : order) {
+        m_Timings.push_back(asset->timing);
+        succeeded = succeeded && asset->timing.succeeded;
+        if (slowest == nullptr || asset->timing.loadTime + asset->timing.createTime > slowest->loadTime + slowest->createTime) {
+            slowest = &asset->timing;
+        }
+    }
+    m_TotalTime = totalTimer.getElapsedTime();
+    if (slowest != nullptr) {
+        Logger::Log(
+            "AssetLoader",
+            "Loaded " + std::to_string(order.size()) + " assets on " + std::to_string(JobSystem::GetThreadCount()) + " threads in " + formatMilliseconds(m_TotalTime) +
+            ", slowest was " + slowest->name + " with " + formatMilliseconds(slowest->loadTime + slowest->createTime),
+            Logger::LOG_INFO
+        );
+    }
+    return succeeded;
+}
+
+const std::vector<AssetLoader::AssetTiming>& AssetLoader::getTimings() {
+    return m_Timings;
+}
+
+float AssetLoader::getTotalTime() {
+    return m_TotalTime;
+}
+
+void AssetLoader::readAsset(Asset& asset) {
+    Timer timer;
+    timer.start();
+    switch (asset.type) {
+        case ASSET_SHADER:
+            asset.read = FileSystem::ReadFile(asset.paths[0], asset.vertexSource) && FileSystem::ReadFile(asset.paths[1], asset.fragmentSource);
+            break;
+        case ASSET_TEXTURE:
+            asset.texture = new TextureSource();
+            asset.read = asset.texture->load(asset.paths[0]);
+            break;
+        case ASSET_VERTEX_ARRAY:
+            asset.read = readMesh(asset.paths[0], asset.vertices, asset.textureCoordinates, asset.indices);
+            break;
+    }
+    asset.timing.name = asset.name;
+    asset.timing.type = asset.type;
+    asset.timing.loadTime = timer.getElapsedTime();
+}
+
+void AssetLoader::createAsset(Asset& asset) {
+    Timer timer;
+    timer.start();
+    if (asset.read) {
+        switch (asset.type) {
+            case ASSET_SHADER: {
+                Shader* fallback = nullptr;
+                if (!asset.fallbackName.empty()) {
+                    ObjectLibrary::FindObject(asset.fallbackName, fallback);
+                }
+                ObjectLibrary::CreateShader(asset.name, asset.vertexSource.c_str(), asset.fragmentSource.c_str(), fallback);
+                break;
+            }
+            case ASSET_TEXTURE:
+                ObjectLibrary::CreateTexture(asset.name, *asset.texture, asset.descriptor);
+                break;
+            case ASSET_VERTEX_ARRAY: {
+                VertexArray* vertexArray = ObjectLibrary::CreateVertexArray(asset.name);
+                vertexArray->addVertices(asset.vertices);
+                if (!asset.textureCoordinates.empty()) {
+                    vertexArray->addTextureCoordinates(asset.textureCoordinates);
+                }
+                if (!asset.indices.empty()) {
+                    vertexArray->addIndices(asset.indices);
+                }
+                vertexArray->uploadVertexArrayData();
+                break;
+            }
+        }
+    }
+    else {
+        Logger::Log("AssetLoader", "Could not load " + asset.name, Logger::LOG_ERROR);
+    }
+
+    std::string().swap(asset.vertexSource);
+    std::string().swap(asset.fragmentSource);
+    delete asset.texture;
+    asset.texture = nullptr;
+    std::vector<Vector2f>().swap(asset.vertices);
+    std::vector<Vector2f>().swap(asset.textureCoordinates);
+    std::vector<int>().swap(asset.indices);
+
+    asset.created = true;
+    asset.timing.createTime = timer.getElapsedTime();
+    asset.timing.succeeded = asset.read;
+    Logger::Log(
+        "AssetLoader",
+        asset.name + " read in " + formatMilliseconds(asset.timing.loadTime) + ", created in " + formatMilliseconds(asset.timing.createTime),
+        Logger::LOG_DEBUG
+    );
+}
+
+bool AssetLoader::isPendingFallback(Asset& asset) {
+    if (asset.type != ASSET_SHADER || asset.fallbackName.empty()) {
+        return false;
+    }
+    for (Asset* other : m_Assets) {
+        if (other != &asset && other->type == ASSET_SHADER && other->name == asset.fallbackName && !other->created) {
+            return true;
+        }
+    }
+    return false;
+}
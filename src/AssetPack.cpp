@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "Mantaray/Core/AssetPack.hpp"
+#include "Mantaray/Core/LZ4.hpp"
+#include "Mantaray/Core/Logger.hpp"
+
+using namespace MR;
+
+static const char PackMagic[4] = {'M', 'R', 'P', 'K'};
+static const uint64_t DataAlignment = 16;
+
+static uint64_t alignOffset(uint64_t offset) {
+    return (offset + DataAlignment - 1) & ~(DataAlignment - 1);
+}
+
+static bool entryLess(const AssetPack::Entry& entry, uint64_t hash, const char* names, const std::string& name) {
+    if (entry.hash != hash) {
+        return entry.hash < hash;
+    }
+    return std::string(names + entry.nameOffset, entry.nameLength) < name;
+}
+
+std::string AssetPack::NormalizeName(std::string name) {
+    std::replace(name.begin(), name.end(), '\\', '/');
+    while (name.compare(0, 2, "./") == 0) {
+        name.erase(0, 2);
+    }
+    return name;
+}
+
+uint64_t AssetPack::HashName(const std::string& normalizedName) {
+    // 64 bit FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : normalizedName) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool AssetPack::Write(std::string packPath, std::vector<Source>& sources, bool compress) {
+    std::ofstream pack(packPath.c_str(), std::ios::binary | std::ios::trunc);
+    if (!pack) {
+        Logger::Log("AssetPack", "Could not open file for writing: " + packPath, Logger::LOG_ERROR);
+        return false;
+    }
+
+    Header header;
+    memcpy(header.magic, PackMagic, sizeof(PackMagic));
+    header.version = Version;
+    header.entryCount = 0;
+    header.reserved = 0;
+    header.indexOffset = 0;
+    header.namesOffset = 0;
+    pack.write((const char*)&header, sizeof(Header));
+
+    std::vector<Entry> entries;
+    std::vector<std::string> names;
+    entries.reserve(sources.size());
+    names.reserve(sources.size());
+    uint64_t offset = sizeof(Header);
+    const char padding[DataAlignment] = {0};
+    std::vector<unsigned char> compressed;
+
+    for (Source& source : sources) {
+        std::ifstream file(source.filePath.c_str(), std::ios::binary);
+        if (!file) {
+            Logger::Log("AssetPack", "Could not open file: " + source.filePath, Logger::LOG_ERROR);
+            return false;
+        }
+        std::vector<unsigned char> content = std::vector<unsigned char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        Entry entry;
+        std::string name = NormalizeName(source.name);
+        entry.hash = HashName(name);
+        entry.size = content.size();
+        entry.storedSize = content.size();
+        entry.compression = COMPRESSION_NONE;
+        entry.reserved = 0;
+        const unsigned char* data = content.empty() ? nullptr : &content[0];
+
+        if (compress && !content.empty()) {
+            compressed.resize(LZ4::GetCompressBound(content.size()));
+            size_t compressedSize = LZ4::Compress(&content[0], content.size(), &compressed[0], compressed.size());
+            if (compressedSize != 0 && compressedSize <= content.size() - content.size() / 8) {
+                entry.storedSize = compressedSize;
+                entry.compression = COMPRESSION_LZ4;
+                data = &compressed[0];
+            }
+        }
+
+        uint64_t aligned = alignOffset(offset);
+        pack.write(padding, aligned - offset);
+        entry.offset = aligned;
+        if (data != nullptr) {
+            pack.write((const char*)data, entry.storedSize);
+        }
+        offset = aligned + entry.storedSize;
+
+        entries.push_back(entry);
+        names.push_back(name);
+    }
+
+    // Sort by hash so the reader can binary search, names break ties between colliding hashes
+    std::vector<unsigned int> order = std::vector<unsigned int>(entries.size());
+    for (unsigned int i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+        if (entries[a].hash != entries[b].hash) {
+            return entries[a].hash < entries[b].hash;
+        }
+        return names[a] < names[b];
+    });
+
+    std::vector<Entry> index;
+    std::string nameTable;
+    index.reserve(entries.size());
+    for (unsigned int i : order) {
+        if (!index.empty() && index.back().hash == entries[i].hash && names[i] == std::string(&nameTable[index.back().nameOffset], index.back().nameLength)) {
+            Logger::Log("AssetPack", "Duplicate entry " + names[i] + " in " + packPath, Logger::LOG_ERROR);
+            return false;
+        }
+        Entry entry = entries[i];
+        entry.nameOffset = nameTable.size();
+        entry.nameLength = names[i].size();
+        nameTable += names[i];
+        index.push_back(entry);
+    }
+
+    header.entryCount = index.size();
+    header.indexOffset = alignOffset(offset);
+    header.namesOffset = header.indexOffset + sizeof(Entry) * index.size();
+    pack.write(padding, header.indexOffset - offset);
+    if (!index.empty()) {
+        pack.write((const char*)&index[0], sizeof(Entry) * index.size());
+    }
+    pack.write(nameTable.data(), nameTable.size());
+    pack.seekp(0);
+    pack.write((const char*)&header, sizeof(Header));
+    if (!pack) {
+        Logger::Log("AssetPack", "Could not write file: " + packPath, Logger::LOG_ERROR);
+        return false;
+    }
+    return true;
+}
+
+AssetPack::AssetPack() {
+}
+
+AssetPack::AssetPack(std::string path) {
+    open(path);
+}
+
+bool AssetPack::open(std::string path) {
+    close();
+    if (!m_File.open(path)) {
+        return false;
+    }
+
+    const unsigned char* data = m_File.getData();
+    size_t size = m_File.getSize();
+    const Header* header = (const Header*)data;
+    if (size < sizeof(Header) || memcmp(header->magic, PackMagic, sizeof(PackMagic)) != 0 || header->version != Version) {
+        Logger::Log("AssetPack", "Not a supported asset pack: " + path, Logger::LOG_ERROR);
+        close();
+        return false;
+    }
+    uint64_t indexSize = (uint64_t)sizeof(Entry) * header->entryCount;
+    if (header->indexOffset > size || indexSize > size - header->indexOffset || header->namesOffset != header->indexOffset + indexSize) {
+        Logger::Log("AssetPack", "Corrupted asset pack index: " + path, Logger::LOG_ERROR);
+        close();
+        return false;
+    }
+
+    const Entry* entries = (const Entry*)(data + header->indexOffset);
+    uint64_t namesSize = size - header->namesOffset;
+    for (unsigned int i = 0; i < header->entryCount; i++) {
+        const Entry& entry = entries[i];
+        bool validData = entry.offset <= header->indexOffset && entry.storedSize <= header->indexOffset - entry.offset;
+        bool validName = entry.nameOffset <= namesSize && entry.nameLength <= namesSize - entry.nameOffset;
+        bool validCompression = entry.compression == COMPRESSION_NONE ? entry.storedSize == entry.size : entry.compression == COMPRESSION_LZ4;
+        if (!validData || !validName || !validCompression) {
+            Logger::Log("AssetPack", "Corrupted asset pack entry: " + path, Logger::LOG_ERROR);
+            close();
+            return false;
+        }
+    }
+
+    m_Path = path;
+    m_Header = header;
+    m_Entries = entries;
+    m_Names = (const char*)(data + header->namesOffset);
+    return true;
+}
+
+void AssetPack::close() {
+    m_File.close();
+    m_Path = "";
+    m_Header = nullptr;
+    m_Entries = nullptr;
+    m_Names = nullptr;
+}
+
+bool AssetPack::isOpen() {
+    return m_Header != nullptr;
+}
+
+std::string AssetPack::getPath() {
+    return m_Path;
+}
+
+unsigned int AssetPack::getEntryCount() {
+    return isOpen() ? m_Header->entryCount : 0;
+}
+
+const AssetPack::Entry* AssetPack::findEntry(std::string name) {
+    if (!isOpen()) {
+        return nullptr;
+    }
+    name = NormalizeName(name);
+    uint64_t hash = HashName(name);
+    const Entry* begin = m_Entries;
+    const Entry* end = m_Entries + m_Header->entryCount;
+    const char* names = m_Names;
+    const Entry* entry = std::lower_bound(begin, end, hash, [&](const Entry& candidate, uint64_t value) {
+        return entryLess(candidate, value, names, name);
+    });
+    if (entry == end || entry->hash != hash || name.compare(0, std::string::npos, m_Names + entry->nameOffset, entry->nameLength) != 0) {
+        return nullptr;
+    }
+    return entry;
+}
+
+bool AssetPack::read(std::string name, const unsigned char*& data, size_t& size, std::vector<unsigned char>& storage) {
+    const Entry* entry = findEntry(name);
+    if (entry == nullptr) {
+        return false;
+    }
+    if (entry->compression == COMPRESSION_NONE) {
+        data = m_File.getData() + entry->offset;
+        size = entry->size;
+        return true;
+    }
+    storage.resize(entry->size);
+    if (!decompress(entry, storage.empty() ? nullptr : &storage[0])) {
+        return false;
+    }
+    data = storage.empty() ? nullptr : &storage[0];
+    size = entry->size;
+    return true;
+}
+
+bool AssetPack::read(std::string name, std::string& content) {
+    const Entry* entry = findEntry(name);
+    if (entry == nullptr) {
+        return false;
+    }
+    if (entry->compression == COMPRESSION_NONE) {
+        content.assign((const char*)m_File.getData() + entry->offset, entry->size);
+        return true;
+    }
+    content.resize(entry->size);
+    return decompress(entry, entry->size == 0 ? nullptr : (unsigned char*)&content[0]);
+}
+
+bool AssetPack::decompress(const Entry* entry, unsigned char* destination) {
+    if (!LZ4::Decompress(m_File.getData() + entry->offset, entry->storedSize, destination, entry->size)) {
+        Logger::Log("AssetPack", "Corrupted compressed entry " + std::string(m_Names + entry->nameOffset, entry->nameLength) + " in " + m_Path, Logger::LOG_ERROR);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,429 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "Mantaray/Core/BlockCompressor.hpp"
+#include "Mantaray/Core/JobSystem.hpp"
+#include "Mantaray/Core/Logger.hpp"
+
+using namespace MR;
+
+static void fetchBlock(const unsigned char* source, Vector2u size, int nrChannels, unsigned int blockX, unsigned int blockY, unsigned char block[64]) {
+    for (unsigned int y = 0; y < 4; y++) {
+        unsigned int sourceY = std::min(blockY * 4 + y, size.y - 1);
+        const unsigned char* row = source + (size_t)sourceY * size.x * nrChannels;
+        for (unsigned int x = 0; x < 4; x++) {
+            unsigned int sourceX = std::min(blockX * 4 + x, size.x - 1);
+            const unsigned char* pixel = row + sourceX * nrChannels;
+            unsigned char* out = block + (y * 4 + x) * 4;
+            switch (nrChannels) {
+                case 1:
+                    out[0] = out[1] = out[2] = pixel[0];
+                    out[3] = 0xFF;
+                    break;
+                case 2:
+                    out[0] = pixel[0];
+                    out[1] = pixel[1];
+                    out[2] = 0;
+                    out[3] = 0xFF;
+                    break;
+                case 3:
+                    out[0] = pixel[0];
+                    out[1] = pixel[1];
+                    out[2] = pixel[2];
+                    out[3] = 0xFF;
+                    break;
+                default:
+                    memcpy(out, pixel, 4);
+                    break;
+            }
+        }
+    }
+}
+
+static unsigned short packColor565(const float color[3]) {
+    int r = std::min(std::max((int)(color[0] * 31.f / 255.f + .5f), 0), 31);
+    int g = std::min(std::max((int)(color[1] * 63.f / 255.f + .5f), 0), 63);
+    int b = std::min(std::max((int)(color[2] * 31.f / 255.f + .5f), 0), 31);
+    return (unsigned short)((r << 11) | (g << 5) | b);
+}
+
+static void unpackColor565(unsigned short packed, int color[3]) {
+    int r = (packed >> 11) & 31;
+    int g = (packed >> 5) & 63;
+    int b = packed & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+static void buildColorPalette(unsigned short color0, unsigned short color1, bool fourColorMode, int palette[4][3]) {
+    unpackColor565(color0, palette[0]);
+    unpackColor565(color1, palette[1]);
+    for (int c = 0; c < 3; c++) {
+        if (fourColorMode) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        else {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+}
+
+// Picks the closest palette entry for every pixel and returns the summed squared error
+static int selectColorIndices(const unsigned char block[64], const int palette[4][3], unsigned int& indices) {
+    int totalError = 0;
+    indices = 0;
+    for (int i = 0; i < 16; i++) {
+        const unsigned char* pixel = block + i * 4;
+        int bestError = std::numeric_limits<int>::max();
+        unsigned int bestIndex = 0;
+        for (unsigned int p = 0; p < 4; p++) {
+            int dr = pixel[0] - palette[p][0];
+            int dg = pixel[1] - palette[p][1];
+            int db = pixel[2] - palette[p][2];
+            int error = dr * dr + dg * dg + db * db;
+            if (error < bestError) {
+                bestError = error;
+                bestIndex = p;
+            }
+        }
+        indices |= bestIndex << (i * 2);
+        totalError += bestError;
+    }
+    return totalError;
+}
+
+// Solves for the endpoints that best reproduce the block with the given indices (least squares)
+static bool refineEndpoints(const unsigned char block[64], unsigned int indices, float endpoint0[3], float endpoint1[3]) {
+    static const float weights[4] = {1.f, 0.f, 2.f / 3.f, 1.f / 3.f};
+    float aa = 0.f, ab = 0.f, bb = 0.f;
+    float ax[3] = {0.f, 0.f, 0.f};
+    float bx[3] = {0.f, 0.f, 0.f};
+    for (int i = 0; i < 16; i++) {
+        float a = weights[(indices >> (i * 2)) & 3];
+        float b = 1.f - a;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int c = 0; c < 3; c++) {
+            ax[c] += a * block[i * 4 + c];
+            bx[c] += b * block[i * 4 + c];
+        }
+    }
+    float determinant = aa * bb - ab * ab;
+    if (std::fabs(determinant) < 1e-6f) {
+        return false;
+    }
+    float inverse = 1.f / determinant;
+    for (int c = 0; c < 3; c++) {
+        endpoint0[c] = (ax[c] * bb - bx[c] * ab) * inverse;
+        endpoint1[c] = (bx[c] * aa - ax[c] * ab) * inverse;
+    }
+    return true;
+}
+
+static int encodeColorCandidate(const unsigned char block[64], const float endpoint0[3], const float endpoint1[3], unsigned char out[8]) {
+    unsigned short color0 = packColor565(endpoint0);
+    unsigned short color1 = packColor565(endpoint1);
+    if (color0 < color1) {
+        std::swap(color0, color1);
+    }
+
+    unsigned int indices = 0;
+    int error = 0;
+    if (color0 == color1) {
+        // Both endpoints collapsed, index 0 decodes to color0 in either palette mode
+        int palette[4][3];
+        buildColorPalette(color0, color1, true, palette);
+        for (int i = 0; i < 16; i++) {
+            for (int c = 0; c < 3; c++) {
+                int d = block[i * 4 + c] - palette[0][c];
+                error += d * d;
+            }
+        }
+    }
+    else {
+        int palette[4][3];
+        buildColorPalette(color0, color1, true, palette);
+        error = selectColorIndices(block, palette, indices);
+    }
+
+    out[0] = color0 & 0xFF;
+    out[1] = color0 >> 8;
+    out[2] = color1 & 0xFF;
+    out[3] = color1 >> 8;
+    out[4] = indices & 0xFF;
+    out[5] = (indices >> 8) & 0xFF;
+    out[6] = (indices >> 16) & 0xFF;
+    out[7] = (indices >> 24) & 0xFF;
+    return error;
+}
+
+static void encodeColorBlock(const unsigned char block[64], unsigned char out[8]) {
+    float mean[3] = {0.f, 0.f, 0.f};
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 3; c++) {
+            mean[c] += block[i * 4 + c];
+        }
+    }
+    for (int c = 0; c < 3; c++) {
+        mean[c] /= 16.f;
+    }
+
+    float covariance[6] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+    for (int i = 0; i < 16; i++) {
+        float r = block[i * 4 + 0] - mean[0];
+        float g = block[i * 4 + 1] - mean[1];
+        float b = block[i * 4 + 2] - mean[2];
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+
+    // Principal axis through power iteration, luminance is a good starting guess
+    float axis[3] = {.299f, .587f, .114f};
+    for (int iteration = 0; iteration < 4; iteration++) {
+        float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+        float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+        float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+        float length = std::max(std::max(std::fabs(x), std::fabs(y)), std::fabs(z));
+        if (length < 1e-6f) {
+            break;
+        }
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+
+    float minProjection = std::numeric_limits<float>::max();
+    float maxProjection = -std::numeric_limits<float>::max();
+    int minPixel = 0, maxPixel = 0;
+    for (int i = 0; i < 16; i++) {
+        float projection = block[i * 4 + 0] * axis[0] + block[i * 4 + 1] * axis[1] + block[i * 4 + 2] * axis[2];
+        if (projection < minProjection) {
+            minProjection = projection;
+            minPixel = i;
+        }
+        if (projection > maxProjection) {
+            maxProjection = projection;
+            maxPixel = i;
+        }
+    }
+
+    float endpoint0[3], endpoint1[3];
+    for (int c = 0; c < 3; c++) {
+        endpoint0[c] = block[maxPixel * 4 + c];
+        endpoint1[c] = block[minPixel * 4 + c];
+    }
+    int error = encodeColorCandidate(block, endpoint0, endpoint1, out);
+
+    // Two rounds of least squares refinement, kept only while they reduce the error
+    for (int iteration = 0; iteration < 2 && error > 0; iteration++) {
+        unsigned int indices = out[4] | (out[5] << 8) | (out[6] << 16) | ((unsigned int)out[7] << 24);
+        if (!refineEndpoints(block, indices, endpoint0, endpoint1)) {
+            break;
+        }
+        unsigned char candidate[8];
+        int candidateError = encodeColorCandidate(block, endpoint0, endpoint1, candidate);
+        if (candidateError >= error) {
+            break;
+        }
+        memcpy(out, candidate, 8);
+        error = candidateError;
+    }
+}
+
+static void encodeSingleChannelBlock(const unsigned char block[64], int channel, unsigned char out[8]) {
+    int minimum = 255, maximum = 0;
+    for (int i = 0; i < 16; i++) {
+        minimum = std::min(minimum, (int)block[i * 4 + channel]);
+        maximum = std::max(maximum, (int)block[i * 4 + channel]);
+    }
+
+    out[0] = (unsigned char)maximum;
+    out[1] = (unsigned char)minimum;
+    unsigned long long indices = 0;
+    if (maximum != minimum) {
+        // Eight value mode, entries 2 to 7 interpolate from endpoint 0 towards endpoint 1
+        int palette[8];
+        palette[0] = maximum;
+        palette[1] = minimum;
+        for (int p = 2; p < 8; p++) {
+            palette[p] = ((8 - p) * maximum + (p - 1) * minimum) / 7;
+        }
+        for (int i = 0; i < 16; i++) {
+            int value = block[i * 4 + channel];
+            int bestError = 256;
+            unsigned long long bestIndex = 0;
+            for (int p = 0; p < 8; p++) {
+                int error = std::abs(value - palette[p]);
+                if (error < bestError) {
+                    bestError = error;
+                    bestIndex = p;
+                }
+            }
+            indices |= bestIndex << (i * 3);
+        }
+    }
+    for (int b = 0; b < 6; b++) {
+        out[2 + b] = (indices >> (b * 8)) & 0xFF;
+    }
+}
+
+static void decodeColorBlock(const unsigned char* in, unsigned char block[64], bool forceFourColorMode) {
+    unsigned short color0 = in[0] | (in[1] << 8);
+    unsigned short color1 = in[2] | (in[3] << 8);
+    unsigned int indices = in[4] | (in[5] << 8) | (in[6] << 16) | ((unsigned int)in[7] << 24);
+    bool fourColorMode = forceFourColorMode || color0 > color1;
+    int palette[4][3];
+    buildColorPalette(color0, color1, fourColorMode, palette);
+    for (int i = 0; i < 16; i++) {
+        unsigned int index = (indices >> (i * 2)) & 3;
+        block[i * 4 + 0] = palette[index][0];
+        block[i * 4 + 1] = palette[index][1];
+        block[i * 4 + 2] = palette[index][2];
+        block[i * 4 + 3] = (!fourColorMode && index == 3) ? 0 : 0xFF;
+    }
+}
+
+static void decodeSingleChannelBlock(const unsigned char* in, unsigned char block[64], int channel) {
+    int palette[8];
+    palette[0] = in[0];
+    palette[1] = in[1];
+    if (palette[0] > palette[1]) {
+        for (int p = 2; p < 8; p++) {
+            palette[p] = ((8 - p) * palette[0] + (p - 1) * palette[1]) / 7;
+        }
+    }
+    else {
+        for (int p = 2; p < 6; p++) {
+            palette[p] = ((6 - p) * palette[0] + (p - 1) * palette[1]) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    unsigned long long indices = 0;
+    for (int b = 0; b < 6; b++) {
+        indices |= (unsigned long long)in[2 + b] << (b * 8);
+    }
+    for (int i = 0; i < 16; i++) {
+        block[i * 4 + channel] = palette[(indices >> (i * 3)) & 7];
+    }
+}
+
+template<typename Function>
+static void parallelBlockRows(unsigned int rowCount, unsigned int threadCount, Function function) {
+    if (threadCount == 0) {
+        JobSystem::ParallelFor(rowCount, 4, function);
+        return;
+    }
+    // One job per thread, smaller ranges would let more threads pick up the work
+    unsigned int jobCount = std::min(threadCount, rowCount);
+    JobSystem::ParallelFor(jobCount, 1, [&](unsigned int begin, unsigned int end) {
+        for (unsigned int job = begin; job < end; job++) {
+            function((unsigned int)((unsigned long long)rowCount * job / jobCount), (unsigned int)((unsigned long long)rowCount * (job + 1) / jobCount));
+        }
+    });
+}
+
+unsigned int BlockCompressor::GetBlockByteSize(BlockFormat format) {
+    return (format == BLOCK_FORMAT_BC3) ? 16 : 8;
+}
+
+size_t BlockCompressor::GetCompressedSize(Vector2u size, BlockFormat format) {
+    size_t blocksX = (size.x + 3) / 4;
+    size_t blocksY = (size.y + 3) / 4;
+    return blocksX * blocksY * GetBlockByteSize(format);
+}
+
+bool BlockCompressor::Compress(const unsigned char* source, Vector2u size, int nrChannels, BlockFormat format, std::vector<unsigned char>& destination, unsigned int threadCount) {
+    if (source == nullptr || size.x == 0 || size.y == 0 || nrChannels < 1 || nrChannels > 4) {
+        Logger::Log("BlockCompressor", "Invalid image for block compression", Logger::LOG_ERROR);
+        return false;
+    }
+
+    unsigned int blocksX = (size.x + 3) / 4;
+    unsigned int blocksY = (size.y + 3) / 4;
+    unsigned int blockByteSize = GetBlockByteSize(format);
+    destination.resize(GetCompressedSize(size, format));
+    unsigned char* output = &destination[0];
+
+    parallelBlockRows(blocksY, threadCount, [&](unsigned int begin, unsigned int end) {
+        unsigned char block[64];
+        for (unsigned int blockY = begin; blockY < end; blockY++) {
+            unsigned char* out = output + (size_t)blockY * blocksX * blockByteSize;
+            for (unsigned int blockX = 0; blockX < blocksX; blockX++, out += blockByteSize) {
+                fetchBlock(source, size, nrChannels, blockX, blockY, block);
+                switch (format) {
+                    case BLOCK_FORMAT_BC1:
+                        encodeColorBlock(block, out);
+                        break;
+                    case BLOCK_FORMAT_BC3:
+                        encodeSingleChannelBlock(block, 3, out);
+                        encodeColorBlock(block, out + 8);
+                        break;
+                    case BLOCK_FORMAT_BC4:
+                        encodeSingleChannelBlock(block, 0, out);
+                        break;
+                }
+            }
+        }
+    });
+    return true;
+}
+
+void BlockCompressor::Decompress(const unsigned char* source, Vector2u size, BlockFormat format, unsigned char* destination) {
+    unsigned int blocksX = (size.x + 3) / 4;
+    unsigned int blocksY = (size.y + 3) / 4;
+    unsigned int blockByteSize = GetBlockByteSize(format);
+    unsigned char block[64];
+    for (unsigned int blockY = 0; blockY < blocksY; blockY++) {
+        for (unsigned int blockX = 0; blockX < blocksX; blockX++, source += blockByteSize) {
+            switch (format) {
+                case BLOCK_FORMAT_BC1:
+                    decodeColorBlock(source, block, false);
+                    break;
+                case BLOCK_FORMAT_BC3:
+                    decodeColorBlock(source + 8, block, true);
+                    decodeSingleChannelBlock(source, block, 3);
+                    break;
+                case BLOCK_FORMAT_BC4:
+                    memset(block, 0, sizeof(block));
+                    decodeSingleChannelBlock(source, block, 0);
+                    for (int i = 0; i < 16; i++) {
+                        block[i * 4 + 3] = 0xFF;
+                    }
+                    break;
+            }
+
+            unsigned int width = std::min(4u, size.x - blockX * 4);
+            unsigned int height = std::min(4u, size.y - blockY * 4);
+            for (unsigned int y = 0; y < height; y++) {
+                unsigned char* row = destination + ((size_t)(blockY * 4 + y) * size.x + blockX * 4) * 4;
+                memcpy(row, block + y * 16, width * 4);
+            }
+        }
+    }
+}
+
+double BlockCompressor::ComputePSNR(const unsigned char* a, const unsigned char* b, size_t pixelCount, int nrChannels, int stride) {
+    double squaredError = 0.;
+    for (size_t i = 0; i < pixelCount; i++) {
+        for (int c = 0; c < nrChannels; c++) {
+            double difference = (double)a[i * stride + c] - (double)b[i * stride + c];
+            squaredError += difference * difference;
+        }
+    }
+    if (squaredError == 0.) {
+        return std::numeric_limits<double>::infinity();
+    }
+    double meanSquaredError = squaredError / ((double)pixelCount * nrChannels);
+    return 10. * std::log10(255. * 255. / meanSquaredError);
+}
@@ -13,21 +13,21 @@
 using namespace MR;
 
 Canvas::Canvas(Vector2u resolution) : RenderTexture(resolution) {
-    ObjectLibrary::FindObject("DefaultTexturedShader", m_DisplayShader);
+    m_DisplayShader = ObjectLibrary::DefaultTexturedShader;
 }
 
 Canvas::Canvas(Vector2u resolution, Rectanglef displaySpace) : RenderTexture(resolution) {
     m_DisplaySpace = displaySpace;
-    ObjectLibrary::FindObject("DefaultTexturedShader", m_DisplayShader);
+    m_DisplayShader = ObjectLibrary::DefaultTexturedShader;
 }
 
 Canvas::Canvas(Vector2u resolution, Vector2f coordinateScale) : RenderTexture(resolution, coordinateScale) {
-    ObjectLibrary::FindObject("DefaultTexturedShader", m_DisplayShader);
+    m_DisplayShader = ObjectLibrary::DefaultTexturedShader;
 }
 
 Canvas::Canvas(Vector2u resolution, Vector2f coordinateScale, Rectanglef displaySpace) : RenderTexture(resolution, coordinateScale) {
     m_DisplaySpace = displaySpace;
-    ObjectLibrary::FindObject("DefaultTexturedShader", m_DisplayShader);
+    m_DisplayShader = ObjectLibrary::DefaultTexturedShader;
 }
 
 Rectanglef Canvas::getDisplaySpace() {
@@ -2,12 +2,15 @@
 #include <GLFW/glfw3.h>
 
 #include "Mantaray/OpenGL/Context.hpp"
+#include "Mantaray/OpenGL/FrameStatistics.hpp"
 #include "Mantaray/Core/Logger.hpp"
 
 using namespace MR;
 
 bool Context::IsInitialized = false;
 GLState Context::State = GLState();
+std::atomic<int> Context::SwapInterval(1);
+std::atomic<bool> Context::SwapIntervalPending(false);
 
 bool Context::Create(GLFWwindow** outWindow, std::string title, Vector2u size) {
     if (!Context::IsInitialized) {
@@ -32,9 +35,8 @@ bool Context::Create(GLFWwindow** outWindow, std::string title, Vector2u size) {
         }
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glfwSwapInterval(1);
-
         Context::IsInitialized = true;
+        Context::ApplySwapInterval();
         return true;
     } 
     else {
@@ -58,6 +60,7 @@ void Context::BindTexture2D(unsigned int textureID) {
         return;
     }
     glBindTexture(GL_TEXTURE_2D, textureID);
+    FrameStatistics::AddTextureBind();
 }
 
 void Context::BindFramebuffer(unsigned int frameBufferID) {
@@ -65,6 +68,7 @@ void Context::BindFramebuffer(unsigned int frameBufferID) {
         return;
     }
     glBindFramebuffer(GL_FRAMEBUFFER, frameBufferID);
+    FrameStatistics::AddFramebufferSwitch();
 }
 
 void Context::BindVertexArray(unsigned int vertexArrayID) {
@@ -72,6 +76,7 @@ void Context::BindVertexArray(unsigned int vertexArrayID) {
         return;
     }
     glBindVertexArray(vertexArrayID);
+    FrameStatistics::AddVertexArrayBind();
 }
 
 void Context::UseProgram(unsigned int shaderProgramID) {
@@ -79,4 +84,44 @@ void Context::UseProgram(unsigned int shaderProgramID) {
         return;
     }
     glUseProgram(shaderProgramID);
+    FrameStatistics::AddShaderSwitch();
+}
+
+void Context::SetSwapInterval(int interval) {
+    Context::SwapInterval = interval;
+    // Before creation the interval is applied once the window exists
+    if (Context::IsInitialized && glfwGetCurrentContext() != nullptr) {
+        Context::ApplySwapInterval();
+    }
+    else if (Context::IsInitialized) {
+        Context::SwapIntervalPending = true;
+    }
+}
+
+void Context::ApplyPendingSwapInterval() {
+    if (Context::SwapIntervalPending.exchange(false)) {
+        Context::ApplySwapInterval();
+    }
+}
+
+int Context::GetSwapInterval() {
+    return Context::SwapInterval;
+}
+
+bool Context::SupportsAdaptiveSwap() {
+    if (!Context::IsInitialized) {
+        return false;
+    }
+    return glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear");
+}
+
+void Context::ApplySwapInterval() {
+    Context::SwapIntervalPending = false;
+    int interval = Context::SwapInterval;
+    // The configured interval is kept, a later context may support adaptive vsync
+    if (interval < 0 && !Context::SupportsAdaptiveSwap()) {
+        Logger::Log("Context", "Adaptive vsync is not supported, using regular vsync", Logger::LOG_WARNING);
+        interval = -interval;
+    }
+    glfwSwapInterval(interval);
 }
@@ -0,0 +1,289 @@
+#include "Mantaray/Core/EntityWorld.hpp"
+#include "Mantaray/Core/Logger.hpp"
+#include "Mantaray/OpenGL/Drawables.hpp"
+
+using namespace MR;
+
+EntityChunk::EntityChunk(unsigned int components) {
+    m_Components = components;
+    m_Entities.reserve(EntityWorld::ChunkCapacity);
+    if (components & EntityWorld::COMPONENT_TRANSFORM) {
+        m_Transforms.resize(EntityWorld::ChunkCapacity);
+    }
+    if (components & EntityWorld::COMPONENT_SPRITE) {
+        m_Sprites.resize(EntityWorld::ChunkCapacity);
+    }
+    if (components & EntityWorld::COMPONENT_COLOR) {
+        m_Colors.resize(EntityWorld::ChunkCapacity);
+    }
+    if (components & EntityWorld::COMPONENT_LAYER) {
+        m_Layers.resize(EntityWorld::ChunkCapacity);
+    }
+    if (components & EntityWorld::COMPONENT_ANIMATION) {
+        m_Animations.resize(EntityWorld::ChunkCapacity);
+    }
+}
+
+EntityWorld::EntityWorld() {
+
+}
+
+EntityWorld::~EntityWorld() {
+    clear();
+}
+
+void EntityWorld::clear() {
+    for (unsigned int components = 0; components < ArchetypeCount; components++) {
+        for (EntityChunk* chunk : m_Archetypes[components]) {
+            delete chunk;
+        }
+        m_Archetypes[components].clear();
+    }
+    // Generations survive the clear so entities from before it stay stale
+    m_FreeRecords.clear();
+    for (uint32_t index = m_Records.size(); index > 0; index--) {
+        EntityRecord& record = m_Records[index - 1];
+        if (record.components != 0xFFFFFFFF) {
+            record.generation = record.generation + 1 == 0 ? 1 : record.generation + 1;
+            record.components = 0xFFFFFFFF;
+        }
+        m_FreeRecords.push_back(index - 1);
+    }
+    m_EntityCount = 0;
+}
+
+Entity EntityWorld::createEntity(unsigned int components) {
+    components &= COMPONENT_ALL;
+    uint32_t index;
+    if (!m_FreeRecords.empty()) {
+        index = m_FreeRecords.back();
+        m_FreeRecords.pop_back();
+    }
+    else {
+        index = m_Records.size();
+        EntityRecord record;
+        record.generation = 1;
+        m_Records.push_back(record);
+    }
+
+    EntityRecord& record = m_Records[index];
+    record.components = components;
+    record.chunk = addRow(components, index, record.row);
+    m_EntityCount++;
+
+    Entity entity;
+    entity.index = index;
+    entity.generation = record.generation;
+    return entity;
+}
+
+Entity EntityWorld::createEntity(const Sprite& sprite, int layer) {
+    Entity entity = createEntity(COMPONENT_RENDERABLE);
+    TransformComponent* transform = getTransform(entity);
+    transform->position = sprite.position;
+    transform->size = sprite.size;
+    transform->rotation = sprite.rotation;
+    transform->rotationCenter = sprite.rotationCenter;
+    SpriteComponent* spriteComponent = getSprite(entity);
+    spriteComponent->texture = sprite.texture;
+    spriteComponent->shader = sprite.shader;
+    spriteComponent->sourceRectangle = sprite.sourceRectangle;
+    spriteComponent->absoluteSize = sprite.absoluteSize;
+    *getColor(entity) = sprite.color;
+    *getLayer(entity) = layer;
+    return entity;
+}
+
+void EntityWorld::destroyEntity(Entity entity) {
+    EntityRecord* record = findRecord(entity);
+    if (record == nullptr) {
+        Logger::Log("EntityWorld", "Cannot destroy a stale entity!", Logger::LOG_WARNING);
+        return;
+    }
+    removeRow(record->components, record->chunk, record->row);
+    record->generation = record->generation + 1 == 0 ? 1 : record->generation + 1;
+    record->components = 0xFFFFFFFF;
+    m_FreeRecords.push_back(entity.index);
+    m_EntityCount--;
+}
+
+bool EntityWorld::isAlive(Entity entity) {
+    return findRecord(entity) != nullptr;
+}
+
+unsigned int EntityWorld::getComponents(Entity entity) {
+    EntityRecord* record = findRecord(entity);
+    return record != nullptr ? record->components : 0;
+}
+
+void EntityWorld::setComponents(Entity entity, unsigned int components) {
+    components &= COMPONENT_ALL;
+    EntityRecord* record = findRecord(entity);
+    if (record == nullptr) {
+        Logger::Log("EntityWorld", "Cannot change the components of a stale entity!", Logger::LOG_WARNING);
+        return;
+    }
+    if (record->components == components) {
+        return;
+    }
+
+    unsigned int oldComponents = record->components;
+    EntityChunk& oldChunk = *m_Archetypes[oldComponents][record->chunk];
+    uint32_t oldRow = record->row;
+    uint32_t row;
+    uint32_t chunkIndex = addRow(components, entity.index, row);
+    EntityChunk& chunk = *m_Archetypes[components][chunkIndex];
+
+    unsigned int shared = oldComponents & components;
+    if (shared & COMPONENT_TRANSFORM) {
+        chunk.m_Transforms[row] = oldChunk.m_Transforms[oldRow];
+    }
+    if (shared & COMPONENT_SPRITE) {
+        chunk.m_Sprites[row] = oldChunk.m_Sprites[oldRow];
+    }
+    if (shared & COMPONENT_COLOR) {
+        chunk.m_Colors[row] = oldChunk.m_Colors[oldRow];
+    }
+    if (shared & COMPONENT_LAYER) {
+        chunk.m_Layers[row] = oldChunk.m_Layers[oldRow];
+    }
+    if (shared & COMPONENT_ANIMATION) {
+        chunk.m_Animations[row] = oldChunk.m_Animations[oldRow];
+    }
+
+    // The old archetype differs, so removing its row cannot move the row just added
+    removeRow(oldComponents, record->chunk, oldRow);
+    record->components = components;
+    record->chunk = chunkIndex;
+    record->row = row;
+}
+
+void EntityWorld::addComponents(Entity entity, unsigned int components) {
+    setComponents(entity, getComponents(entity) | components);
+}
+
+void EntityWorld::removeComponents(Entity entity, unsigned int components) {
+    setComponents(entity, getComponents(entity) & ~components);
+}
+
+TransformComponent* EntityWorld::getTransform(Entity entity) {
+    EntityRecord* record = findRecord(entity);
+    if (record == nullptr || !(record->components & COMPONENT_TRANSFORM)) {
+        return nullptr;
+    }
+    return &m_Archetypes[record->components][record->chunk]->m_Transforms[record->row];
+}
+
+SpriteComponent* EntityWorld::getSprite(Entity entity) {
+    EntityRecord* record = findRecord(entity);
+    if (record == nullptr || !(record->components & COMPONENT_SPRITE)) {
+        return nullptr;
+    }
+    return &m_Archetypes[record->components][record->chunk]->m_Sprites[record->row];
+}
+
+Color* EntityWorld::getColor(Entity entity) {
+    EntityRecord* record = findRecord(entity);
+    if (record == nullptr || !(record->components & COMPONENT_COLOR)) {
+        return nullptr;
+    }
+    return &m_Archetypes[record->components][record->chunk]->m_Colors[record->row];
+}
+
+int* EntityWorld::getLayer(Entity entity) {
+    EntityRecord* record = findRecord(entity);
+    if (record == nullptr || !(record->components & COMPONENT_LAYER)) {
+        return nullptr;
+    }
+    return &m_Archetypes[record->components][record->chunk]->m_Layers[record->row];
+}
+
+AnimationState* EntityWorld::getAnimation(Entity entity) {
+    EntityRecord* record = findRecord(entity);
+    if (record == nullptr || !(record->components & COMPONENT_ANIMATION)) {
+        return nullptr;
+    }
+    return &m_Archetypes[record->components][record->chunk]->m_Animations[record->row];
+}
+
+unsigned int EntityWorld::getEntityCount() {
+    return m_EntityCount;
+}
+
+EntityWorld::EntityRecord* EntityWorld::findRecord(Entity entity) {
+    if (entity.index >= m_Records.size()) {
+        return nullptr;
+    }
+    EntityRecord& record = m_Records[entity.index];
+    if (record.generation != entity.generation || record.components == 0xFFFFFFFF) {
+        return nullptr;
+    }
+    return &record;
+}
+
+uint32_t EntityWorld::addRow(unsigned int components, uint32_t entityIndex, uint32_t& outRow) {
+    std::vector<EntityChunk*>& chunks = m_Archetypes[components];
+    // Only the last chunk of an archetype is ever partially filled
+    if (chunks.empty() || chunks.back()->m_Count == ChunkCapacity) {
+        chunks.push_back(new EntityChunk(components));
+    }
+    EntityChunk& chunk = *chunks.back();
+    outRow = chunk.m_Count++;
+
+    Entity entity;
+    entity.index = entityIndex;
+    entity.generation = m_Records[entityIndex].generation;
+    chunk.m_Entities.push_back(entity);
+    if (components & COMPONENT_TRANSFORM) {
+        chunk.m_Transforms[outRow] = TransformComponent();
+    }
+    if (components & COMPONENT_SPRITE) {
+        chunk.m_Sprites[outRow] = SpriteComponent();
+    }
+    if (components & COMPONENT_COLOR) {
+        chunk.m_Colors[outRow] = Color(0xFF);
+    }
+    if (components & COMPONENT_LAYER) {
+        chunk.m_Layers[outRow] = 0;
+    }
+    if (components & COMPONENT_ANIMATION) {
+        chunk.m_Animations[outRow] = AnimationState();
+    }
+    return chunks.size() - 1;
+}
+
+void EntityWorld::removeRow(unsigned int components, uint32_t chunkIndex, uint32_t row) {
+    std::vector<EntityChunk*>& chunks = m_Archetypes[components];
+    EntityChunk& chunk = *chunks[chunkIndex];
+    EntityChunk& last = *chunks.back();
+    uint32_t lastRow = last.m_Count - 1;
+
+    if (&chunk != &last || row != lastRow) {
+        Entity moved = last.m_Entities[lastRow];
+        chunk.m_Entities[row] = moved;
+        if (components & COMPONENT_TRANSFORM) {
+            chunk.m_Transforms[row] = last.m_Transforms[lastRow];
+        }
+        if (components & COMPONENT_SPRITE) {
+            chunk.m_Sprites[row] = last.m_Sprites[lastRow];
+        }
+        if (components & COMPONENT_COLOR) {
+            chunk.m_Colors[row] = last.m_Colors[lastRow];
+        }
+        if (components & COMPONENT_LAYER) {
+            chunk.m_Layers[row] = last.m_Layers[lastRow];
+        }
+        if (components & COMPONENT_ANIMATION) {
+            chunk.m_Animations[row] = last.m_Animations[lastRow];
+        }
+        m_Records[moved.index].chunk = chunkIndex;
+        m_Records[moved.index].row = row;
+    }
+
+    last.m_Entities.pop_back();
+    last.m_Count--;
+    if (last.m_Count == 0) {
+        delete chunks.back();
+        chunks.pop_back();
+    }
+}
@@ -1,14 +1,19 @@
-#include <fstream>
-#include <streambuf>
+#include <cstdio>
+
+#include <cerrno>
 
 #ifdef PLATFORM_WINDOWS
 #include <Windows.h>
+#include <direct.h>
 #endif
 #ifdef PLATFORM_LINUX
+#include <sys/stat.h>
 #include <unistd.h>
 #endif
 
 #include "Mantaray/Core/FileSystem.hpp"
+#include "Mantaray/Core/AssetPack.hpp"
+#include "Mantaray/Core/ImageKernels.hpp"
 #include "Mantaray/Core/Logger.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -16,7 +21,31 @@
 
 using namespace MR;
 
-std::string FileSystem::GetWorkingDirectory() {
+std::vector<AssetPack*> FileSystem::MountedPacks = std::vector<AssetPack*>();
+
+// Below this size one read is cheaper than setting up and tearing down a mapping
+static const long MapThreshold = 64 * 1024;
+
+// Reads the whole file with a single fread into a buffer sized up front
+template<typename Buffer>
+static bool readWholeFile(FILE* file, long size, Buffer& buffer) {
+    buffer.resize(size);
+    if (size == 0) {
+        return true;
+    }
+    return fread(&buffer[0], 1, size, file) == (size_t)size;
+}
+
+static long getFileSize(FILE* file) {
+    if (fseek(file, 0, SEEK_END) != 0) {
+        return -1;
+    }
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    return size;
+}
+
+static std::string queryExecutableDirectory() {
 #ifdef PLATFORM_WINDOWS
     // Windows specific way of checking if file exists
     char result[MAX_PATH];
@@ -32,38 +61,155 @@ std::string FileSystem::GetWorkingDirectory() {
 #endif
 #ifdef PLATFORM_LINUX
     char result[512];
-    readlink("/proc/self/exe", result, 512);
-    std::string wd(result);
+    ssize_t length = readlink("/proc/self/exe", result, sizeof(result) - 1);
+    std::string wd(result, length > 0 ? length : 0);
     return wd.substr(0, wd.find_last_of("\\/") + 1);
 #endif
 }
 
+std::string FileSystem::GetWorkingDirectory() {
+    // The executable does not move while running, resolve it once
+    static const std::string workingDirectory = queryExecutableDirectory();
+    return workingDirectory;
+}
+
 bool FileSystem::ReadFile(std::string path, std::string& content, bool absolutePath) {
-    if (!absolutePath){
+    if (!absolutePath) {
+        for (auto pack = MountedPacks.rbegin(); pack != MountedPacks.rend(); pack++) {
+            if ((*pack)->read(path, content)) {
+                return true;
+            }
+        }
         path = FileSystem::GetWorkingDirectory() + path;
     }
 
-    std::ifstream t(path.c_str());
-    if (!t){
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
         Logger::Log("FileSystem", "Could not open file: " + path, Logger::LOG_ERROR);
         return false;
     }
-    content.clear();
-    content = std::string((std::istreambuf_iterator<char>(t)),
-                            std::istreambuf_iterator<char>());
-    return true;
+    long size = getFileSize(file);
+    bool success = size >= 0 && readWholeFile(file, size, content);
+    fclose(file);
+    if (!success) {
+        Logger::Log("FileSystem", "Could not read file: " + path, Logger::LOG_ERROR);
+        content.clear();
+    }
+    return success;
 }
 
-bool FileSystem::ReadImage(std::string path, unsigned char*& data, int& width, int& height, int& nrChannels, bool flipVertically, bool absolutePath) {
+bool FileSystem::MapFile(std::string path, FileView& view, bool absolutePath) {
+    view = FileView();
     if (!absolutePath) {
+        if (ReadPackedFile(path, view.m_Data, view.m_Size, view.m_Buffer)) {
+            view.m_Valid = true;
+            return true;
+        }
         path = FileSystem::GetWorkingDirectory() + path;
     }
 
-    stbi_set_flip_vertically_on_load(flipVertically);
-    data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        Logger::Log("FileSystem", "Could not open file: " + path, Logger::LOG_ERROR);
+        return false;
+    }
+    long size = getFileSize(file);
+    if (size >= MapThreshold && view.m_Mapping.open(path)) {
+        fclose(file);
+        view.m_Data = view.m_Mapping.getData();
+        view.m_Size = view.m_Mapping.getSize();
+        view.m_Valid = true;
+        return true;
+    }
+    // Small files and anything that cannot be mapped are read in one go
+    bool success = size >= 0 && readWholeFile(file, size, view.m_Buffer);
+    fclose(file);
+    if (!success) {
+        Logger::Log("FileSystem", "Could not read file: " + path, Logger::LOG_ERROR);
+        view.m_Buffer.clear();
+        return false;
+    }
+    view.m_Data = view.m_Buffer.empty() ? nullptr : &view.m_Buffer[0];
+    view.m_Size = view.m_Buffer.size();
+    view.m_Valid = true;
+    return true;
+}
+
+bool FileSystem::ReadImage(std::string path, unsigned char*& data, int& width, int& height, int& nrChannels, bool flipVertically, bool absolutePath) {
+    FileView view;
+    if (!MapFile(path, view, absolutePath)) {
+        data = nullptr;
+        return false;
+    }
+
+    // stb_image keeps its flip setting in a global, flipping here keeps decoding safe to run on several threads
+    data = stbi_load_from_memory(view.getData(), (int)view.getSize(), &width, &height, &nrChannels, 0);
     if (!data) {
         Logger::Log("FileSystem", "Image from " + path + " could not be loaded", MR::Logger::LOG_ERROR);
         return false;
     }
+    if (flipVertically) {
+        ImageKernels::FlipRows(data, data, width * nrChannels, height);
+    }
+    return true;
+}
+
+bool FileSystem::MakeDirectory(std::string path, bool absolutePath) {
+    if (!absolutePath) {
+        path = FileSystem::GetWorkingDirectory() + path;
+    }
+#ifdef PLATFORM_WINDOWS
+    int result = _mkdir(path.c_str());
+#endif
+#ifdef PLATFORM_LINUX
+    int result = mkdir(path.c_str(), 0755);
+#endif
+    if (result != 0 && errno != EEXIST) {
+        Logger::Log("FileSystem", "Could not create directory: " + path, Logger::LOG_ERROR);
+        return false;
+    }
     return true;
 }
+
+bool FileSystem::MountPack(std::string packPath, bool absolutePath) {
+    if (!absolutePath) {
+        packPath = FileSystem::GetWorkingDirectory() + packPath;
+    }
+
+    AssetPack* pack = new AssetPack(packPath);
+    if (!pack->isOpen()) {
+        delete pack;
+        return false;
+    }
+    MountedPacks.push_back(pack);
+    Logger::Log("FileSystem", "Mounted " + packPath + " with " + std::to_string(pack->getEntryCount()) + " entries", Logger::LOG_DEBUG);
+    return true;
+}
+
+void FileSystem::UnmountPacks() {
+    for (AssetPack* pack : MountedPacks) {
+        delete pack;
+    }
+    MountedPacks.clear();
+}
+
+bool FileSystem::ReadPackedFile(std::string path, const unsigned char*& data, size_t& size, std::vector<unsigned char>& storage) {
+    for (auto pack = MountedPacks.rbegin(); pack != MountedPacks.rend(); pack++) {
+        if ((*pack)->read(path, data, size, storage)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FileView::isValid() {
+    return m_Valid;
+}
+
+const unsigned char* FileView::getData() {
+    return m_Data;
+}
+
+size_t FileView::getSize() {
+    return m_Size;
+}
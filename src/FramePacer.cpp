@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <thread>
+
+#include "Mantaray/Core/FramePacer.hpp"
+#include "Mantaray/OpenGL/Context.hpp"
+
+using namespace MR;
+
+typedef std::chrono::steady_clock Clock;
+
+static const double MinimumSleepMargin = 0.0002;
+static const double MaximumSleepMargin = 0.004;
+
+FramePacer::VSyncMode FramePacer::CurrentVSyncMode = FramePacer::VSYNC_ON;
+float FramePacer::TargetFrameRate = 0.f;
+bool FramePacer::HasDeadline = false;
+Clock::time_point FramePacer::NextDeadline = Clock::time_point();
+double FramePacer::SleepMargin = 0.001;
+
+float FramePacer::FixedTimestep = 1.f / 60.f;
+unsigned int FramePacer::MaxStepsPerFrame = 8;
+double FramePacer::Accumulator = 0.0;
+unsigned int FramePacer::DroppedStepCount = 0;
+bool FramePacer::FixedStepping = false;
+
+void FramePacer::SetVSyncMode(VSyncMode vsyncMode) {
+    FramePacer::CurrentVSyncMode = vsyncMode;
+    switch (vsyncMode) {
+        case VSYNC_OFF:
+            Context::SetSwapInterval(0);
+            break;
+        case VSYNC_ON:
+            Context::SetSwapInterval(1);
+            break;
+        case VSYNC_ADAPTIVE:
+            Context::SetSwapInterval(-1);
+            break;
+    }
+}
+
+FramePacer::VSyncMode FramePacer::GetVSyncMode() {
+    return FramePacer::CurrentVSyncMode;
+}
+
+void FramePacer::SetTargetFrameRate(float framesPerSecond) {
+    FramePacer::TargetFrameRate = std::max(framesPerSecond, 0.f);
+    FramePacer::HasDeadline = false;
+}
+
+float FramePacer::GetTargetFrameRate() {
+    return FramePacer::TargetFrameRate;
+}
+
+void FramePacer::WaitForNextFrame() {
+    if (FramePacer::TargetFrameRate <= 0.f) {
+        FramePacer::HasDeadline = false;
+        return;
+    }
+    Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / FramePacer::TargetFrameRate));
+    Clock::time_point now = Clock::now();
+    if (!FramePacer::HasDeadline) {
+        FramePacer::NextDeadline = now;
+        FramePacer::HasDeadline = true;
+    }
+    FramePacer::NextDeadline += period;
+    if (FramePacer::NextDeadline + period < now) {
+        FramePacer::NextDeadline = now;
+        return;
+    }
+
+    double remaining = std::chrono::duration<double>(FramePacer::NextDeadline - now).count() - FramePacer::SleepMargin;
+    if (remaining > 0.0) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(remaining));
+        double overshoot = std::chrono::duration<double>(Clock::now() - now).count() - remaining;
+        // Rises at once to a larger overshoot and decays slowly, so a single spike is not forgotten next frame
+        FramePacer::SleepMargin = std::max(overshoot * 1.25, FramePacer::SleepMargin * 0.99);
+        FramePacer::SleepMargin = std::min(std::max(FramePacer::SleepMargin, MinimumSleepMargin), MaximumSleepMargin);
+    }
+    while (Clock::now() < FramePacer::NextDeadline) {
+        std::this_thread::yield();
+    }
+}
+
+float FramePacer::GetSleepMargin() {
+    return (float)FramePacer::SleepMargin;
+}
+
+void FramePacer::SetFixedTimestep(float step, unsigned int maxStepsPerFrame) {
+    FramePacer::FixedTimestep = std::max(step, 1e-6f);
+    FramePacer::MaxStepsPerFrame = std::max(maxStepsPerFrame, 1u);
+}
+
+float FramePacer::GetFixedTimestep() {
+    return FramePacer::FixedTimestep;
+}
+
+void FramePacer::Accumulate(float deltaTime) {
+    if (!FramePacer::FixedStepping) {
+        return;
+    }
+    FramePacer::Accumulator += std::max(deltaTime, 0.f);
+    double limit = (double)FramePacer::FixedTimestep * FramePacer::MaxStepsPerFrame;
+    if (FramePacer::Accumulator > limit) {
+        FramePacer::DroppedStepCount += (unsigned int)((FramePacer::Accumulator - limit) / FramePacer::FixedTimestep);
+        FramePacer::Accumulator = limit;
+    }
+}
+
+bool FramePacer::StepFixed() {
+    FramePacer::FixedStepping = true;
+    if (FramePacer::Accumulator < FramePacer::FixedTimestep) {
+        return false;
+    }
+    FramePacer::Accumulator -= FramePacer::FixedTimestep;
+    return true;
+}
+
+float FramePacer::GetInterpolationAlpha() {
+    return (float)(FramePacer::Accumulator / FramePacer::FixedTimestep);
+}
+
+unsigned int FramePacer::GetDroppedStepCount() {
+    return FramePacer::DroppedStepCount;
+}
+
+void FramePacer::ResetAccumulator() {
+    FramePacer::Accumulator = 0.0;
+    FramePacer::DroppedStepCount = 0;
+}
@@ -0,0 +1,189 @@
+#include <algorithm>
+
+#include "Mantaray/OpenGL/FrameStatistics.hpp"
+
+using namespace MR;
+
+FrameStats FrameStatistics::Current = FrameStats();
+std::mutex FrameStatistics::Mutex;
+std::vector<FrameStats> FrameStatistics::History = std::vector<FrameStats>(120);
+unsigned int FrameStatistics::HistorySize = 120;
+unsigned int FrameStatistics::HistoryHead = 0;
+unsigned int FrameStatistics::HistoryCount = 0;
+std::vector<unsigned long long> FrameStatistics::Histogram = std::vector<unsigned long long>(200);
+float FrameStatistics::HistogramBucketWidth = 0.00025f;
+unsigned long long FrameStatistics::HistogramTotal = 0;
+
+template<typename T>
+T percentileOf(std::vector<FrameStats>& frames, unsigned int count, T FrameStats::*field, float percentile) {
+    std::vector<T> values = std::vector<T>(count);
+    for (unsigned int i = 0; i < count; i++) {
+        values[i] = frames[i].*field;
+    }
+    unsigned int index = (unsigned int)(percentile * (count - 1) + .5f);
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+void FrameStatistics::EndFrame(float frameTime) {
+    FrameStatistics::Current.frameTime = frameTime;
+    FrameStatistics::History[FrameStatistics::HistoryHead] = FrameStatistics::Current;
+    FrameStatistics::HistoryHead = (FrameStatistics::HistoryHead + 1) % FrameStatistics::HistorySize;
+    if (FrameStatistics::HistoryCount < FrameStatistics::HistorySize) {
+        FrameStatistics::HistoryCount++;
+    }
+    unsigned int bucket = (unsigned int)std::min(std::max(frameTime, 0.f) / FrameStatistics::HistogramBucketWidth, (float)FrameStatistics::Histogram.size() - 1);
+    FrameStatistics::Histogram[bucket]++;
+    FrameStatistics::HistogramTotal++;
+    FrameStatistics::Current = FrameStats();
+}
+
+std::mutex& FrameStatistics::GetMutex() {
+    return FrameStatistics::Mutex;
+}
+
+void FrameStatistics::SetHistorySize(unsigned int frameCount) {
+    if (frameCount == 0) {
+        frameCount = 1;
+    }
+    FrameStatistics::History = std::vector<FrameStats>(frameCount);
+    FrameStatistics::HistorySize = frameCount;
+    FrameStatistics::HistoryHead = 0;
+    FrameStatistics::HistoryCount = 0;
+}
+
+unsigned int FrameStatistics::GetHistorySize() {
+    return FrameStatistics::HistorySize;
+}
+
+unsigned int FrameStatistics::GetRecordedFrameCount() {
+    return FrameStatistics::HistoryCount;
+}
+
+FrameStats& FrameStatistics::GetCurrent() {
+    return FrameStatistics::Current;
+}
+
+FrameStats FrameStatistics::GetLastFrame() {
+    if (FrameStatistics::HistoryCount == 0) {
+        return FrameStats();
+    }
+    unsigned int last = (FrameStatistics::HistoryHead + FrameStatistics::HistorySize - 1) % FrameStatistics::HistorySize;
+    return FrameStatistics::History[last];
+}
+
+FrameStats FrameStatistics::GetAverage() {
+    FrameStats average;
+    unsigned int count = FrameStatistics::HistoryCount;
+    if (count == 0) {
+        return average;
+    }
+
+    unsigned long long drawCalls = 0, vertices = 0, indices = 0, shaderSwitches = 0, textureBinds = 0;
+    unsigned long long framebufferSwitches = 0, vertexArrayBinds = 0, uniformUploads = 0, bufferBytes = 0, culled = 0;
+    double frameTime = 0, inputLatency = 0;
+    unsigned int latencyCount = 0;
+    for (unsigned int i = 0; i < count; i++) {
+        FrameStats& frame = FrameStatistics::History[i];
+        drawCalls += frame.drawCalls;
+        vertices += frame.verticesSubmitted;
+        indices += frame.indicesSubmitted;
+        shaderSwitches += frame.shaderSwitches;
+        textureBinds += frame.textureBinds;
+        framebufferSwitches += frame.framebufferSwitches;
+        vertexArrayBinds += frame.vertexArrayBinds;
+        uniformUploads += frame.uniformUploads;
+        bufferBytes += frame.bufferBytesUploaded;
+        culled += frame.culledObjects;
+        frameTime += frame.frameTime;
+        if (frame.inputLatency > 0.f) {
+            inputLatency += frame.inputLatency;
+            latencyCount++;
+        }
+    }
+
+    average.drawCalls = drawCalls / count;
+    average.verticesSubmitted = vertices / count;
+    average.indicesSubmitted = indices / count;
+    average.shaderSwitches = shaderSwitches / count;
+    average.textureBinds = textureBinds / count;
+    average.framebufferSwitches = framebufferSwitches / count;
+    average.vertexArrayBinds = vertexArrayBinds / count;
+    average.uniformUploads = uniformUploads / count;
+    average.bufferBytesUploaded = bufferBytes / count;
+    average.culledObjects = culled / count;
+    average.frameTime = (float)(frameTime / count);
+    average.inputLatency = (latencyCount > 0) ? (float)(inputLatency / latencyCount) : 0.f;
+    return average;
+}
+
+FrameStats FrameStatistics::GetPercentile(float percentile) {
+    FrameStats result;
+    unsigned int count = FrameStatistics::HistoryCount;
+    if (count == 0) {
+        return result;
+    }
+    percentile = std::min(std::max(percentile, 0.f), 1.f);
+
+    std::vector<FrameStats>& frames = FrameStatistics::History;
+    result.drawCalls = percentileOf(frames, count, &FrameStats::drawCalls, percentile);
+    result.verticesSubmitted = percentileOf(frames, count, &FrameStats::verticesSubmitted, percentile);
+    result.indicesSubmitted = percentileOf(frames, count, &FrameStats::indicesSubmitted, percentile);
+    result.shaderSwitches = percentileOf(frames, count, &FrameStats::shaderSwitches, percentile);
+    result.textureBinds = percentileOf(frames, count, &FrameStats::textureBinds, percentile);
+    result.framebufferSwitches = percentileOf(frames, count, &FrameStats::framebufferSwitches, percentile);
+    result.vertexArrayBinds = percentileOf(frames, count, &FrameStats::vertexArrayBinds, percentile);
+    result.uniformUploads = percentileOf(frames, count, &FrameStats::uniformUploads, percentile);
+    result.bufferBytesUploaded = percentileOf(frames, count, &FrameStats::bufferBytesUploaded, percentile);
+    result.culledObjects = percentileOf(frames, count, &FrameStats::culledObjects, percentile);
+    result.frameTime = percentileOf(frames, count, &FrameStats::frameTime, percentile);
+
+    // Like the average, frames without a latency sample are left out
+    std::vector<float> latencies;
+    for (unsigned int i = 0; i < count; i++) {
+        if (frames[i].inputLatency > 0.f) {
+            latencies.push_back(frames[i].inputLatency);
+        }
+    }
+    if (!latencies.empty()) {
+        unsigned int index = (unsigned int)(percentile * (latencies.size() - 1) + .5f);
+        std::nth_element(latencies.begin(), latencies.begin() + index, latencies.end());
+        result.inputLatency = latencies[index];
+    }
+    return result;
+}
+
+void FrameStatistics::SetHistogramBuckets(float bucketWidth, unsigned int bucketCount) {
+    FrameStatistics::HistogramBucketWidth = std::max(bucketWidth, 1e-6f);
+    FrameStatistics::Histogram = std::vector<unsigned long long>(std::max(bucketCount, 1u));
+    FrameStatistics::HistogramTotal = 0;
+}
+
+float FrameStatistics::GetHistogramBucketWidth() {
+    return FrameStatistics::HistogramBucketWidth;
+}
+
+const std::vector<unsigned long long>& FrameStatistics::GetFrameTimeHistogram() {
+    return FrameStatistics::Histogram;
+}
+
+float FrameStatistics::GetHistogramPercentile(float percentile) {
+    if (FrameStatistics::HistogramTotal == 0) {
+        return 0.f;
+    }
+    percentile = std::min(std::max(percentile, 0.f), 1.f);
+    unsigned long long target = (unsigned long long)(percentile * FrameStatistics::HistogramTotal + .5f);
+    unsigned long long counted = 0;
+    for (unsigned int i = 0; i < FrameStatistics::Histogram.size(); i++) {
+        counted += FrameStatistics::Histogram[i];
+        if (counted >= target && counted > 0) {
+            return (i + 1) * FrameStatistics::HistogramBucketWidth;
+        }
+    }
+    return FrameStatistics::Histogram.size() * FrameStatistics::HistogramBucketWidth;
+}
+
+void FrameStatistics::ResetHistogram() {
+    std::fill(FrameStatistics::Histogram.begin(), FrameStatistics::Histogram.end(), 0);
+    FrameStatistics::HistogramTotal = 0;
+}
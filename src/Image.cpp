@@ -1,14 +1,16 @@
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <utility>
 
 #include "Mantaray/Core/Image.hpp"
+#include "Mantaray/Core/ImageKernels.hpp"
 #include "Mantaray/OpenGL/Objects/Texture.hpp"
 #include "Mantaray/Core/FileSystem.hpp"
 
 using namespace MR;
 
 Image::Image() {
-    m_ImageData = new unsigned char[0];
 }
 
 Image::Image(std::string pathToImage, bool flipVertically) {
@@ -16,33 +18,71 @@ Image::Image(std::string pathToImage, bool flipVertically) {
 }
 
 Image::Image(std::vector<unsigned char>& imageData, unsigned int width, unsigned int height, int nrChannels) {
-    if (m_ImageData != nullptr)
+    allocate(Vector2u(width, height), nrChannels);
+    ImageKernels::FlipRows(&imageData[0], m_ImageData, width * nrChannels, height);
+}
+
+Image::Image(Vector2u size, int nrChannels) {
+    allocate(size, nrChannels);
+    memset(m_ImageData, 0, size.x * size.y * nrChannels);
+}
+
+Image::Image(const Image& other) {
+    allocate(other.m_Size, other.m_NrChannels);
+    memcpy(m_ImageData, other.m_ImageData, m_Size.x * m_Size.y * m_NrChannels);
+}
+
+Image::Image(Image&& other) {
+    m_ImageData = other.m_ImageData;
+    m_Size = other.m_Size;
+    m_NrChannels = other.m_NrChannels;
+    other.m_ImageData = nullptr;
+    other.m_Size = Vector2u(0, 0);
+    other.m_NrChannels = 0;
+}
+
+Image::~Image() {
+    unloadData();
+}
+
+Image& Image::operator=(const Image& other) {
+    if (this != &other) {
+        allocate(other.m_Size, other.m_NrChannels);
+        memcpy(m_ImageData, other.m_ImageData, m_Size.x * m_Size.y * m_NrChannels);
+    }
+    return *this;
+}
+
+Image& Image::operator=(Image&& other) {
+    if (this != &other) {
         unloadData();
-    m_ImageData = new unsigned char[width * height * nrChannels];
-
-    for (unsigned int y = 0; y < height; y++) {
-        for (unsigned int x = 0; x < width; x++) {
-            int targetArrayIndex = (x + width * y) * nrChannels;
-            int sourceArrayIndex = (x + width * (height - y - 1)) * nrChannels;
-            for (int i = 0; i < nrChannels; i++) {
-                m_ImageData[targetArrayIndex + i] = imageData[sourceArrayIndex + i];
-            }
-        }
+        m_ImageData = other.m_ImageData;
+        m_Size = other.m_Size;
+        m_NrChannels = other.m_NrChannels;
+        other.m_ImageData = nullptr;
+        other.m_Size = Vector2u(0, 0);
+        other.m_NrChannels = 0;
     }
-    
-    m_Size = Vector2u(width, height);
-    m_NrChannels = nrChannels;
+    return *this;
 }
 
-Image::~Image() {
+void Image::allocate(Vector2u size, int nrChannels) {
     unloadData();
+    // Allocated with malloc to match the stb_image buffers released in unloadData
+    m_ImageData = (unsigned char*)malloc(size.x * size.y * nrChannels);
+    m_Size = size;
+    m_NrChannels = nrChannels;
 }
 
-void Image::loadFromFile(std::string pathToImage, bool flipVertically) {
+void Image::loadFromFile(std::string pathToImage, bool flipVertically, bool absolutePath) {
     if (m_ImageData != nullptr)
         unloadData();
     int width, height;
-    FileSystem::ReadImage(pathToImage, m_ImageData, width, height, m_NrChannels, flipVertically);
+    if (!FileSystem::ReadImage(pathToImage, m_ImageData, width, height, m_NrChannels, flipVertically, absolutePath)) {
+        m_ImageData = nullptr;
+        m_NrChannels = 0;
+        return;
+    }
     m_Size = Vector2u(width, height);
 }
 
@@ -123,6 +163,201 @@ void Image::setPixel(Vector2u coordinate, Color color) {
     }
 }
 
+unsigned char* Image::getRow(unsigned int y) {
+    // Rows are stored bottom up for OpenGL, y is counted from the top like getPixel
+    return m_ImageData + (m_Size.y - y - 1) * m_Size.x * m_NrChannels;
+}
+
+void Image::forEachRow(std::function<void(unsigned int y, unsigned char* row)> callback) {
+    forEachRow(Rectangleu(0, 0, m_Size.x, m_Size.y), callback);
+}
+
+void Image::forEachRow(Rectangleu region, std::function<void(unsigned int y, unsigned char* row)> callback) {
+    unsigned int right = std::min(region.x() + region.width(), m_Size.x);
+    unsigned int bottom = std::min(region.y() + region.height(), m_Size.y);
+    if (region.x() >= right || region.y() >= bottom) {
+        return;
+    }
+    for (unsigned int y = region.y(); y < bottom; y++) {
+        callback(y, getRow(y) + region.x() * m_NrChannels);
+    }
+}
+
+void Image::fillRect(Rectangleu region, Color color) {
+    unsigned int right = std::min(region.x() + region.width(), m_Size.x);
+    unsigned int bottom = std::min(region.y() + region.height(), m_Size.y);
+    if (region.x() >= right || region.y() >= bottom) {
+        return;
+    }
+
+    unsigned char pixel[4] = { color.r, color.g, color.b, color.a };
+    unsigned int rowWidth = right - region.x();
+    unsigned int rowSize = rowWidth * m_NrChannels;
+    unsigned char* firstRow = getRow(region.y()) + region.x() * m_NrChannels;
+    ImageKernels::FillPixels(firstRow, pixel, m_NrChannels, rowWidth);
+    for (unsigned int y = region.y() + 1; y < bottom; y++) {
+        memcpy(getRow(y) + region.x() * m_NrChannels, firstRow, rowSize);
+    }
+}
+
+bool Image::clipRegion(Image& source, Rectanglei& sourceRegion, Vector2i& destination) {
+    if (destination.x < 0) {
+        sourceRegion.position.x -= destination.x;
+        sourceRegion.size.x += destination.x;
+        destination.x = 0;
+    }
+    if (destination.y < 0) {
+        sourceRegion.position.y -= destination.y;
+        sourceRegion.size.y += destination.y;
+        destination.y = 0;
+    }
+    if (sourceRegion.position.x < 0) {
+        destination.x -= sourceRegion.position.x;
+        sourceRegion.size.x += sourceRegion.position.x;
+        sourceRegion.position.x = 0;
+    }
+    if (sourceRegion.position.y < 0) {
+        destination.y -= sourceRegion.position.y;
+        sourceRegion.size.y += sourceRegion.position.y;
+        sourceRegion.position.y = 0;
+    }
+    sourceRegion.size.x = std::min(sourceRegion.size.x, std::min(source.getWidth() - sourceRegion.position.x, getWidth() - destination.x));
+    sourceRegion.size.y = std::min(sourceRegion.size.y, std::min(source.getHeight() - sourceRegion.position.y, getHeight() - destination.y));
+    return sourceRegion.size.x > 0 && sourceRegion.size.y > 0;
+}
+
+void Image::blit(Image& source, Vector2i destination) {
+    blit(source, Rectangleu(0, 0, source.m_Size.x, source.m_Size.y), destination);
+}
+
+void Image::blit(Image& source, Rectangleu sourceRegion, Vector2i destination) {
+    Rectanglei region = Rectanglei(sourceRegion.x(), sourceRegion.y(), sourceRegion.width(), sourceRegion.height());
+    if (&source == this || !clipRegion(source, region, destination)) {
+        return;
+    }
+
+    for (int y = 0; y < region.height(); y++) {
+        const unsigned char* sourceRow = source.getRow(region.y() + y) + region.x() * source.m_NrChannels;
+        unsigned char* destinationRow = getRow(destination.y + y) + destination.x * m_NrChannels;
+        if (source.m_NrChannels == m_NrChannels) {
+            memcpy(destinationRow, sourceRow, region.width() * m_NrChannels);
+        }
+        else {
+            ImageKernels::ConvertChannels(sourceRow, source.m_NrChannels, destinationRow, m_NrChannels, region.width());
+        }
+    }
+}
+
+void Image::blitAlphaBlended(Image& source, Vector2i destination) {
+    blitAlphaBlended(source, Rectangleu(0, 0, source.m_Size.x, source.m_Size.y), destination);
+}
+
+void Image::blitAlphaBlended(Image& source, Rectangleu sourceRegion, Vector2i destination) {
+    if (source.m_NrChannels != 4) {
+        // Without an alpha channel blending is a plain copy
+        blit(source, sourceRegion, destination);
+        return;
+    }
+    Rectanglei region = Rectanglei(sourceRegion.x(), sourceRegion.y(), sourceRegion.width(), sourceRegion.height());
+    if (&source == this || !clipRegion(source, region, destination)) {
+        return;
+    }
+
+    for (int y = 0; y < region.height(); y++) {
+        const unsigned char* sourceRow = source.getRow(region.y() + y) + region.x() * 4;
+        unsigned char* destinationRow = getRow(destination.y + y) + destination.x * m_NrChannels;
+        ImageKernels::BlendPixels(sourceRow, destinationRow, m_NrChannels, region.width());
+    }
+}
+
+void Image::flipVertically() {
+    ImageKernels::FlipRows(m_ImageData, m_ImageData, m_Size.x * m_NrChannels, m_Size.y);
+}
+
+void Image::flipVertically(Image& target) {
+    if (&target == this) {
+        flipVertically();
+        return;
+    }
+    target.allocate(m_Size, m_NrChannels);
+    ImageKernels::FlipRows(m_ImageData, target.m_ImageData, m_Size.x * m_NrChannels, m_Size.y);
+}
+
+void Image::convertChannels(int nrChannels) {
+    if (nrChannels == m_NrChannels) {
+        return;
+    }
+    Image converted;
+    convertChannels(nrChannels, converted);
+    *this = std::move(converted);
+}
+
+void Image::convertChannels(int nrChannels, Image& target) {
+    if (nrChannels < 1 || nrChannels > 4) {
+        return;
+    }
+    if (&target == this) {
+        convertChannels(nrChannels);
+        return;
+    }
+    target.allocate(m_Size, nrChannels);
+    ImageKernels::ConvertChannels(m_ImageData, m_NrChannels, target.m_ImageData, nrChannels, m_Size.x * m_Size.y);
+}
+
+void Image::premultiplyAlpha() {
+    ImageKernels::PremultiplyAlpha(m_ImageData, m_ImageData, m_NrChannels, m_Size.x * m_Size.y);
+}
+
+void Image::premultiplyAlpha(Image& target) {
+    if (&target != this) {
+        target.allocate(m_Size, m_NrChannels);
+    }
+    ImageKernels::PremultiplyAlpha(m_ImageData, target.m_ImageData, m_NrChannels, m_Size.x * m_Size.y);
+}
+
+void Image::swizzle(int r, int g, int b, int a) {
+    swizzle(r, g, b, a, *this);
+}
+
+void Image::swizzle(int r, int g, int b, int a, Image& target) {
+    const int mapping[4] = { r, g, b, a };
+    if (&target != this) {
+        target.allocate(m_Size, m_NrChannels);
+    }
+    ImageKernels::Swizzle(m_ImageData, target.m_ImageData, m_NrChannels, mapping, m_Size.x * m_Size.y);
+}
+
+void Image::resize(Vector2u size, ResampleFilter filter, bool gammaCorrect) {
+    Image resized;
+    resize(size, filter, resized, gammaCorrect);
+    *this = std::move(resized);
+}
+
+void Image::resize(Vector2u size, ResampleFilter filter, Image& target, bool gammaCorrect) {
+    if (&target == this) {
+        resize(size, filter, gammaCorrect);
+        return;
+    }
+    target.allocate(size, m_NrChannels);
+    ImageResampler::Resample(m_ImageData, m_Size, target.m_ImageData, size, m_NrChannels, filter, gammaCorrect);
+}
+
+void Image::generateMipChain(std::vector<Image>& mipChain, ResampleFilter filter, bool gammaCorrect) {
+    mipChain.clear();
+    if (m_ImageData == nullptr || m_Size.x == 0 || m_Size.y == 0) {
+        return;
+    }
+
+    mipChain.push_back(*this);
+    while (mipChain.back().m_Size.x > 1 || mipChain.back().m_Size.y > 1) {
+        Vector2u previousSize = mipChain.back().m_Size;
+        Vector2u size = Vector2u(std::max(previousSize.x / 2, 1u), std::max(previousSize.y / 2, 1u));
+        Image level;
+        mipChain.back().resize(size, filter, level, gammaCorrect);
+        mipChain.push_back(std::move(level));
+    }
+}
+
 int Image::getWidth() {
     return m_Size.x;
 }
@@ -130,3 +365,7 @@ int Image::getWidth() {
 int Image::getHeight() {
     return m_Size.y;
 }
+
+int Image::getNrChannels() {
+    return m_NrChannels;
+}
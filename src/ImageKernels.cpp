@@ -0,0 +1,603 @@
+#include <algorithm>
+#include <cstring>
+
+#include "Mantaray/Core/ImageKernels.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MR_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MR_KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace MR;
+
+#ifdef MR_KERNELS_X86
+struct CpuFeatures {
+    CpuFeatures() {
+        __builtin_cpu_init();
+        sse2 = __builtin_cpu_supports("sse2");
+        ssse3 = __builtin_cpu_supports("ssse3");
+        avx2 = __builtin_cpu_supports("avx2");
+    }
+    bool sse2, ssse3, avx2;
+};
+
+static const CpuFeatures& GetCpuFeatures() {
+    static const CpuFeatures features;
+    return features;
+}
+
+__attribute__((target("sse2")))
+static unsigned int swapRowsSSE2(unsigned char* a, unsigned char* b, unsigned int size) {
+    unsigned int i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i va = _mm_loadu_si128((__m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((__m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(a + i), vb);
+        _mm_storeu_si128((__m128i*)(b + i), va);
+    }
+    return i;
+}
+
+__attribute__((target("avx2")))
+static unsigned int swapRowsAVX2(unsigned char* a, unsigned char* b, unsigned int size) {
+    unsigned int i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i va = _mm256_loadu_si256((__m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((__m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(a + i), vb);
+        _mm256_storeu_si256((__m256i*)(b + i), va);
+    }
+    return i;
+}
+
+__attribute__((target("ssse3")))
+static unsigned int rgbToRgbaSSSE3(const unsigned char*& source, unsigned char*& destination, unsigned int pixelCount) {
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -128, 3, 4, 5, -128, 6, 7, 8, -128, 9, 10, 11, -128);
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    unsigned int done = 0;
+    // 16 byte loads over 12 byte groups, keep two pixels of slack so the load stays in bounds
+    for (; pixelCount - done >= 6; done += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)source);
+        _mm_storeu_si128((__m128i*)destination, _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), alpha));
+        source += 12;
+        destination += 16;
+    }
+    return done;
+}
+
+__attribute__((target("ssse3")))
+static unsigned int rgbaToRgbSSSE3(const unsigned char*& source, unsigned char*& destination, unsigned int pixelCount) {
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -128, -128, -128, -128);
+    unsigned int done = 0;
+    // 16 byte stores over 12 byte groups, keep two pixels of slack so the store stays in bounds
+    for (; pixelCount - done >= 6; done += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)source);
+        _mm_storeu_si128((__m128i*)destination, _mm_shuffle_epi8(pixels, shuffle));
+        source += 16;
+        destination += 12;
+    }
+    return done;
+}
+
+__attribute__((target("sse2")))
+static unsigned int greyToRgbaSSE2(const unsigned char*& source, unsigned char*& destination, unsigned int pixelCount) {
+    const __m128i opaque = _mm_set1_epi8((char)0xFF);
+    unsigned int done = 0;
+    for (; pixelCount - done >= 16; done += 16) {
+        __m128i grey = _mm_loadu_si128((const __m128i*)source);
+        __m128i greyGreyLow = _mm_unpacklo_epi8(grey, grey);
+        __m128i greyGreyHigh = _mm_unpackhi_epi8(grey, grey);
+        __m128i greyAlphaLow = _mm_unpacklo_epi8(grey, opaque);
+        __m128i greyAlphaHigh = _mm_unpackhi_epi8(grey, opaque);
+        _mm_storeu_si128((__m128i*)(destination +  0), _mm_unpacklo_epi16(greyGreyLow, greyAlphaLow));
+        _mm_storeu_si128((__m128i*)(destination + 16), _mm_unpackhi_epi16(greyGreyLow, greyAlphaLow));
+        _mm_storeu_si128((__m128i*)(destination + 32), _mm_unpacklo_epi16(greyGreyHigh, greyAlphaHigh));
+        _mm_storeu_si128((__m128i*)(destination + 48), _mm_unpackhi_epi16(greyGreyHigh, greyAlphaHigh));
+        source += 16;
+        destination += 64;
+    }
+    return done;
+}
+
+__attribute__((target("sse2")))
+static unsigned int rgbaToRedSSE2(const unsigned char*& source, unsigned char*& destination, unsigned int pixelCount) {
+    const __m128i redMask = _mm_set1_epi32(0xFF);
+    unsigned int done = 0;
+    for (; pixelCount - done >= 16; done += 16) {
+        __m128i p0 = _mm_and_si128(_mm_loadu_si128((const __m128i*)(source +  0)), redMask);
+        __m128i p1 = _mm_and_si128(_mm_loadu_si128((const __m128i*)(source + 16)), redMask);
+        __m128i p2 = _mm_and_si128(_mm_loadu_si128((const __m128i*)(source + 32)), redMask);
+        __m128i p3 = _mm_and_si128(_mm_loadu_si128((const __m128i*)(source + 48)), redMask);
+        __m128i low = _mm_packs_epi32(p0, p1);
+        __m128i high = _mm_packs_epi32(p2, p3);
+        _mm_storeu_si128((__m128i*)destination, _mm_packus_epi16(low, high));
+        source += 64;
+        destination += 16;
+    }
+    return done;
+}
+
+__attribute__((target("sse2")))
+static inline __m128i premultiplyHalfSSE2(__m128i pixels, __m128i alphaLaneMask, __m128i alphaLaneValue) {
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i factor = _mm_or_si128(_mm_andnot_si128(alphaLaneMask, alpha), alphaLaneValue);
+    __m128i product = _mm_add_epi16(_mm_mullo_epi16(pixels, factor), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(product, _mm_srli_epi16(product, 8)), 8);
+}
+
+__attribute__((target("sse2")))
+static unsigned int premultiplySSE2(const unsigned char*& source, unsigned char*& destination, unsigned int pixelCount) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaLaneMask = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+    const __m128i alphaLaneValue = _mm_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255);
+    unsigned int done = 0;
+    for (; pixelCount - done >= 4; done += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)source);
+        __m128i low = premultiplyHalfSSE2(_mm_unpacklo_epi8(pixels, zero), alphaLaneMask, alphaLaneValue);
+        __m128i high = premultiplyHalfSSE2(_mm_unpackhi_epi8(pixels, zero), alphaLaneMask, alphaLaneValue);
+        _mm_storeu_si128((__m128i*)destination, _mm_packus_epi16(low, high));
+        source += 16;
+        destination += 16;
+    }
+    return done;
+}
+
+__attribute__((target("avx2")))
+static inline __m256i premultiplyHalfAVX2(__m256i pixels, __m256i alphaLaneMask, __m256i alphaLaneValue) {
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m256i factor = _mm256_or_si256(_mm256_andnot_si256(alphaLaneMask, alpha), alphaLaneValue);
+    __m256i product = _mm256_add_epi16(_mm256_mullo_epi16(pixels, factor), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(product, _mm256_srli_epi16(product, 8)), 8);
+}
+
+__attribute__((target("avx2")))
+static unsigned int premultiplyAVX2(const unsigned char*& source, unsigned char*& destination, unsigned int pixelCount) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alphaLaneMask = _mm256_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1);
+    const __m256i alphaLaneValue = _mm256_setr_epi16(0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255);
+    unsigned int done = 0;
+    for (; pixelCount - done >= 8; done += 8) {
+        __m256i pixels = _mm256_loadu_si256((const __m256i*)source);
+        __m256i low = premultiplyHalfAVX2(_mm256_unpacklo_epi8(pixels, zero), alphaLaneMask, alphaLaneValue);
+        __m256i high = premultiplyHalfAVX2(_mm256_unpackhi_epi8(pixels, zero), alphaLaneMask, alphaLaneValue);
+        _mm256_storeu_si256((__m256i*)destination, _mm256_packus_epi16(low, high));
+        source += 32;
+        destination += 32;
+    }
+    return done;
+}
+
+__attribute__((target("sse2")))
+static inline __m128i divideBy255SSE2(__m128i value) {
+    value = _mm_add_epi16(value, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+}
+
+__attribute__((target("sse2")))
+static inline __m128i blendHalfSSE2(__m128i source, __m128i destination, __m128i alphaLaneMask) {
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(source, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i inverseAlpha = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+    // color = src * a + dst * (1 - a), alpha = a + dst_a * (1 - a)
+    __m128i sourceFactor = _mm_or_si128(_mm_andnot_si128(alphaLaneMask, alpha), _mm_and_si128(alphaLaneMask, _mm_set1_epi16(255)));
+    __m128i sum = _mm_add_epi16(
+        divideBy255SSE2(_mm_mullo_epi16(source, sourceFactor)),
+        divideBy255SSE2(_mm_mullo_epi16(destination, inverseAlpha))
+    );
+    return sum;
+}
+
+__attribute__((target("sse2")))
+static unsigned int blendSSE2(const unsigned char*& source, unsigned char*& destination, unsigned int pixelCount) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alphaLaneMask = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+    unsigned int done = 0;
+    for (; pixelCount - done >= 4; done += 4) {
+        __m128i sourcePixels = _mm_loadu_si128((const __m128i*)source);
+        __m128i destinationPixels = _mm_loadu_si128((const __m128i*)destination);
+        __m128i low = blendHalfSSE2(_mm_unpacklo_epi8(sourcePixels, zero), _mm_unpacklo_epi8(destinationPixels, zero), alphaLaneMask);
+        __m128i high = blendHalfSSE2(_mm_unpackhi_epi8(sourcePixels, zero), _mm_unpackhi_epi8(destinationPixels, zero), alphaLaneMask);
+        _mm_storeu_si128((__m128i*)destination, _mm_packus_epi16(low, high));
+        source += 16;
+        destination += 16;
+    }
+    return done;
+}
+
+static void buildSwizzleMasks(const int mapping[4], char shuffle[16], char fill[16]) {
+    for (int pixel = 0; pixel < 4; pixel++) {
+        for (int channel = 0; channel < 4; channel++) {
+            int index = pixel * 4 + channel;
+            int sourceChannel = mapping[channel];
+            shuffle[index] = (sourceChannel >= 0 && sourceChannel < 4) ? (char)(pixel * 4 + sourceChannel) : (char)-128;
+            fill[index] = (sourceChannel == -2) ? (char)0xFF : 0;
+        }
+    }
+}
+
+__attribute__((target("ssse3")))
+static unsigned int swizzleSSSE3(const unsigned char*& source, unsigned char*& destination, const int mapping[4], unsigned int pixelCount) {
+    char shuffleBytes[16], fillBytes[16];
+    buildSwizzleMasks(mapping, shuffleBytes, fillBytes);
+    const __m128i shuffle = _mm_loadu_si128((const __m128i*)shuffleBytes);
+    const __m128i fill = _mm_loadu_si128((const __m128i*)fillBytes);
+    unsigned int done = 0;
+    for (; pixelCount - done >= 4; done += 4) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)source);
+        _mm_storeu_si128((__m128i*)destination, _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), fill));
+        source += 16;
+        destination += 16;
+    }
+    return done;
+}
+
+__attribute__((target("avx2")))
+static unsigned int swizzleAVX2(const unsigned char*& source, unsigned char*& destination, const int mapping[4], unsigned int pixelCount) {
+    char shuffleBytes[16], fillBytes[16];
+    buildSwizzleMasks(mapping, shuffleBytes, fillBytes);
+    const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)shuffleBytes));
+    const __m256i fill = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)fillBytes));
+    unsigned int done = 0;
+    for (; pixelCount - done >= 8; done += 8) {
+        __m256i pixels = _mm256_loadu_si256((const __m256i*)source);
+        _mm256_storeu_si256((__m256i*)destination, _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle), fill));
+        source += 32;
+        destination += 32;
+    }
+    return done;
+}
+#endif
+
+#ifdef MR_KERNELS_NEON
+static unsigned int swapRowsNEON(unsigned char* a, unsigned char* b, unsigned int size) {
+    unsigned int i = 0;
+    for (; i + 16 <= size; i += 16) {
+        uint8x16_t va = vld1q_u8(a + i);
+        uint8x16_t vb = vld1q_u8(b + i);
+        vst1q_u8(a + i, vb);
+        vst1q_u8(b + i, va);
+    }
+    return i;
+}
+
+static unsigned int convertNEON(const unsigned char*& source, int sourceChannels, unsigned char*& destination, int destinationChannels, unsigned int pixelCount) {
+    unsigned int done = 0;
+    if (sourceChannels == 3 && destinationChannels == 4) {
+        for (; pixelCount - done >= 16; done += 16) {
+            uint8x16x3_t rgb = vld3q_u8(source);
+            uint8x16x4_t rgba;
+            rgba.val[0] = rgb.val[0];
+            rgba.val[1] = rgb.val[1];
+            rgba.val[2] = rgb.val[2];
+            rgba.val[3] = vdupq_n_u8(0xFF);
+            vst4q_u8(destination, rgba);
+            source += 48;
+            destination += 64;
+        }
+    }
+    else if (sourceChannels == 4 && destinationChannels == 3) {
+        for (; pixelCount - done >= 16; done += 16) {
+            uint8x16x4_t rgba = vld4q_u8(source);
+            uint8x16x3_t rgb;
+            rgb.val[0] = rgba.val[0];
+            rgb.val[1] = rgba.val[1];
+            rgb.val[2] = rgba.val[2];
+            vst3q_u8(destination, rgb);
+            source += 64;
+            destination += 48;
+        }
+    }
+    else if (sourceChannels == 1 && destinationChannels == 4) {
+        for (; pixelCount - done >= 16; done += 16) {
+            uint8x16_t grey = vld1q_u8(source);
+            uint8x16x4_t rgba;
+            rgba.val[0] = grey;
+            rgba.val[1] = grey;
+            rgba.val[2] = grey;
+            rgba.val[3] = vdupq_n_u8(0xFF);
+            vst4q_u8(destination, rgba);
+            source += 16;
+            destination += 64;
+        }
+    }
+    else if (sourceChannels == 4 && destinationChannels == 1) {
+        for (; pixelCount - done >= 16; done += 16) {
+            uint8x16x4_t rgba = vld4q_u8(source);
+            vst1q_u8(destination, rgba.val[0]);
+            source += 64;
+            destination += 16;
+        }
+    }
+    return done;
+}
+
+static inline uint8x8_t premultiplyChannelNEON(uint8x8_t channel, uint8x8_t alpha) {
+    uint16x8_t product = vmull_u8(channel, alpha);
+    return vrshrn_n_u16(vaddq_u16(product, vrshrq_n_u16(product, 8)), 8);
+}
+
+static unsigned int premultiplyNEON(const unsigned char*& source, unsigned char*& destination, unsigned int pixelCount) {
+    unsigned int done = 0;
+    for (; pixelCount - done >= 8; done += 8) {
+        uint8x8x4_t rgba = vld4_u8(source);
+        rgba.val[0] = premultiplyChannelNEON(rgba.val[0], rgba.val[3]);
+        rgba.val[1] = premultiplyChannelNEON(rgba.val[1], rgba.val[3]);
+        rgba.val[2] = premultiplyChannelNEON(rgba.val[2], rgba.val[3]);
+        vst4_u8(destination, rgba);
+        source += 32;
+        destination += 32;
+    }
+    return done;
+}
+
+static inline uint8x8_t divideBy255NEON(uint16x8_t value) {
+    return vrshrn_n_u16(vaddq_u16(value, vrshrq_n_u16(value, 8)), 8);
+}
+
+static unsigned int blendNEON(const unsigned char*& source, unsigned char*& destination, unsigned int pixelCount) {
+    unsigned int done = 0;
+    for (; pixelCount - done >= 8; done += 8) {
+        uint8x8x4_t sourcePixels = vld4_u8(source);
+        uint8x8x4_t destinationPixels = vld4_u8(destination);
+        uint8x8_t alpha = sourcePixels.val[3];
+        uint8x8_t inverseAlpha = vmvn_u8(alpha);
+        for (int channel = 0; channel < 3; channel++) {
+            destinationPixels.val[channel] = vadd_u8(
+                divideBy255NEON(vmull_u8(sourcePixels.val[channel], alpha)),
+                divideBy255NEON(vmull_u8(destinationPixels.val[channel], inverseAlpha))
+            );
+        }
+        destinationPixels.val[3] = vadd_u8(alpha, divideBy255NEON(vmull_u8(destinationPixels.val[3], inverseAlpha)));
+        vst4_u8(destination, destinationPixels);
+        source += 32;
+        destination += 32;
+    }
+    return done;
+}
+
+static unsigned int swizzleNEON(const unsigned char*& source, unsigned char*& destination, const int mapping[4], unsigned int pixelCount) {
+    unsigned int done = 0;
+    for (; pixelCount - done >= 16; done += 16) {
+        uint8x16x4_t input = vld4q_u8(source);
+        uint8x16x4_t output;
+        for (int channel = 0; channel < 4; channel++) {
+            int sourceChannel = mapping[channel];
+            if (sourceChannel >= 0 && sourceChannel < 4) {
+                output.val[channel] = input.val[sourceChannel];
+            }
+            else {
+                output.val[channel] = vdupq_n_u8(sourceChannel == -2 ? 0xFF : 0x00);
+            }
+        }
+        vst4q_u8(destination, output);
+        source += 64;
+        destination += 64;
+    }
+    return done;
+}
+#endif
+
+static void swapRows(unsigned char* a, unsigned char* b, unsigned int size) {
+    unsigned int i = 0;
+#ifdef MR_KERNELS_X86
+    if (GetCpuFeatures().avx2) {
+        i = swapRowsAVX2(a, b, size);
+    }
+    else if (GetCpuFeatures().sse2) {
+        i = swapRowsSSE2(a, b, size);
+    }
+#endif
+#ifdef MR_KERNELS_NEON
+    i = swapRowsNEON(a, b, size);
+#endif
+    for (; i < size; i++) {
+        unsigned char temp = a[i];
+        a[i] = b[i];
+        b[i] = temp;
+    }
+}
+
+template<int S, int D>
+static void convertScalar(const unsigned char* source, unsigned char* destination, unsigned int pixelCount) {
+    for (unsigned int i = 0; i < pixelCount; i++) {
+        unsigned char r = source[0];
+        unsigned char g = (S == 1) ? source[0] : source[1];
+        unsigned char b = (S == 1) ? source[0] : (S == 2) ? 0x00 : source[S > 2 ? 2 : 0];
+        unsigned char a = (S == 4) ? source[S > 3 ? 3 : 0] : 0xFF;
+
+        destination[0] = r;
+        if (D > 1) destination[D > 1 ? 1 : 0] = g;
+        if (D > 2) destination[D > 2 ? 2 : 0] = b;
+        if (D > 3) destination[D > 3 ? 3 : 0] = a;
+
+        source += S;
+        destination += D;
+    }
+}
+
+template<int S>
+static void convertScalarFrom(const unsigned char* source, unsigned char* destination, int destinationChannels, unsigned int pixelCount) {
+    switch (destinationChannels) {
+        case 1: convertScalar<S, 1>(source, destination, pixelCount); break;
+        case 2: convertScalar<S, 2>(source, destination, pixelCount); break;
+        case 3: convertScalar<S, 3>(source, destination, pixelCount); break;
+        case 4: convertScalar<S, 4>(source, destination, pixelCount); break;
+        default: break;
+    }
+}
+
+void ImageKernels::FlipRows(const unsigned char* source, unsigned char* destination, unsigned int rowSize, unsigned int rowCount) {
+    if (source == destination) {
+        for (unsigned int y = 0; y < rowCount / 2; y++) {
+            swapRows(destination + y * rowSize, destination + (rowCount - y - 1) * rowSize, rowSize);
+        }
+        return;
+    }
+    for (unsigned int y = 0; y < rowCount; y++) {
+        memcpy(destination + y * rowSize, source + (rowCount - y - 1) * rowSize, rowSize);
+    }
+}
+
+void ImageKernels::ConvertChannels(const unsigned char* source, int sourceChannels, unsigned char* destination, int destinationChannels, unsigned int pixelCount) {
+    if (sourceChannels < 1 || sourceChannels > 4 || destinationChannels < 1 || destinationChannels > 4) {
+        return;
+    }
+    if (sourceChannels == destinationChannels) {
+        memcpy(destination, source, pixelCount * sourceChannels);
+        return;
+    }
+
+    unsigned int done = 0;
+#ifdef MR_KERNELS_X86
+    if (sourceChannels == 3 && destinationChannels == 4 && GetCpuFeatures().ssse3) {
+        done = rgbToRgbaSSSE3(source, destination, pixelCount);
+    }
+    else if (sourceChannels == 4 && destinationChannels == 3 && GetCpuFeatures().ssse3) {
+        done = rgbaToRgbSSSE3(source, destination, pixelCount);
+    }
+    else if (sourceChannels == 1 && destinationChannels == 4 && GetCpuFeatures().sse2) {
+        done = greyToRgbaSSE2(source, destination, pixelCount);
+    }
+    else if (sourceChannels == 4 && destinationChannels == 1 && GetCpuFeatures().sse2) {
+        done = rgbaToRedSSE2(source, destination, pixelCount);
+    }
+#endif
+#ifdef MR_KERNELS_NEON
+    done = convertNEON(source, sourceChannels, destination, destinationChannels, pixelCount);
+#endif
+    pixelCount -= done;
+
+    switch (sourceChannels) {
+        case 1: convertScalarFrom<1>(source, destination, destinationChannels, pixelCount); break;
+        case 2: convertScalarFrom<2>(source, destination, destinationChannels, pixelCount); break;
+        case 3: convertScalarFrom<3>(source, destination, destinationChannels, pixelCount); break;
+        case 4: convertScalarFrom<4>(source, destination, destinationChannels, pixelCount); break;
+        default: break;
+    }
+}
+
+void ImageKernels::PremultiplyAlpha(const unsigned char* source, unsigned char* destination, int nrChannels, unsigned int pixelCount) {
+    if (nrChannels != 4) {
+        if (source != destination) {
+            memcpy(destination, source, pixelCount * nrChannels);
+        }
+        return;
+    }
+
+    unsigned int done = 0;
+#ifdef MR_KERNELS_X86
+    if (GetCpuFeatures().avx2) {
+        done = premultiplyAVX2(source, destination, pixelCount);
+    }
+    else if (GetCpuFeatures().sse2) {
+        done = premultiplySSE2(source, destination, pixelCount);
+    }
+#endif
+#ifdef MR_KERNELS_NEON
+    done = premultiplyNEON(source, destination, pixelCount);
+#endif
+
+    for (; done < pixelCount; done++) {
+        unsigned int alpha = source[3];
+        for (int channel = 0; channel < 3; channel++) {
+            unsigned int product = source[channel] * alpha + 128;
+            destination[channel] = (unsigned char)((product + (product >> 8)) >> 8);
+        }
+        destination[3] = (unsigned char)alpha;
+        source += 4;
+        destination += 4;
+    }
+}
+
+void ImageKernels::Swizzle(const unsigned char* source, unsigned char* destination, int nrChannels, const int mapping[4], unsigned int pixelCount) {
+    if (nrChannels < 1 || nrChannels > 4) {
+        return;
+    }
+
+    unsigned int done = 0;
+    if (nrChannels == 4) {
+#ifdef MR_KERNELS_X86
+        if (GetCpuFeatures().avx2) {
+            done = swizzleAVX2(source, destination, mapping, pixelCount);
+        }
+        else if (GetCpuFeatures().ssse3) {
+            done = swizzleSSSE3(source, destination, mapping, pixelCount);
+        }
+#endif
+#ifdef MR_KERNELS_NEON
+        done = swizzleNEON(source, destination, mapping, pixelCount);
+#endif
+    }
+
+    unsigned char pixel[4];
+    for (; done < pixelCount; done++) {
+        for (int channel = 0; channel < nrChannels; channel++) {
+            pixel[channel] = source[channel];
+        }
+        for (int channel = 0; channel < nrChannels; channel++) {
+            int sourceChannel = mapping[channel];
+            if (sourceChannel >= 0 && sourceChannel < nrChannels) {
+                destination[channel] = pixel[sourceChannel];
+            }
+            else {
+                destination[channel] = (sourceChannel == -2) ? 0xFF : 0x00;
+            }
+        }
+        source += nrChannels;
+        destination += nrChannels;
+    }
+}
+
+void ImageKernels::FillPixels(unsigned char* destination, const unsigned char* pixel, int nrChannels, unsigned int pixelCount) {
+    if (pixelCount == 0) {
+        return;
+    }
+    memcpy(destination, pixel, nrChannels);
+    // Double the filled span with each copy so the work ends up in a few large memcpy calls
+    unsigned int filled = 1;
+    while (filled < pixelCount) {
+        unsigned int count = std::min(filled, pixelCount - filled);
+        memcpy(destination + filled * nrChannels, destination, count * nrChannels);
+        filled += count;
+    }
+}
+
+void ImageKernels::BlendPixels(const unsigned char* source, unsigned char* destination, int destinationChannels, unsigned int pixelCount) {
+    if (destinationChannels < 1 || destinationChannels > 4) {
+        return;
+    }
+
+    unsigned int done = 0;
+    if (destinationChannels == 4) {
+#ifdef MR_KERNELS_X86
+        if (GetCpuFeatures().sse2) {
+            done = blendSSE2(source, destination, pixelCount);
+        }
+#endif
+#ifdef MR_KERNELS_NEON
+        done = blendNEON(source, destination, pixelCount);
+#endif
+    }
+
+    for (; done < pixelCount; done++) {
+        unsigned int alpha = source[3];
+        unsigned int inverseAlpha = 255 - alpha;
+        int colorChannels = (destinationChannels == 4) ? 3 : destinationChannels;
+        for (int channel = 0; channel < colorChannels; channel++) {
+            unsigned int sourcePart = source[channel] * alpha + 128;
+            unsigned int destinationPart = destination[channel] * inverseAlpha + 128;
+            unsigned int blended = ((sourcePart + (sourcePart >> 8)) >> 8) + ((destinationPart + (destinationPart >> 8)) >> 8);
+            destination[channel] = (unsigned char)std::min(blended, 255u);
+        }
+        if (destinationChannels == 4) {
+            unsigned int destinationPart = destination[3] * inverseAlpha + 128;
+            destination[3] = (unsigned char)std::min(alpha + ((destinationPart + (destinationPart >> 8)) >> 8), 255u);
+        }
+        source += 4;
+        destination += destinationChannels;
+    }
+}
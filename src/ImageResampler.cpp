@@ -0,0 +1,318 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "Mantaray/Core/ImageResampler.hpp"
+#include "Mantaray/Core/JobSystem.hpp"
+
+#if defined(__SSE2__)
+#define MR_RESAMPLER_SSE
+#include <emmintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MR_RESAMPLER_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace MR;
+
+struct FilterContribution {
+    int first = 0;
+    int count = 0;
+    unsigned int weightOffset = 0;
+};
+
+struct FilterKernel {
+    std::vector<FilterContribution> contributions;
+    std::vector<float> weights;
+};
+
+static const double Pi = 3.14159265358979323846;
+
+static double filterSupport(ResampleFilter filter) {
+    switch (filter) {
+        case FILTER_BOX: return .5;
+        case FILTER_BILINEAR: return 1.;
+        case FILTER_MITCHELL: return 2.;
+        case FILTER_LANCZOS: return 3.;
+        default: return 1.;
+    }
+}
+
+static double sinc(double x) {
+    if (x == 0.) {
+        return 1.;
+    }
+    x *= Pi;
+    return std::sin(x) / x;
+}
+
+static double filterWeight(ResampleFilter filter, double x) {
+    x = std::fabs(x);
+    switch (filter) {
+        case FILTER_BOX:
+            return (x < .5) ? 1. : 0.;
+        case FILTER_BILINEAR:
+            return (x < 1.) ? 1. - x : 0.;
+        case FILTER_MITCHELL: {
+            // Mitchell-Netravali with B = C = 1/3
+            const double B = 1. / 3., C = 1. / 3.;
+            if (x < 1.) {
+                return ((12 - 9 * B - 6 * C) * x * x * x + (-18 + 12 * B + 6 * C) * x * x + (6 - 2 * B)) / 6.;
+            }
+            if (x < 2.) {
+                return ((-B - 6 * C) * x * x * x + (6 * B + 30 * C) * x * x + (-12 * B - 48 * C) * x + (8 * B + 24 * C)) / 6.;
+            }
+            return 0.;
+        }
+        case FILTER_LANCZOS:
+            return (x < 3.) ? sinc(x) * sinc(x / 3.) : 0.;
+        default:
+            return 0.;
+    }
+}
+
+static FilterKernel buildKernel(unsigned int sourceSize, unsigned int destinationSize, ResampleFilter filter) {
+    FilterKernel kernel;
+    kernel.contributions.resize(destinationSize);
+
+    double scale = (double)sourceSize / (double)destinationSize;
+    double filterScale = std::max(scale, 1.);
+    double support = filterSupport(filter) * filterScale;
+
+    std::vector<float> taps;
+    for (unsigned int i = 0; i < destinationSize; i++) {
+        double center = (i + .5) * scale;
+        int left = (int)std::floor(center - support);
+        int right = (int)std::ceil(center + support);
+
+        // Taps outside the image are folded onto the edge pixels
+        int first = std::max(left, 0);
+        int last = std::min(right, (int)sourceSize - 1);
+        taps.assign(last - first + 1, 0.f);
+        double total = 0.;
+        for (int j = left; j <= right; j++) {
+            double weight = filterWeight(filter, (j + .5 - center) / filterScale);
+            if (weight == 0.) {
+                continue;
+            }
+            int clamped = std::min(std::max(j, first), last);
+            taps[clamped - first] += (float)weight;
+            total += weight;
+        }
+        if (total == 0.) {
+            int nearest = std::min(std::max((int)center, first), last);
+            taps[nearest - first] = 1.f;
+            total = 1.;
+        }
+
+        // Drop zero weight taps at both ends so the inner loops only touch contributing pixels
+        int begin = 0, end = (int)taps.size();
+        while (begin < end - 1 && taps[begin] == 0.f) {
+            begin++;
+        }
+        while (end - 1 > begin && taps[end - 1] == 0.f) {
+            end--;
+        }
+
+        FilterContribution& contribution = kernel.contributions[i];
+        contribution.first = first + begin;
+        contribution.count = end - begin;
+        contribution.weightOffset = kernel.weights.size();
+        for (int j = begin; j < end; j++) {
+            kernel.weights.push_back((float)(taps[j] / total));
+        }
+    }
+    return kernel;
+}
+
+static const float* srgbToLinearTable() {
+    static std::vector<float> table;
+    static bool initialized = [] {
+        table.resize(256);
+        for (int i = 0; i < 256; i++) {
+            double c = i / 255.;
+            table[i] = (float)((c <= .04045) ? c / 12.92 : std::pow((c + .055) / 1.055, 2.4));
+        }
+        return true;
+    }();
+    (void)initialized;
+    return &table[0];
+}
+
+static const unsigned char* linearToSrgbTable() {
+    static std::vector<unsigned char> table;
+    static bool initialized = [] {
+        table.resize(4096);
+        for (int i = 0; i < 4096; i++) {
+            double l = i / 4095.;
+            double c = (l <= .0031308) ? l * 12.92 : 1.055 * std::pow(l, 1. / 2.4) - .055;
+            table[i] = (unsigned char)std::min(std::max(c * 255. + .5, 0.), 255.);
+        }
+        return true;
+    }();
+    (void)initialized;
+    return &table[0];
+}
+
+template<typename Function>
+static void parallelRows(unsigned int rowCount, Function function) {
+    JobSystem::ParallelFor(rowCount, 16, function);
+}
+
+template<bool gammaCorrect>
+static void decodeRow(const unsigned char* source, float* destination, unsigned int width, int nrChannels, bool premultiply) {
+    const float* toLinear = srgbToLinearTable();
+    if (nrChannels == 4) {
+        for (unsigned int x = 0; x < width; x++, source += 4, destination += 4) {
+            // Alpha is never gamma encoded
+            float alpha = source[3] * (1.f / 255.f);
+            float factor = premultiply ? alpha : 1.f;
+            destination[0] = (gammaCorrect ? toLinear[source[0]] : source[0] * (1.f / 255.f)) * factor;
+            destination[1] = (gammaCorrect ? toLinear[source[1]] : source[1] * (1.f / 255.f)) * factor;
+            destination[2] = (gammaCorrect ? toLinear[source[2]] : source[2] * (1.f / 255.f)) * factor;
+            destination[3] = alpha;
+        }
+        return;
+    }
+    for (unsigned int x = 0; x < width; x++) {
+        const unsigned char* pixel = source + x * nrChannels;
+        float* out = destination + x * nrChannels;
+        for (int c = 0; c < nrChannels; c++) {
+            out[c] = gammaCorrect ? toLinear[pixel[c]] : pixel[c] * (1.f / 255.f);
+        }
+    }
+}
+
+template<bool gammaCorrect>
+static void encodeRow(float* source, unsigned char* destination, unsigned int width, int nrChannels, bool premultiplied) {
+    const unsigned char* toSrgb = linearToSrgbTable();
+    for (unsigned int x = 0; x < width; x++) {
+        float* pixel = source + x * nrChannels;
+        unsigned char* out = destination + x * nrChannels;
+        int colorChannels = (nrChannels == 4) ? 3 : nrChannels;
+        if (nrChannels == 4) {
+            float alpha = std::min(std::max(pixel[3], 0.f), 1.f);
+            if (premultiplied && alpha > 0.f) {
+                float inverseAlpha = 1.f / alpha;
+                pixel[0] *= inverseAlpha;
+                pixel[1] *= inverseAlpha;
+                pixel[2] *= inverseAlpha;
+            }
+            out[3] = (unsigned char)(alpha * 255.f + .5f);
+        }
+        for (int c = 0; c < colorChannels; c++) {
+            float value = std::min(std::max(pixel[c], 0.f), 1.f);
+            out[c] = gammaCorrect ? toSrgb[(int)(value * 4095.f + .5f)] : (unsigned char)(value * 255.f + .5f);
+        }
+    }
+}
+
+static void filterRowHorizontal(const float* source, float* destination, const FilterKernel& kernel, int nrChannels) {
+    unsigned int width = kernel.contributions.size();
+    for (unsigned int x = 0; x < width; x++) {
+        const FilterContribution& contribution = kernel.contributions[x];
+        const float* weights = &kernel.weights[contribution.weightOffset];
+        const float* pixel = source + contribution.first * nrChannels;
+        float* out = destination + x * nrChannels;
+#ifdef MR_RESAMPLER_SSE
+        if (nrChannels == 4) {
+            __m128 sum = _mm_setzero_ps();
+            for (int i = 0; i < contribution.count; i++) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(pixel + i * 4), _mm_set1_ps(weights[i])));
+            }
+            _mm_storeu_ps(out, sum);
+            continue;
+        }
+#endif
+#ifdef MR_RESAMPLER_NEON
+        if (nrChannels == 4) {
+            float32x4_t sum = vdupq_n_f32(0.f);
+            for (int i = 0; i < contribution.count; i++) {
+                sum = vmlaq_n_f32(sum, vld1q_f32(pixel + i * 4), weights[i]);
+            }
+            vst1q_f32(out, sum);
+            continue;
+        }
+#endif
+        for (int c = 0; c < nrChannels; c++) {
+            float sum = 0.f;
+            for (int i = 0; i < contribution.count; i++) {
+                sum += pixel[i * nrChannels + c] * weights[i];
+            }
+            out[c] = sum;
+        }
+    }
+}
+
+static void accumulateRow(float* destination, const float* source, float weight, unsigned int count) {
+    unsigned int i = 0;
+#ifdef MR_RESAMPLER_SSE
+    __m128 factor = _mm_set1_ps(weight);
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), _mm_mul_ps(_mm_loadu_ps(source + i), factor)));
+    }
+#endif
+#ifdef MR_RESAMPLER_NEON
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(destination + i, vmlaq_n_f32(vld1q_f32(destination + i), vld1q_f32(source + i), weight));
+    }
+#endif
+    for (; i < count; i++) {
+        destination[i] += source[i] * weight;
+    }
+}
+
+void ImageResampler::Resample(
+        const unsigned char* source, Vector2u sourceSize,
+        unsigned char* destination, Vector2u destinationSize,
+        int nrChannels, ResampleFilter filter,
+        bool gammaCorrect, bool alphaAware
+    ) {
+    if (sourceSize.x == 0 || sourceSize.y == 0 || destinationSize.x == 0 || destinationSize.y == 0) {
+        return;
+    }
+    // Two channel images are red/green, so only 4 channel images carry alpha
+    bool premultiply = alphaAware && nrChannels == 4;
+
+    FilterKernel horizontal = buildKernel(sourceSize.x, destinationSize.x, filter);
+    FilterKernel vertical = buildKernel(sourceSize.y, destinationSize.y, filter);
+
+    unsigned int sourceRowSize = sourceSize.x * nrChannels;
+    unsigned int intermediateRowSize = destinationSize.x * nrChannels;
+    // Every element is written by the horizontal pass, so the buffer is left uninitialized
+    std::unique_ptr<float[]> intermediate = std::unique_ptr<float[]>(new float[(size_t)intermediateRowSize * sourceSize.y]);
+
+    parallelRows(sourceSize.y, [&](unsigned int begin, unsigned int end) {
+        std::vector<float> decoded = std::vector<float>(sourceRowSize);
+        for (unsigned int y = begin; y < end; y++) {
+            if (gammaCorrect) {
+                decodeRow<true>(source + y * sourceRowSize, &decoded[0], sourceSize.x, nrChannels, premultiply);
+            }
+            else {
+                decodeRow<false>(source + y * sourceRowSize, &decoded[0], sourceSize.x, nrChannels, premultiply);
+            }
+            filterRowHorizontal(&decoded[0], &intermediate[y * intermediateRowSize], horizontal, nrChannels);
+        }
+    });
+
+    parallelRows(destinationSize.y, [&](unsigned int begin, unsigned int end) {
+        std::vector<float> row = std::vector<float>(intermediateRowSize);
+        for (unsigned int y = begin; y < end; y++) {
+            const FilterContribution& contribution = vertical.contributions[y];
+            const float* weights = &vertical.weights[contribution.weightOffset];
+            std::fill(row.begin(), row.end(), 0.f);
+            for (int i = 0; i < contribution.count; i++) {
+                accumulateRow(&row[0], &intermediate[(contribution.first + i) * intermediateRowSize], weights[i], intermediateRowSize);
+            }
+            if (gammaCorrect) {
+                encodeRow<true>(&row[0], destination + y * intermediateRowSize, destinationSize.x, nrChannels, premultiply);
+            }
+            else {
+                encodeRow<false>(&row[0], destination + y * intermediateRowSize, destinationSize.x, nrChannels, premultiply);
+            }
+        }
+    });
+}
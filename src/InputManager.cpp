@@ -5,17 +5,40 @@
 
 using namespace MR;
 
+// Callbacks installed before ours keep receiving their events
+static GLFWkeyfun PreviousKeyCallback = nullptr;
+static GLFWmousebuttonfun PreviousMouseButtonCallback = nullptr;
+static GLFWcursorposfun PreviousCursorPositionCallback = nullptr;
+static GLFWscrollfun PreviousScrollCallback = nullptr;
+
 GLFWwindow* InputManager::WindowHandle = nullptr;
 
-std::vector<int> InputManager::WatchedKeys = std::vector<int>();
-std::unordered_map<int, float> InputManager::WatchedKeysElapsedTime = std::unordered_map<int, float>();
-std::unordered_map<int, bool> InputManager::WatchedKeysDown = std::unordered_map<int, bool>();
-std::unordered_map<int, bool> InputManager::WatchedKeysUp = std::unordered_map<int, bool>();
+InputManager::ButtonState InputManager::KeyStates[MR_KEY_LAST + 1] = {};
+InputManager::ButtonState InputManager::MouseButtonStates[MR_MOUSE_BUTTON_LAST + 1] = {};
+uint32_t InputManager::Frame = 1;
+std::vector<InputEvent> InputManager::PendingEvents = std::vector<InputEvent>();
+std::vector<InputEvent> InputManager::FrameEvents = std::vector<InputEvent>();
+unsigned int InputManager::DroppedEventCount = 0;
+bool InputManager::LiveInputEnabled = true;
+Vector2d InputManager::MousePosition = Vector2d(0, 0);
 Vector2d InputManager::LastMousePosition = Vector2d(0, 0);
 Vector2d InputManager::DeltaMousePosition = Vector2d(0, 0);
+Vector2d InputManager::ScrollDelta = Vector2d(0, 0);
 
 void InputManager::SetWindowHandle(GLFWwindow* windowHandle) {
     InputManager::WindowHandle = windowHandle;
+    InputManager::PendingEvents.reserve(MaxEventsPerFrame);
+    InputManager::FrameEvents.reserve(MaxEventsPerFrame);
+    if (windowHandle == nullptr) {
+        return;
+    }
+
+    PreviousKeyCallback = glfwSetKeyCallback(windowHandle, InputManager::OnKey);
+    PreviousMouseButtonCallback = glfwSetMouseButtonCallback(windowHandle, InputManager::OnMouseButton);
+    PreviousCursorPositionCallback = glfwSetCursorPosCallback(windowHandle, InputManager::OnCursorPosition);
+    PreviousScrollCallback = glfwSetScrollCallback(windowHandle, InputManager::OnScroll);
+    glfwGetCursorPos(windowHandle, &InputManager::MousePosition.x, &InputManager::MousePosition.y);
+    InputManager::LastMousePosition = InputManager::MousePosition;
 }
 
 GLFWwindow* InputManager::GetWindowHandle() {
@@ -26,69 +49,52 @@ GLFWwindow* InputManager::GetWindowHandle() {
 }
 
 void InputManager::Update(float deltaTime) {
-    GLFWwindow* windowHandle = InputManager::GetWindowHandle();
-    if (windowHandle == nullptr)
-        return;
-    
-    for (unsigned int i = 0; i < InputManager::WatchedKeys.size(); i++) {
-        int keyCode = InputManager::WatchedKeys[i];
-        if (keyCode < 8) {
-            if (InputManager::GetMouseButton(keyCode)) {
-                InputManager::WatchedKeysDown[keyCode] = (InputManager::WatchedKeysElapsedTime[keyCode] > 0);
-                InputManager::WatchedKeysElapsedTime[keyCode] = 0;
-                InputManager::WatchedKeysUp[keyCode] = false;
-            } else {
-                InputManager::WatchedKeysUp[keyCode] = (InputManager::WatchedKeysElapsedTime[keyCode] == 0);
-                InputManager::WatchedKeysElapsedTime[keyCode] += deltaTime;
-                InputManager::WatchedKeysDown[keyCode] = false;
-            }
-            continue;
-        }
-        if (InputManager::GetKey(keyCode)) {
-            InputManager::WatchedKeysDown[keyCode] = (InputManager::WatchedKeysElapsedTime[keyCode] > 0);
-            InputManager::WatchedKeysElapsedTime[keyCode] = 0;
-            InputManager::WatchedKeysUp[keyCode] = false;
-        } else {
-            InputManager::WatchedKeysUp[keyCode] = (InputManager::WatchedKeysElapsedTime[keyCode] == 0);
-            InputManager::WatchedKeysElapsedTime[keyCode] += deltaTime;
-            InputManager::WatchedKeysDown[keyCode] = false;
-        }
+    (void)deltaTime;
+    InputManager::Frame++;
+    InputManager::ScrollDelta = Vector2d(0, 0);
+    // Swapping keeps both reserved buffers, no allocation happens per frame
+    InputManager::FrameEvents.swap(InputManager::PendingEvents);
+    InputManager::PendingEvents.clear();
+    for (const InputEvent& event : InputManager::FrameEvents) {
+        InputManager::ApplyEvent(event);
     }
 
-    Vector2d currentMousePosition;
-    GetMousePosition(currentMousePosition);
-    InputManager::DeltaMousePosition = currentMousePosition - InputManager::LastMousePosition;
-    GetMousePosition(InputManager::LastMousePosition); 
+    InputManager::DeltaMousePosition = InputManager::MousePosition - InputManager::LastMousePosition;
+    InputManager::LastMousePosition = InputManager::MousePosition;
 }
 
 void InputManager::AddKeyToWatch(int keyCode) {
-    InputManager::WatchedKeys.push_back(keyCode);
-
-    InputManager::WatchedKeysElapsedTime[keyCode] =  1.0f;
-    InputManager::WatchedKeysDown[keyCode] =  false;
-    InputManager::WatchedKeysUp[keyCode] =  false;
+    (void)keyCode;
 }
 
 bool InputManager::GetKey(int keyCode) {
-    return (glfwGetKey(InputManager::GetWindowHandle(), keyCode) == GLFW_PRESS);
+    ButtonState* state = InputManager::FindState(keyCode);
+    return state != nullptr && state->held;
 }
 
 bool InputManager::GetKeyDown(int keyCode) {
-    return InputManager::WatchedKeysDown[keyCode];
+    ButtonState* state = InputManager::FindState(keyCode);
+    return state != nullptr && state->pressedFrame == InputManager::Frame;
 }
 
 bool InputManager::GetKeyUp(int keyCode) {
-    return InputManager::WatchedKeysUp[keyCode];
+    ButtonState* state = InputManager::FindState(keyCode);
+    return state != nullptr && state->releasedFrame == InputManager::Frame;
 }
 
 void InputManager::GetMousePosition(Vector2d &mousePos) {
-    glfwGetCursorPos(InputManager::GetWindowHandle(), &mousePos.x, &mousePos.y);
+    mousePos = InputManager::MousePosition;
 }
 
 Vector2d InputManager::GetMousePosition() {
-    Vector2d mousePos;
-    GetMousePosition(mousePos);
-    return mousePos;
+    return InputManager::MousePosition;
+}
+
+void InputManager::LatchMousePosition() {
+    if (!InputManager::LiveInputEnabled || InputManager::WindowHandle == nullptr) {
+        return;
+    }
+    glfwGetCursorPos(InputManager::WindowHandle, &InputManager::MousePosition.x, &InputManager::MousePosition.y);
 }
 
 void InputManager::GetMouseDelta(Vector2d &mouseDelta) {
@@ -100,8 +106,29 @@ Vector2d InputManager::GetMouseDelta() {
     return InputManager::DeltaMousePosition;
 }
 
+Vector2d InputManager::GetScrollDelta() {
+    return InputManager::ScrollDelta;
+}
+
 bool InputManager::GetMouseButton(int mouseButtonCode) {
-    return (glfwGetMouseButton(InputManager::GetWindowHandle(), mouseButtonCode) == GLFW_PRESS);
+    if (mouseButtonCode < 0 || mouseButtonCode > MR_MOUSE_BUTTON_LAST) {
+        return false;
+    }
+    return InputManager::MouseButtonStates[mouseButtonCode].held;
+}
+
+bool InputManager::GetMouseButtonDown(int mouseButtonCode) {
+    if (mouseButtonCode < 0 || mouseButtonCode > MR_MOUSE_BUTTON_LAST) {
+        return false;
+    }
+    return InputManager::MouseButtonStates[mouseButtonCode].pressedFrame == InputManager::Frame;
+}
+
+bool InputManager::GetMouseButtonUp(int mouseButtonCode) {
+    if (mouseButtonCode < 0 || mouseButtonCode > MR_MOUSE_BUTTON_LAST) {
+        return false;
+    }
+    return InputManager::MouseButtonStates[mouseButtonCode].releasedFrame == InputManager::Frame;
 }
 
 void InputManager::SetCursorMode(CursorMode cursorMode) {
@@ -120,3 +147,154 @@ void InputManager::SetCursorMode(CursorMode cursorMode) {
             glfwSetInputMode(windowHandle, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     }
 }
+
+const std::vector<InputEvent>& InputManager::GetEvents() {
+    return InputManager::FrameEvents;
+}
+
+unsigned int InputManager::GetDroppedEventCount() {
+    return InputManager::DroppedEventCount;
+}
+
+void InputManager::InjectEvent(const InputEvent& event) {
+    InputManager::QueueEvent(event);
+}
+
+void InputManager::SetLiveInputEnabled(bool enabled) {
+    InputManager::LiveInputEnabled = enabled;
+}
+
+bool InputManager::IsLiveInputEnabled() {
+    return InputManager::LiveInputEnabled;
+}
+
+void InputManager::ResetState(Vector2d mousePosition) {
+    for (ButtonState& state : InputManager::KeyStates) {
+        state = ButtonState();
+    }
+    for (ButtonState& state : InputManager::MouseButtonStates) {
+        state = ButtonState();
+    }
+    InputManager::PendingEvents.clear();
+    InputManager::FrameEvents.clear();
+    InputManager::MousePosition = mousePosition;
+    InputManager::LastMousePosition = mousePosition;
+    InputManager::DeltaMousePosition = Vector2d(0, 0);
+    InputManager::ScrollDelta = Vector2d(0, 0);
+}
+
+void InputManager::QueueLiveEvent(const InputEvent& event) {
+    if (InputManager::LiveInputEnabled) {
+        InputManager::QueueEvent(event);
+    }
+}
+
+void InputManager::QueueEvent(const InputEvent& event) {
+    if (InputManager::PendingEvents.size() >= MaxEventsPerFrame) {
+        if (InputManager::DroppedEventCount++ == 0) {
+            Logger::Log("InputManager", "Event queue is full, dropping input events", Logger::LOG_WARNING);
+        }
+        return;
+    }
+    InputManager::PendingEvents.push_back(event);
+}
+
+void InputManager::ApplyEvent(const InputEvent& event) {
+    switch (event.type) {
+        case InputEvent::EVENT_KEY:
+        case InputEvent::EVENT_MOUSE_BUTTON: {
+            ButtonState* state = (event.type == InputEvent::EVENT_KEY) ?
+                &InputManager::KeyStates[event.code] : &InputManager::MouseButtonStates[event.code];
+            if (event.action == InputEvent::ACTION_PRESS) {
+                state->held = true;
+                state->pressedFrame = InputManager::Frame;
+            }
+            else if (event.action == InputEvent::ACTION_RELEASE) {
+                state->held = false;
+                state->releasedFrame = InputManager::Frame;
+            }
+            break;
+        }
+        case InputEvent::EVENT_CURSOR:
+            InputManager::MousePosition = event.value;
+            break;
+        case InputEvent::EVENT_SCROLL:
+            InputManager::ScrollDelta = InputManager::ScrollDelta + event.value;
+            break;
+    }
+}
+
+// Codes below 8 are mouse buttons, like they were for AddKeyToWatch
+InputManager::ButtonState* InputManager::FindState(int code) {
+    if (code >= 0 && code <= MR_MOUSE_BUTTON_LAST) {
+        return &InputManager::MouseButtonStates[code];
+    }
+    if (code > MR_MOUSE_BUTTON_LAST && code <= MR_KEY_LAST) {
+        return &InputManager::KeyStates[code];
+    }
+    return nullptr;
+}
+
+void InputManager::OnKey(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (PreviousKeyCallback != nullptr) {
+        PreviousKeyCallback(window, key, scancode, action, mods);
+    }
+    if (key < 0 || key > MR_KEY_LAST) {
+        return;
+    }
+    InputEvent event;
+    event.type = InputEvent::EVENT_KEY;
+    event.code = key;
+    event.action = (InputEvent::Action)action;
+    event.mods = mods;
+    event.time = glfwGetTime();
+    InputManager::QueueLiveEvent(event);
+}
+
+void InputManager::OnMouseButton(GLFWwindow* window, int button, int action, int mods) {
+    if (PreviousMouseButtonCallback != nullptr) {
+        PreviousMouseButtonCallback(window, button, action, mods);
+    }
+    if (button < 0 || button > MR_MOUSE_BUTTON_LAST) {
+        return;
+    }
+    InputEvent event;
+    event.type = InputEvent::EVENT_MOUSE_BUTTON;
+    event.code = button;
+    event.action = (InputEvent::Action)action;
+    event.mods = mods;
+    event.time = glfwGetTime();
+    InputManager::QueueLiveEvent(event);
+}
+
+void InputManager::OnCursorPosition(GLFWwindow* window, double x, double y) {
+    if (PreviousCursorPositionCallback != nullptr) {
+        PreviousCursorPositionCallback(window, x, y);
+    }
+    if (!InputManager::LiveInputEnabled) {
+        return;
+    }
+    // Consecutive moves collapse into one event, high rate mice would otherwise fill the queue
+    std::vector<InputEvent>& pending = InputManager::PendingEvents;
+    if (!pending.empty() && pending.back().type == InputEvent::EVENT_CURSOR) {
+        pending.back().value = Vector2d(x, y);
+        pending.back().time = glfwGetTime();
+        return;
+    }
+    InputEvent event;
+    event.type = InputEvent::EVENT_CURSOR;
+    event.value = Vector2d(x, y);
+    event.time = glfwGetTime();
+    InputManager::QueueLiveEvent(event);
+}
+
+void InputManager::OnScroll(GLFWwindow* window, double x, double y) {
+    if (PreviousScrollCallback != nullptr) {
+        PreviousScrollCallback(window, x, y);
+    }
+    InputEvent event;
+    event.type = InputEvent::EVENT_SCROLL;
+    event.value = Vector2d(x, y);
+    event.time = glfwGetTime();
+    InputManager::QueueLiveEvent(event);
+}
@@ -0,0 +1,272 @@
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+#include "Mantaray/Core/InputRecording.hpp"
+#include "Mantaray/Core/Logger.hpp"
+
+using namespace MR;
+
+static const char RecordingMagic[4] = {'M', 'R', 'I', 'R'};
+// Recorded frames are written out in chunks of this size
+static const size_t FlushSize = 64 * 1024;
+
+template <typename T>
+static void append(std::vector<unsigned char>& buffer, const T& value) {
+    const unsigned char* bytes = (const unsigned char*)&value;
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+static bool extract(const std::vector<unsigned char>& buffer, size_t& offset, T& value) {
+    if (buffer.size() - offset < sizeof(T)) {
+        return false;
+    }
+    memcpy(&value, &buffer[offset], sizeof(T));
+    offset += sizeof(T);
+    return true;
+}
+
+static void stopAtExit() {
+    InputRecording::StopRecording();
+}
+
+static bool hasCode(InputEvent::Type type) {
+    return type == InputEvent::EVENT_KEY || type == InputEvent::EVENT_MOUSE_BUTTON;
+}
+
+bool InputRecording::Recording = false;
+bool InputRecording::Replaying = false;
+bool InputRecording::Unthrottled = false;
+bool InputRecording::CloseWhenDone = true;
+std::ofstream InputRecording::File;
+std::vector<unsigned char> InputRecording::Buffer = std::vector<unsigned char>();
+size_t InputRecording::ReadOffset = 0;
+uint32_t InputRecording::Seed = 0;
+unsigned int InputRecording::FrameIndex = 0;
+unsigned int InputRecording::FrameCount = 0;
+double InputRecording::Time = 0.0;
+std::vector<InputEvent> InputRecording::InitialEvents = std::vector<InputEvent>();
+
+bool InputRecording::StartRecording(std::string path, uint32_t seed) {
+    StopRecording();
+    StopReplay();
+    InputRecording::File.open(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!InputRecording::File) {
+        Logger::Log("InputRecording", "Could not open file for writing: " + path, Logger::LOG_ERROR);
+        return false;
+    }
+
+    Header header;
+    memcpy(header.magic, RecordingMagic, sizeof(RecordingMagic));
+    header.version = Version;
+    header.seed = seed;
+    header.frameCount = 0;
+    Vector2d mousePosition = InputManager::GetMousePosition();
+    header.mouseX = mousePosition.x;
+    header.mouseY = mousePosition.y;
+    InputRecording::File.write((const char*)&header, sizeof(Header));
+
+    // Keys already held would never see their press on replay, so it is recorded with the first frame
+    InputRecording::InitialEvents.clear();
+    for (int code = 0; code <= MR_KEY_LAST; code++) {
+        if (InputManager::GetKey(code)) {
+            InputEvent event;
+            event.type = (code <= MR_MOUSE_BUTTON_LAST) ? InputEvent::EVENT_MOUSE_BUTTON : InputEvent::EVENT_KEY;
+            event.code = code;
+            event.action = InputEvent::ACTION_PRESS;
+            InputRecording::InitialEvents.push_back(event);
+        }
+    }
+
+    InputRecording::Buffer.clear();
+    InputRecording::Seed = seed;
+    InputRecording::FrameIndex = 0;
+    InputRecording::FrameCount = 0;
+    InputRecording::Time = 0.0;
+    InputRecording::Recording = true;
+    // The frame count in the header is only written on stop, applications rarely stop explicitly
+    static bool registeredExit = false;
+    if (!registeredExit) {
+        registeredExit = true;
+        atexit(stopAtExit);
+    }
+    return true;
+}
+
+void InputRecording::StopRecording() {
+    if (!InputRecording::Recording) {
+        return;
+    }
+    FlushBuffer();
+    InputRecording::File.seekp(offsetof(Header, frameCount));
+    InputRecording::File.write((const char*)&InputRecording::FrameCount, sizeof(uint32_t));
+    if (!InputRecording::File) {
+        Logger::Log("InputRecording", "Could not write the input recording", Logger::LOG_ERROR);
+    }
+    InputRecording::File.close();
+    InputRecording::Recording = false;
+}
+
+bool InputRecording::IsRecording() {
+    return InputRecording::Recording;
+}
+
+bool InputRecording::StartReplay(std::string path, bool unthrottled, bool closeWhenDone) {
+    StopRecording();
+    StopReplay();
+    std::ifstream file(path.c_str(), std::ios::binary);
+    if (!file) {
+        Logger::Log("InputRecording", "Could not open file: " + path, Logger::LOG_ERROR);
+        return false;
+    }
+    InputRecording::Buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    Header header;
+    InputRecording::ReadOffset = 0;
+    if (!extract(InputRecording::Buffer, InputRecording::ReadOffset, header) ||
+        memcmp(header.magic, RecordingMagic, sizeof(RecordingMagic)) != 0 || header.version != Version) {
+        Logger::Log("InputRecording", "Not a supported input recording: " + path, Logger::LOG_ERROR);
+        InputRecording::Buffer.clear();
+        return false;
+    }
+
+    InputManager::ResetState(Vector2d(header.mouseX, header.mouseY));
+    InputManager::SetLiveInputEnabled(false);
+    InputRecording::Seed = header.seed;
+    InputRecording::FrameIndex = 0;
+    InputRecording::FrameCount = header.frameCount;
+    InputRecording::Time = 0.0;
+    InputRecording::Unthrottled = unthrottled;
+    InputRecording::CloseWhenDone = closeWhenDone;
+    InputRecording::Replaying = true;
+    return true;
+}
+
+void InputRecording::StopReplay() {
+    if (!InputRecording::Replaying) {
+        return;
+    }
+    InputManager::SetLiveInputEnabled(true);
+    InputRecording::Buffer.clear();
+    InputRecording::Replaying = false;
+}
+
+bool InputRecording::IsReplaying() {
+    return InputRecording::Replaying;
+}
+
+bool InputRecording::IsUnthrottled() {
+    return InputRecording::Replaying && InputRecording::Unthrottled;
+}
+
+bool InputRecording::ShouldCloseWhenDone() {
+    return InputRecording::CloseWhenDone;
+}
+
+uint32_t InputRecording::GetSeed() {
+    return InputRecording::Seed;
+}
+
+double InputRecording::GetTime() {
+    return InputRecording::Time;
+}
+
+unsigned int InputRecording::GetFrameIndex() {
+    return InputRecording::FrameIndex;
+}
+
+unsigned int InputRecording::GetFrameCount() {
+    return InputRecording::FrameCount;
+}
+
+void InputRecording::RecordFrame(float deltaTime, const std::vector<InputEvent>& events, double updateTime) {
+    if (!InputRecording::Recording) {
+        return;
+    }
+    std::vector<unsigned char>& buffer = InputRecording::Buffer;
+    const std::vector<InputEvent>& initial = InputRecording::InitialEvents;
+    uint16_t eventCount = initial.size() + events.size();
+    append(buffer, deltaTime);
+    append(buffer, eventCount);
+
+    for (unsigned int i = 0; i < eventCount; i++) {
+        bool isInitial = i < initial.size();
+        const InputEvent& event = isInitial ? initial[i] : events[i - initial.size()];
+        append(buffer, (uint8_t)event.type);
+        append(buffer, (uint8_t)event.action);
+        append(buffer, (uint8_t)event.mods);
+        // Stored as the age at the update, so a replay can place the event on its virtual clock
+        append(buffer, isInitial ? 0.f : (float)(updateTime - event.time));
+        if (hasCode(event.type)) {
+            append(buffer, (uint16_t)event.code);
+        }
+        else {
+            append(buffer, event.value.x);
+            append(buffer, event.value.y);
+        }
+    }
+    InputRecording::InitialEvents.clear();
+
+    InputRecording::Time += deltaTime;
+    InputRecording::FrameIndex++;
+    InputRecording::FrameCount++;
+    if (buffer.size() >= FlushSize) {
+        FlushBuffer();
+    }
+}
+
+bool InputRecording::ReplayFrame(float& deltaTime) {
+    if (!InputRecording::Replaying) {
+        return false;
+    }
+    const std::vector<unsigned char>& buffer = InputRecording::Buffer;
+    size_t& offset = InputRecording::ReadOffset;
+    float frameDelta;
+    uint16_t eventCount;
+    bool knownLength = InputRecording::FrameCount != 0;
+    if ((knownLength && InputRecording::FrameIndex >= InputRecording::FrameCount) || !extract(buffer, offset, frameDelta) || !extract(buffer, offset, eventCount)) {
+        return false;
+    }
+    InputRecording::Time += frameDelta;
+
+    for (unsigned int i = 0; i < eventCount; i++) {
+        uint8_t type, action, mods;
+        float age;
+        InputEvent event;
+        bool valid = extract(buffer, offset, type) && extract(buffer, offset, action) && extract(buffer, offset, mods) && extract(buffer, offset, age);
+        if (valid) {
+            event.type = (InputEvent::Type)type;
+            event.action = (InputEvent::Action)action;
+            event.mods = mods;
+            event.time = InputRecording::Time - age;
+            if (hasCode(event.type)) {
+                uint16_t code;
+                valid = extract(buffer, offset, code);
+                if (valid) {
+                    event.code = code;
+                }
+            }
+            else {
+                valid = extract(buffer, offset, event.value.x) && extract(buffer, offset, event.value.y);
+            }
+        }
+        if (!valid) {
+            Logger::Log("InputRecording", "Input recording is truncated", Logger::LOG_WARNING);
+            return false;
+        }
+        InputManager::InjectEvent(event);
+    }
+
+    deltaTime = frameDelta;
+    InputRecording::FrameIndex++;
+    return true;
+}
+
+void InputRecording::FlushBuffer() {
+    if (!InputRecording::Buffer.empty()) {
+        InputRecording::File.write((const char*)&InputRecording::Buffer[0], InputRecording::Buffer.size());
+        InputRecording::Buffer.clear();
+    }
+}
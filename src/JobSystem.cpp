@@ -0,0 +1,374 @@
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <thread>
+
+#include "Mantaray/Core/JobSystem.hpp"
+#include "Mantaray/Core/Logger.hpp"
+
+using namespace MR;
+
+static const unsigned int DequeMask = JobSystem::DequeCapacity - 1;
+// Failed attempts to find work before an idle worker goes to sleep
+static const unsigned int SpinCount = 64;
+
+// Job stored field by field in relaxed atomics, so a copy racing with an overwrite is not a data race
+struct JobSlot {
+    std::atomic<JobFunction> function;
+    std::atomic<void*> data;
+    std::atomic<unsigned int> begin;
+    std::atomic<unsigned int> end;
+    std::atomic<unsigned int> grain;
+    std::atomic<JobCounter*> counter;
+
+    void store(const Job& job) {
+        function.store(job.function, std::memory_order_relaxed);
+        data.store(job.data, std::memory_order_relaxed);
+        begin.store(job.begin, std::memory_order_relaxed);
+        end.store(job.end, std::memory_order_relaxed);
+        grain.store(job.grain, std::memory_order_relaxed);
+        counter.store(job.counter, std::memory_order_relaxed);
+    }
+
+    void load(Job& job) const {
+        job.function = function.load(std::memory_order_relaxed);
+        job.data = data.load(std::memory_order_relaxed);
+        job.begin = begin.load(std::memory_order_relaxed);
+        job.end = end.load(std::memory_order_relaxed);
+        job.grain = grain.load(std::memory_order_relaxed);
+        job.counter = counter.load(std::memory_order_relaxed);
+    }
+};
+
+// Chase-Lev deque with the memory orderings from "Correct and Efficient Work-Stealing for Weak
+// Memory Models" (Le et al.). Jobs are stored in place and a thief copies its job before claiming
+// it. A thief that read top before the deque wrapped around can copy a slot while the owner
+// overwrites it, its claim then fails because top has moved on and the torn copy is dropped.
+struct WorkDeque {
+    std::atomic<long long> top{0};
+    std::atomic<long long> bottom{0};
+    JobSlot jobs[JobSystem::DequeCapacity];
+
+    bool push(const Job& job) {
+        long long b = bottom.load(std::memory_order_relaxed);
+        long long t = top.load(std::memory_order_acquire);
+        if (b - t >= (long long)JobSystem::DequeCapacity) {
+            return false;
+        }
+        jobs[b & DequeMask].store(job);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool pop(Job& job) {
+        long long b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long long t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        jobs[b & DequeMask].load(job);
+        if (t == b) {
+            // Last job, race the thieves for it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    bool steal(Job& job) {
+        long long t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        long long b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+        jobs[t & DequeMask].load(job);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+};
+
+struct JobSystemState {
+    std::mutex initializeMutex;
+    std::atomic<bool> initialized{false};
+    bool stopping = false;
+    // Index 0 belongs to the main thread, the workers own the rest
+    std::vector<WorkDeque*> deques;
+    std::vector<std::thread> workers;
+
+    // Jobs submitted by threads outside the pool
+    std::mutex sharedMutex;
+    std::deque<Job> shared;
+
+    std::atomic<int> queuedJobs{0};
+    std::atomic<int> sleepingWorkers{0};
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+};
+
+static JobSystemState& getState() {
+    static JobSystemState* state = new JobSystemState();
+    return *state;
+}
+
+// -1 on threads that are not part of the pool
+static thread_local int ThreadIndex = -1;
+static thread_local unsigned int StealSeed = 0;
+
+void JobSystem::Initialize(unsigned int workerCount) {
+    JobSystemState& state = getState();
+    std::lock_guard<std::mutex> lock(state.initializeMutex);
+    if (state.initialized) {
+        Logger::Log("JobSystem", "Job system is already initialized", Logger::LOG_WARNING);
+        return;
+    }
+    JobSystem::Start(workerCount);
+}
+
+void JobSystem::Start(unsigned int workerCount) {
+    JobSystemState& state = getState();
+    if (workerCount == 0) {
+        workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    }
+
+    state.stopping = false;
+    state.deques.clear();
+    for (unsigned int i = 0; i <= workerCount; i++) {
+        state.deques.push_back(new WorkDeque());
+    }
+    ThreadIndex = 0;
+    StealSeed = 1;
+    for (unsigned int i = 1; i <= workerCount; i++) {
+        state.workers.push_back(std::thread(JobSystem::WorkerMain, i));
+    }
+
+    static bool registeredExitHandler = false;
+    if (!registeredExitHandler) {
+        atexit(JobSystem::Shutdown);
+        registeredExitHandler = true;
+    }
+    state.initialized = true;
+}
+
+void JobSystem::Shutdown() {
+    JobSystemState& state = getState();
+    std::lock_guard<std::mutex> lock(state.initializeMutex);
+    if (!state.initialized) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> sleepLock(state.sleepMutex);
+        state.stopping = true;
+    }
+    state.sleepCondition.notify_all();
+    for (std::thread& worker : state.workers) {
+        worker.join();
+    }
+    state.workers.clear();
+    for (WorkDeque* deque : state.deques) {
+        delete deque;
+    }
+    state.deques.clear();
+    ThreadIndex = -1;
+    state.initialized = false;
+}
+
+bool JobSystem::IsInitialized() {
+    return getState().initialized;
+}
+
+unsigned int JobSystem::GetThreadCount() {
+    JobSystem::EnsureInitialized();
+    return getState().deques.size();
+}
+
+void JobSystem::EnsureInitialized() {
+    JobSystemState& state = getState();
+    if (!state.initialized.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(state.initializeMutex);
+        if (!state.initialized) {
+            JobSystem::Start(0);
+        }
+    }
+}
+
+void JobSystem::Run(JobFunction function, void* data, unsigned int begin, unsigned int end, unsigned int grain,
+                    JobCounter* counter, JobCounter* dependency) {
+    JobSystem::EnsureInitialized();
+    Job job;
+    job.function = function;
+    job.data = data;
+    job.begin = begin;
+    job.end = end;
+    job.grain = std::max(grain, 1u);
+    job.counter = counter;
+    if (counter != nullptr) {
+        counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (dependency != nullptr) {
+        // Checked under the lock so a dependency finishing concurrently either sees this job or we see it done
+        std::lock_guard<std::mutex> lock(dependency->m_Mutex);
+        if (!dependency->isDone()) {
+            dependency->m_Continuations.push_back(job);
+            return;
+        }
+    }
+    JobSystem::Push(job);
+}
+
+void JobSystem::Push(const Job& job) {
+    JobSystemState& state = getState();
+    // Counted before it is visible, so a thief never takes the count below zero
+    state.queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+    if (ThreadIndex >= 0) {
+        if (!state.deques[ThreadIndex]->push(job)) {
+            state.queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            JobSystem::Execute(job);
+            return;
+        }
+    }
+    else {
+        std::lock_guard<std::mutex> lock(state.sharedMutex);
+        state.shared.push_back(job);
+    }
+    if (state.sleepingWorkers.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(state.sleepMutex);
+        state.sleepCondition.notify_one();
+    }
+}
+
+bool JobSystem::FindJob(Job& job) {
+    JobSystemState& state = getState();
+    if (state.queuedJobs.load(std::memory_order_relaxed) <= 0) {
+        return false;
+    }
+    bool found = false;
+    if (ThreadIndex >= 0) {
+        found = state.deques[ThreadIndex]->pop(job);
+    }
+    if (!found) {
+        std::lock_guard<std::mutex> lock(state.sharedMutex);
+        if (!state.shared.empty()) {
+            job = state.shared.front();
+            state.shared.pop_front();
+            found = true;
+        }
+    }
+    if (!found) {
+        unsigned int dequeCount = state.deques.size();
+        // xorshift, victims are picked at random so thieves do not all hit the same deque
+        StealSeed ^= StealSeed << 13;
+        StealSeed ^= StealSeed >> 17;
+        StealSeed ^= StealSeed << 5;
+        unsigned int start = StealSeed % dequeCount;
+        for (unsigned int i = 0; i < dequeCount && !found; i++) {
+            unsigned int victim = (start + i) % dequeCount;
+            if ((int)victim != ThreadIndex) {
+                found = state.deques[victim]->steal(job);
+            }
+        }
+    }
+    if (found) {
+        state.queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return found;
+}
+
+void JobSystem::Execute(Job job) {
+    while (job.end - job.begin > job.grain) {
+        Job upper = job;
+        upper.begin = job.begin + (job.end - job.begin) / 2;
+        job.end = upper.begin;
+        if (upper.counter != nullptr) {
+            upper.counter->m_Pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        JobSystem::Push(upper);
+    }
+    job.function(job.data, job.begin, job.end);
+    JobSystem::Finish(job.counter);
+}
+
+void JobSystem::Finish(JobCounter* counter) {
+    if (counter == nullptr) {
+        return;
+    }
+    unsigned int pending = counter->m_Pending.load(std::memory_order_relaxed);
+    while (pending > 1) {
+        if (counter->m_Pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel)) {
+            return;
+        }
+    }
+    // The last job publishes completion under the lock and never touches the counter after releasing
+    // it, Wait takes the lock once before returning so the owner cannot destroy the counter earlier
+    std::vector<Job> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_Mutex);
+        if (counter->m_Pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        continuations.swap(counter->m_Continuations);
+    }
+    for (const Job& continuation : continuations) {
+        JobSystem::Push(continuation);
+    }
+}
+
+bool JobSystem::TryRunJob() {
+    JobSystem::EnsureInitialized();
+    Job job;
+    if (!JobSystem::FindJob(job)) {
+        return false;
+    }
+    JobSystem::Execute(job);
+    return true;
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    unsigned int idleCount = 0;
+    while (!counter.isDone()) {
+        if (JobSystem::TryRunJob()) {
+            idleCount = 0;
+        }
+        else if (++idleCount > SpinCount) {
+            std::this_thread::yield();
+        }
+    }
+    // The job that finished the counter may still hold its lock
+    std::lock_guard<std::mutex> lock(counter.m_Mutex);
+}
+
+void JobSystem::WorkerMain(unsigned int index) {
+    JobSystemState& state = getState();
+    ThreadIndex = index;
+    StealSeed = index * 2654435761u + 1;
+    unsigned int idleCount = 0;
+    while (true) {
+        Job job;
+        if (JobSystem::FindJob(job)) {
+            JobSystem::Execute(job);
+            idleCount = 0;
+            continue;
+        }
+        if (++idleCount < SpinCount) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(state.sleepMutex);
+        state.sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+        state.sleepCondition.wait(lock, [&state] {
+            return state.stopping || state.queuedJobs.load(std::memory_order_seq_cst) > 0;
+        });
+        state.sleepingWorkers.fetch_sub(1, std::memory_order_seq_cst);
+        if (state.stopping) {
+            return;
+        }
+        idleCount = 0;
+    }
+}
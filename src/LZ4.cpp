@@ -0,0 +1,200 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "Mantaray/Core/LZ4.hpp"
+
+using namespace MR;
+
+static const size_t MinMatch = 4;
+// The format requires the last 5 bytes to be literals and the last match to start 12 bytes before the end
+static const size_t LastLiterals = 5;
+static const size_t MatchSafeDistance = 12;
+static const size_t MaxOffset = 65535;
+static const int HashBits = 14;
+
+static uint32_t read32(const unsigned char* pointer) {
+    uint32_t value;
+    memcpy(&value, pointer, sizeof(value));
+    return value;
+}
+
+static uint32_t hashSequence(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+static bool writeLength(unsigned char*& out, unsigned char* end, size_t length) {
+    while (length >= 255) {
+        if (out >= end) {
+            return false;
+        }
+        *out++ = 255;
+        length -= 255;
+    }
+    if (out >= end) {
+        return false;
+    }
+    *out++ = (unsigned char)length;
+    return true;
+}
+
+static bool writeSequence(unsigned char*& out, unsigned char* end, const unsigned char* literals, size_t literalLength, size_t offset, size_t matchLength) {
+    if (out >= end) {
+        return false;
+    }
+    unsigned char* token = out++;
+    *token = (unsigned char)((literalLength >= 15 ? 15 : literalLength) << 4);
+    if (literalLength >= 15 && !writeLength(out, end, literalLength - 15)) {
+        return false;
+    }
+    if ((size_t)(end - out) < literalLength) {
+        return false;
+    }
+    memcpy(out, literals, literalLength);
+    out += literalLength;
+
+    // The final sequence only carries literals
+    if (matchLength == 0) {
+        return true;
+    }
+    if (end - out < 2) {
+        return false;
+    }
+    *out++ = offset & 0xFF;
+    *out++ = (offset >> 8) & 0xFF;
+    size_t encodedMatch = matchLength - MinMatch;
+    *token |= (unsigned char)(encodedMatch >= 15 ? 15 : encodedMatch);
+    if (encodedMatch >= 15 && !writeLength(out, end, encodedMatch - 15)) {
+        return false;
+    }
+    return true;
+}
+
+size_t LZ4::GetCompressBound(size_t sourceSize) {
+    return sourceSize + sourceSize / 255 + 16;
+}
+
+size_t LZ4::Compress(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t destinationCapacity) {
+    unsigned char* out = destination;
+    unsigned char* outEnd = destination + destinationCapacity;
+    const unsigned char* anchor = source;
+    const unsigned char* end = source + sourceSize;
+
+    if (sourceSize > MatchSafeDistance) {
+        // Positions relative to source, unset slots point at position 0 and get verified like any other candidate
+        std::vector<uint32_t> table = std::vector<uint32_t>(1 << HashBits, 0);
+        const unsigned char* matchLimit = end - LastLiterals;
+        const unsigned char* searchLimit = end - MatchSafeDistance;
+        const unsigned char* current = source + 1;
+
+        while (current < searchLimit) {
+            uint32_t sequence = read32(current);
+            uint32_t hash = hashSequence(sequence);
+            const unsigned char* candidate = source + table[hash];
+            table[hash] = (uint32_t)(current - source);
+
+            if (candidate >= current || (size_t)(current - candidate) > MaxOffset || read32(candidate) != sequence) {
+                current++;
+                continue;
+            }
+
+            // Extend the match backwards over pending literals and forwards up to the limit
+            while (current > anchor && candidate > source && current[-1] == candidate[-1]) {
+                current--;
+                candidate--;
+            }
+            const unsigned char* matchEnd = current + MinMatch;
+            const unsigned char* candidateEnd = candidate + MinMatch;
+            while (matchEnd < matchLimit && *matchEnd == *candidateEnd) {
+                matchEnd++;
+                candidateEnd++;
+            }
+
+            if (!writeSequence(out, outEnd, anchor, current - anchor, current - candidate, matchEnd - current)) {
+                return 0;
+            }
+            anchor = matchEnd;
+            current = matchEnd;
+            if (current < searchLimit) {
+                table[hashSequence(read32(current - 2))] = (uint32_t)(current - 2 - source);
+            }
+        }
+    }
+
+    if (!writeSequence(out, outEnd, anchor, end - anchor, 0, 0)) {
+        return 0;
+    }
+    return out - destination;
+}
+
+bool LZ4::Decompress(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t destinationSize) {
+    const unsigned char* in = source;
+    const unsigned char* inEnd = source + sourceSize;
+    unsigned char* out = destination;
+    unsigned char* outEnd = destination + destinationSize;
+
+    while (in < inEnd) {
+        unsigned char token = *in++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15) {
+            unsigned char extra;
+            do {
+                if (in >= inEnd) {
+                    return false;
+                }
+                extra = *in++;
+                literalLength += extra;
+            } while (extra == 255);
+        }
+        if ((size_t)(inEnd - in) < literalLength || (size_t)(outEnd - out) < literalLength) {
+            return false;
+        }
+        memcpy(out, in, literalLength);
+        in += literalLength;
+        out += literalLength;
+
+        // A block ends with a literal only sequence
+        if (in == inEnd) {
+            break;
+        }
+
+        if (inEnd - in < 2) {
+            return false;
+        }
+        size_t offset = in[0] | (in[1] << 8);
+        in += 2;
+        if (offset == 0 || offset > (size_t)(out - destination)) {
+            return false;
+        }
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15) {
+            unsigned char extra;
+            do {
+                if (in >= inEnd) {
+                    return false;
+                }
+                extra = *in++;
+                matchLength += extra;
+            } while (extra == 255);
+        }
+        matchLength += MinMatch;
+        if ((size_t)(outEnd - out) < matchLength) {
+            return false;
+        }
+
+        const unsigned char* match = out - offset;
+        if (offset >= matchLength) {
+            memcpy(out, match, matchLength);
+            out += matchLength;
+        }
+        else {
+            // Overlapping copy repeats the last offset bytes
+            for (size_t i = 0; i < matchLength; i++) {
+                *out++ = *match++;
+            }
+        }
+    }
+    return out == outEnd;
+}
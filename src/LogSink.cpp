@@ -0,0 +1,129 @@
+#include <cstdio>
+
+#include "Mantaray/Core/LogSink.hpp"
+
+#ifdef PLATFORM_WINDOWS
+#include <windows.h>
+
+#define FOREGROUND_WHITE 0x0007
+#define FOREGROUND_YELLOW 0x0006
+
+static void changeColor(WORD theColor) {
+    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+    SetConsoleTextAttribute(hConsole, theColor);
+}
+#endif
+
+using namespace MR;
+
+LogSink::~LogSink() {
+}
+
+void LogSink::flush() {
+}
+
+void ConsoleSink::write(Logger::LogLevel logLevel, float time, const char* line, size_t length) {
+    (void)time;
+#ifdef PLATFORM_WINDOWS
+    switch (logLevel) {
+        case Logger::LOG_WARNING:
+            changeColor(FOREGROUND_YELLOW);
+            break;
+        case Logger::LOG_ERROR:
+            changeColor(FOREGROUND_RED);
+            break;
+        case Logger::LOG_DEBUG:
+            changeColor(FOREGROUND_BLUE);
+            break;
+        default:
+            changeColor(FOREGROUND_WHITE);
+            break;
+    }
+    fwrite(line, 1, length, stdout);
+    fputc('\n', stdout);
+    changeColor(FOREGROUND_WHITE);
+#else
+    const char* color = "\033[37m";
+    switch (logLevel) {
+        case Logger::LOG_WARNING:
+            color = "\033[33m";
+            break;
+        case Logger::LOG_ERROR:
+            color = "\033[31m";
+            break;
+        case Logger::LOG_DEBUG:
+            color = "\033[34m";
+            break;
+        default:
+            break;
+    }
+    fputs(color, stdout);
+    fwrite(line, 1, length, stdout);
+    fputs("\033[0m\n", stdout);
+#endif
+    if (logLevel == Logger::LOG_WARNING || logLevel == Logger::LOG_ERROR) {
+        fflush(stdout);
+    }
+}
+
+void ConsoleSink::flush() {
+    fflush(stdout);
+}
+
+RotatingFileSink::RotatingFileSink(std::string path, size_t maxBytes, unsigned int maxFiles)
+    : m_Path(path), m_MaxBytes(maxBytes), m_MaxFiles(maxFiles) {
+    m_File = fopen(m_Path.c_str(), "ab");
+    if (m_File != nullptr) {
+        fseek(m_File, 0, SEEK_END);
+        m_Size = ftell(m_File);
+    }
+}
+
+RotatingFileSink::~RotatingFileSink() {
+    if (m_File != nullptr) {
+        fclose(m_File);
+    }
+}
+
+void RotatingFileSink::write(Logger::LogLevel logLevel, float time, const char* line, size_t length) {
+    (void)logLevel;
+    if (m_File == nullptr) {
+        return;
+    }
+    if (m_Size > 0 && m_Size + length > m_MaxBytes) {
+        rotate();
+        if (m_File == nullptr) {
+            return;
+        }
+    }
+    int written = fprintf(m_File, "[%10.3f] ", time);
+    fwrite(line, 1, length, m_File);
+    fputc('\n', m_File);
+    m_Size += (written > 0 ? written : 0) + length + 1;
+}
+
+void RotatingFileSink::flush() {
+    if (m_File != nullptr) {
+        fflush(m_File);
+    }
+}
+
+bool RotatingFileSink::isOpen() {
+    return m_File != nullptr;
+}
+
+void RotatingFileSink::rotate() {
+    fclose(m_File);
+    if (m_MaxFiles == 0) {
+        remove(m_Path.c_str());
+    }
+    else {
+        remove((m_Path + "." + std::to_string(m_MaxFiles)).c_str());
+        for (unsigned int i = m_MaxFiles; i > 1; i--) {
+            rename((m_Path + "." + std::to_string(i - 1)).c_str(), (m_Path + "." + std::to_string(i)).c_str());
+        }
+        rename(m_Path.c_str(), (m_Path + ".1").c_str());
+    }
+    m_File = fopen(m_Path.c_str(), "wb");
+    m_Size = 0;
+}
@@ -1,66 +1,382 @@
-#include <iostream>
-#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "Mantaray/Core/Logger.hpp"
+#include "Mantaray/Core/LogSink.hpp"
 
-#ifdef PLATFORM_WINDOWS
-#include <windows.h>
+using namespace MR;
+
+static const size_t NameCapacity = 32;
+static const size_t CellTextCapacity = 448;
+// Longer messages are cut after this many cells
+static const unsigned int MaxCellsPerMessage = 32;
+
+// A message takes one cell, or several consecutive ones when it does not fit.
+// Only the first cell of a message carries the header fields.
+struct LogCell {
+    std::atomic<size_t> sequence;
+    Logger::LogLevel logLevel;
+    float time;
+    uint16_t cellCount;
+    uint16_t nameLength;
+    uint16_t textLength;
+    char name[NameCapacity];
+    char text[CellTextCapacity];
+};
+
+struct LoggerState {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    std::mutex sinkMutex;
+    std::vector<LogSink*> sinks;
+    bool defaultSinks = true;
+    std::string syncLine;
+
+    // Bounded MPSC queue after Dmitry Vyukov's bounded MPMC queue: a cell is free for position p
+    // when its sequence is p and holds a published message when its sequence is p + 1
+    LogCell* cells = nullptr;
+    size_t mask = 0;
+    std::atomic<size_t> enqueuePosition{0};
+    std::atomic<size_t> writtenPosition{0};
+    size_t dequeuePosition = 0;
+
+    std::atomic<bool> async{false};
+    std::atomic<unsigned int> activeProducers{0};
+    std::atomic<int> overflowPolicy{Logger::OVERFLOW_DROP};
+    std::atomic<unsigned long long> droppedCount{0};
+    unsigned long long reportedDrops = 0;
+
+    std::mutex controlMutex;
+    std::thread consumer;
+    std::atomic<bool> running{false};
+    std::atomic<bool> consumerSleeping{false};
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::string consumerLine;
+    bool registeredExit = false;
+
+    LoggerState() {
+        sinks.push_back(new ConsoleSink());
+    }
+};
+
+// Never destroyed, so logging from static destructors keeps working
+static LoggerState& state() {
+    static LoggerState* loggerState = new LoggerState();
+    return *loggerState;
+}
 
-#define FOREGROUND_WHITE 0x0007
-#define FOREGROUND_YELLOW 0x0006
+static float elapsedTime(LoggerState& s) {
+    return std::chrono::duration<float>(std::chrono::steady_clock::now() - s.start).count();
+}
 
-void changeColor(WORD theColor);
+static void formatLine(std::string& line, Logger::LogLevel logLevel, const char* name, size_t nameLength) {
+    line.clear();
+    switch (logLevel) {
+        case Logger::LOG_INFO:
+            line += "INFO::";
+            break;
+        case Logger::LOG_WARNING:
+            line += "WARNING::";
+            break;
+        case Logger::LOG_ERROR:
+            line += "ERROR::";
+            break;
+        default:
+            line += "DEBUG::";
+            break;
+    }
+    line.append(name, nameLength);
+    line += "-> ";
+}
 
-void changeColor(WORD theColor) {
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-    SetConsoleTextAttribute(hConsole, theColor);
+// Caller holds the sink mutex
+static void writeLine(LoggerState& s, Logger::LogLevel logLevel, float time, const std::string& line) {
+    for (LogSink* sink : s.sinks) {
+        sink->write(logLevel, time, line.data(), line.size());
+    }
 }
-#endif
 
-#ifdef PLATFORM_LINUX
-#define FOREGROUND_WHITE "\033[37m"
-#define FOREGROUND_YELLOW "\033[33m"
-#define FOREGROUND_RED "\033[31m"
-#define FOREGROUND_BLUE "\033[34m"
+static void flushSinks(LoggerState& s) {
+    for (LogSink* sink : s.sinks) {
+        sink->flush();
+    }
+}
 
-#define changeColor(color) logPrefix = color; message += "\033[0m";
-#endif
+static void wakeConsumer(LoggerState& s) {
+    std::lock_guard<std::mutex> lock(s.wakeMutex);
+    s.wake.notify_one();
+}
 
-using namespace MR;
+static bool enqueue(LoggerState& s, const std::string& name, const std::string& message, Logger::LogLevel logLevel) {
+    size_t capacity = s.mask + 1;
+    unsigned int cellCount = (message.size() + CellTextCapacity - 1) / CellTextCapacity;
+    cellCount = std::max(1u, std::min(cellCount, std::min(MaxCellsPerMessage, (unsigned int)capacity)));
+
+    // The consumer frees cells in order, so once the last cell of the range is free all of them are
+    size_t position = s.enqueuePosition.load(std::memory_order_relaxed);
+    while (true) {
+        size_t last = position + cellCount - 1;
+        size_t sequence = s.cells[last & s.mask].sequence.load(std::memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)last;
+        if (difference == 0) {
+            if (s.enqueuePosition.compare_exchange_weak(position, position + cellCount, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (difference < 0) {
+            if (s.overflowPolicy.load(std::memory_order_relaxed) == Logger::OVERFLOW_DROP) {
+                s.droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            wakeConsumer(s);
+            std::this_thread::yield();
+            position = s.enqueuePosition.load(std::memory_order_relaxed);
+        }
+        else {
+            position = s.enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    LogCell& first = s.cells[position & s.mask];
+    first.logLevel = logLevel;
+    first.time = elapsedTime(s);
+    first.cellCount = cellCount;
+    first.nameLength = std::min(name.size(), NameCapacity);
+    memcpy(first.name, name.data(), first.nameLength);
+
+    size_t offset = 0;
+    for (unsigned int i = 0; i < cellCount; i++) {
+        LogCell& cell = s.cells[(position + i) & s.mask];
+        cell.textLength = std::min(message.size() - offset, CellTextCapacity);
+        memcpy(cell.text, message.data() + offset, cell.textLength);
+        offset += cell.textLength;
+    }
+    // Published back to front, the consumer starts reading once the first cell is visible
+    for (unsigned int i = cellCount; i > 0; i--) {
+        s.cells[(position + i - 1) & s.mask].sequence.store(position + i, std::memory_order_release);
+    }
+
+    // The consumer polls on its own, it is only woken for errors and before the queue runs full
+    bool filling = position - s.writtenPosition.load(std::memory_order_relaxed) >= capacity / 2;
+    if ((logLevel == Logger::LOG_ERROR || filling) && s.consumerSleeping.exchange(false, std::memory_order_relaxed)) {
+        wakeConsumer(s);
+    }
+    return true;
+}
+
+static bool consumeOne(LoggerState& s) {
+    size_t position = s.dequeuePosition;
+    LogCell& first = s.cells[position & s.mask];
+    if (first.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+
+    unsigned int cellCount = first.cellCount;
+    formatLine(s.consumerLine, first.logLevel, first.name, first.nameLength);
+    for (unsigned int i = 0; i < cellCount; i++) {
+        LogCell& cell = s.cells[(position + i) & s.mask];
+        s.consumerLine.append(cell.text, cell.textLength);
+    }
+    {
+        std::lock_guard<std::mutex> lock(s.sinkMutex);
+        writeLine(s, first.logLevel, first.time, s.consumerLine);
+    }
+
+    size_t capacity = s.mask + 1;
+    for (unsigned int i = 0; i < cellCount; i++) {
+        s.cells[(position + i) & s.mask].sequence.store(position + i + capacity, std::memory_order_release);
+    }
+    s.dequeuePosition = position + cellCount;
+    s.writtenPosition.store(s.dequeuePosition, std::memory_order_release);
+    return true;
+}
+
+static void reportDrops(LoggerState& s) {
+    unsigned long long dropped = s.droppedCount.load(std::memory_order_relaxed);
+    if (dropped == s.reportedDrops) {
+        return;
+    }
+    std::string name = "Logger";
+    formatLine(s.consumerLine, Logger::LOG_WARNING, name.data(), name.size());
+    s.consumerLine += std::to_string(dropped - s.reportedDrops) + " messages were dropped, the queue was full";
+    s.reportedDrops = dropped;
+    std::lock_guard<std::mutex> lock(s.sinkMutex);
+    writeLine(s, Logger::LOG_WARNING, elapsedTime(s), s.consumerLine);
+}
+
+static void consumerLoop(LoggerState* loggerState) {
+    LoggerState& s = *loggerState;
+    while (true) {
+        // Read before draining, so everything published before the stop is still written
+        bool stopping = !s.running.load(std::memory_order_acquire);
+        bool wrote = false;
+        while (consumeOne(s)) {
+            wrote = true;
+        }
+        reportDrops(s);
+        if (wrote) {
+            std::lock_guard<std::mutex> lock(s.sinkMutex);
+            flushSinks(s);
+        }
+        if (stopping) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(s.wakeMutex);
+        s.consumerSleeping.store(true, std::memory_order_relaxed);
+        // The timeout bounds the latency and covers a signal that raced the flag
+        s.wake.wait_for(lock, std::chrono::milliseconds(5));
+        s.consumerSleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+static void stopAtExit() {
+    Logger::StopAsync();
+}
+
+std::atomic<int> Logger::MinimumSeverity(0);
 
 Logger::Logger(std::string name) {
     m_Name = name;
 }
 
-void Logger::Log(std::string message, Logger::LogLevel logLevel) {
+void Logger::Log(const std::string& message, Logger::LogLevel logLevel) {
     Logger::Log(m_Name, message, logLevel);
 }
 
-void Logger::Log(std::string name, std::string message, Logger::LogLevel logLevel) {
-    std::string logPrefix = "";
-    switch (logLevel)
-    {
-    case Logger::LOG_INFO:
-        changeColor(FOREGROUND_WHITE);
-        logPrefix += "INFO::" + name + "-> ";
-        break;
-    case Logger::LOG_WARNING:
-        changeColor(FOREGROUND_YELLOW);
-        logPrefix += "WARNING::" + name + "-> ";
-        break;
-    case Logger::LOG_ERROR:
-        changeColor(FOREGROUND_RED);
-        logPrefix += "ERROR::" + name + "-> ";
-        break;
-    case Logger::LOG_DEBUG:
-        changeColor(FOREGROUND_BLUE);
-        logPrefix += "DEBUG::" + name + "-> ";
-        break;
-    
-    default:
+const std::string& Logger::getName() {
+    return m_Name;
+}
+
+void Logger::Log(const std::string& name, const std::string& message, Logger::LogLevel logLevel) {
+    if (!IsEnabled(logLevel)) {
+        return;
+    }
+    LoggerState& s = state();
+    if (s.async.load(std::memory_order_relaxed)) {
+        // StopAsync waits for producers that saw the queue as active before releasing it
+        s.activeProducers.fetch_add(1);
+        if (s.async.load()) {
+            enqueue(s, name, message, logLevel);
+            s.activeProducers.fetch_sub(1);
+            return;
+        }
+        s.activeProducers.fetch_sub(1);
+    }
+
+    std::lock_guard<std::mutex> lock(s.sinkMutex);
+    formatLine(s.syncLine, logLevel, name.data(), name.size());
+    s.syncLine += message;
+    writeLine(s, logLevel, elapsedTime(s), s.syncLine);
+}
+
+void Logger::SetLevel(LogLevel minimumLevel) {
+    Logger::MinimumSeverity.store(Severity(minimumLevel), std::memory_order_relaxed);
+}
+
+void Logger::StartAsync(unsigned int capacity, OverflowPolicy policy) {
+    LoggerState& s = state();
+    std::lock_guard<std::mutex> control(s.controlMutex);
+    s.overflowPolicy.store(policy);
+    if (s.running.load()) {
+        return;
+    }
+
+    size_t cellCount = 2;
+    while (cellCount < capacity) {
+        cellCount <<= 1;
+    }
+    s.cells = new LogCell[cellCount];
+    for (size_t i = 0; i < cellCount; i++) {
+        s.cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    s.mask = cellCount - 1;
+    s.enqueuePosition.store(0);
+    s.writtenPosition.store(0);
+    s.dequeuePosition = 0;
+
+    s.running.store(true);
+    s.consumer = std::thread(consumerLoop, &s);
+    s.async.store(true);
+    if (!s.registeredExit) {
+        s.registeredExit = true;
+        atexit(stopAtExit);
+    }
+}
+
+void Logger::StopAsync() {
+    LoggerState& s = state();
+    std::lock_guard<std::mutex> control(s.controlMutex);
+    if (!s.running.load()) {
         return;
     }
+    s.async.store(false);
+    while (s.activeProducers.load() != 0) {
+        std::this_thread::yield();
+    }
+    s.running.store(false, std::memory_order_release);
+    wakeConsumer(s);
+    s.consumer.join();
+    delete[] s.cells;
+    s.cells = nullptr;
+    s.mask = 0;
+}
+
+bool Logger::IsAsync() {
+    return state().async.load();
+}
+
+void Logger::SetOverflowPolicy(OverflowPolicy policy) {
+    state().overflowPolicy.store(policy);
+}
 
-    std::cout << logPrefix + message << std::endl;
-    changeColor(FOREGROUND_WHITE);
+void Logger::Flush() {
+    LoggerState& s = state();
+    {
+        std::lock_guard<std::mutex> control(s.controlMutex);
+        if (s.running.load()) {
+            size_t target = s.enqueuePosition.load();
+            while (s.writtenPosition.load(std::memory_order_acquire) < target) {
+                wakeConsumer(s);
+                std::this_thread::yield();
+            }
+        }
+    }
+    std::lock_guard<std::mutex> lock(s.sinkMutex);
+    flushSinks(s);
+}
+
+unsigned long long Logger::GetDroppedCount() {
+    return state().droppedCount.load();
+}
+
+void Logger::AddSink(LogSink* sink) {
+    LoggerState& s = state();
+    std::lock_guard<std::mutex> lock(s.sinkMutex);
+    if (s.defaultSinks) {
+        for (LogSink* defaultSink : s.sinks) {
+            delete defaultSink;
+        }
+        s.sinks.clear();
+        s.defaultSinks = false;
+    }
+    s.sinks.push_back(sink);
+}
+
+void Logger::ClearSinks() {
+    LoggerState& s = state();
+    std::lock_guard<std::mutex> lock(s.sinkMutex);
+    for (LogSink* sink : s.sinks) {
+        delete sink;
+    }
+    s.sinks.clear();
+    s.defaultSinks = false;
 }
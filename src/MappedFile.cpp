@@ -0,0 +1,136 @@
+#ifdef PLATFORM_WINDOWS
+#include <Windows.h>
+#endif
+#ifdef PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Mantaray/Core/MappedFile.hpp"
+#include "Mantaray/Core/Logger.hpp"
+
+using namespace MR;
+
+MappedFile::MappedFile() {
+}
+
+MappedFile::MappedFile(std::string path) {
+    open(path);
+}
+
+MappedFile::MappedFile(MappedFile&& other) {
+    m_Data = other.m_Data;
+    m_Size = other.m_Size;
+    m_File = other.m_File;
+    m_Mapping = other.m_Mapping;
+    other.reset();
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+    if (this != &other) {
+        close();
+        m_Data = other.m_Data;
+        m_Size = other.m_Size;
+        m_File = other.m_File;
+        m_Mapping = other.m_Mapping;
+        other.reset();
+    }
+    return *this;
+}
+
+bool MappedFile::open(std::string path) {
+    close();
+#ifdef PLATFORM_WINDOWS
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        Logger::Log("MappedFile", "Could not open file: " + path, Logger::LOG_ERROR);
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        Logger::Log("MappedFile", "Could not map empty file: " + path, Logger::LOG_ERROR);
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* data = (mapping != NULL) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (data == NULL) {
+        Logger::Log("MappedFile", "Could not map file: " + path, Logger::LOG_ERROR);
+        if (mapping != NULL) {
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+        return false;
+    }
+    m_File = (intptr_t)file;
+    m_Mapping = mapping;
+    m_Data = (const unsigned char*)data;
+    m_Size = (size_t)size.QuadPart;
+#endif
+#ifdef PLATFORM_LINUX
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        Logger::Log("MappedFile", "Could not open file: " + path, Logger::LOG_ERROR);
+        return false;
+    }
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size == 0) {
+        Logger::Log("MappedFile", "Could not map empty file: " + path, Logger::LOG_ERROR);
+        ::close(file);
+        return false;
+    }
+    void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED) {
+        Logger::Log("MappedFile", "Could not map file: " + path, Logger::LOG_ERROR);
+        ::close(file);
+        return false;
+    }
+    // Mapped files are usually consumed completely right after opening, start reading ahead now
+    madvise(data, status.st_size, MADV_WILLNEED);
+    m_File = file;
+    m_Data = (const unsigned char*)data;
+    m_Size = status.st_size;
+#endif
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_Data == nullptr) {
+        return;
+    }
+#ifdef PLATFORM_WINDOWS
+    UnmapViewOfFile(m_Data);
+    CloseHandle((HANDLE)m_Mapping);
+    CloseHandle((HANDLE)m_File);
+#endif
+#ifdef PLATFORM_LINUX
+    munmap((void*)m_Data, m_Size);
+    ::close((int)m_File);
+#endif
+    reset();
+}
+
+bool MappedFile::isOpen() {
+    return m_Data != nullptr;
+}
+
+const unsigned char* MappedFile::getData() {
+    return m_Data;
+}
+
+size_t MappedFile::getSize() {
+    return m_Size;
+}
+
+void MappedFile::reset() {
+    m_Data = nullptr;
+    m_Size = 0;
+    m_File = -1;
+    m_Mapping = nullptr;
+}
@@ -1,5 +1,6 @@
 #include "Mantaray/OpenGL/Object.hpp"
 #include "Mantaray/OpenGL/ObjectChain.hpp"
+#include "Mantaray/OpenGL/RenderThread.hpp"
 #include "Mantaray/Core/Logger.hpp"
 
 using namespace MR;
@@ -28,8 +29,24 @@ void Object::unbind() {
     Logger::Log("Object", "unbind not implemented!", Logger::LOG_WARNING);
 }
 
+Object::ObjectType Object::getObjectType() {
+    return Object::OBJECT_GENERIC;
+}
+
+size_t Object::getByteEstimate() {
+    return m_ByteSize;
+}
+
+void Object::setByteSize(size_t byteSize) {
+    if (m_HasAllocatedData) {
+        ObjectChain::TrackBytes(this, byteSize);
+    }
+    m_ByteSize = byteSize;
+}
+
 void Object::link() {
     if (!m_HasAllocatedData) {
+        warnWithoutContext();
         allocate();
         m_HasAllocatedData = true;
         ObjectChain::Link(this);
@@ -39,15 +56,16 @@ void Object::link() {
 
 void Object::unlink() {
     if (m_HasAllocatedData) {
+        warnWithoutContext();
         release();
         m_HasAllocatedData = false;
         ObjectChain::UnLink(this);
+        m_ByteSize = 0;
     }
 }
 
-void Object::destroy() {
-    unlink();
-    if (m_Next != nullptr) {
-        m_Next->destroy();
+void Object::warnWithoutContext() {
+    if (RenderThread::IsRecording()) {
+        Logger::Log("Object", "GL objects cannot be created or deleted without the context while rendering is threaded, see RenderThread::AcquireContext", Logger::LOG_WARNING);
     }
 }
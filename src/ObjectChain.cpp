@@ -8,6 +8,8 @@
 
 using namespace MR;
 
+static const uint32_t NoEntry = 0xFFFFFFFF;
+
 inline std::string GetPointerString(Object* pointer) {
     const void * address = static_cast<const void*>(pointer);
     std::stringstream ss;
@@ -16,8 +18,13 @@ inline std::string GetPointerString(Object* pointer) {
 }
 
 bool ObjectChain::Initialized = false;
-Object* ObjectChain::ChainTail = nullptr;
-Object* ObjectChain::ChainHead = nullptr;
+bool ObjectChain::LoggingEnabled = false;
+std::vector<ObjectChain::Entry> ObjectChain::Entries = std::vector<ObjectChain::Entry>();
+std::vector<uint32_t> ObjectChain::FreeEntries = std::vector<uint32_t>();
+uint32_t ObjectChain::ChainHead = NoEntry;
+uint32_t ObjectChain::ChainTail = NoEntry;
+unsigned int ObjectChain::LiveCounts[Object::OBJECT_TYPE_COUNT] = {0};
+unsigned long long ObjectChain::ByteTotals[Object::OBJECT_TYPE_COUNT] = {0};
 Logger ObjectChain::Logger("ObjectChain");
 
 void ObjectChain::Initialize() {
@@ -25,9 +32,6 @@ void ObjectChain::Initialize() {
         ObjectChain::Logger.Log("Already Initialized!", Logger::LOG_WARNING);
         return;
     }
-    ObjectChain::ChainHead = new Object();
-    ObjectChain::ChainTail = ObjectChain::ChainHead;
-    ObjectChain::Logger.Log("Head is: " + GetPointerString(ObjectChain::ChainHead), Logger::LOG_DEBUG);
     ObjectChain::Initialized = true;
     ObjectLibrary::InitializeDefaultEntries();
 }
@@ -37,33 +41,111 @@ void ObjectChain::TearDown() {
         ObjectChain::Logger.Log("Chain is not Initialized! (TearDown)", Logger::LOG_WARNING);
         return;
     }
-    ObjectChain::ChainHead->destroy();
-    delete ObjectChain::ChainHead;
-    ObjectChain::ChainHead = nullptr;
+    // Newest first, every unlink removes its entry so the tail moves towards the head
+    while (ObjectChain::ChainTail != NoEntry) {
+        ObjectChain::Entries[ObjectChain::ChainTail].object->unlink();
+    }
+    ObjectChain::Entries.clear();
+    ObjectChain::FreeEntries.clear();
+    ObjectChain::ChainHead = NoEntry;
     ObjectChain::Initialized = false;
 }
 
 void ObjectChain::Link(Object* link) {
-    if (!ObjectChain::Initialized) {
-        ObjectChain::Logger.Log("Chain is not Initialized! (Link)", Logger::LOG_WARNING);
-        return;
+    uint32_t index;
+    if (!ObjectChain::FreeEntries.empty()) {
+        index = ObjectChain::FreeEntries.back();
+        ObjectChain::FreeEntries.pop_back();
+    }
+    else {
+        index = ObjectChain::Entries.size();
+        ObjectChain::Entries.push_back(Entry());
+    }
+
+    Entry& entry = ObjectChain::Entries[index];
+    entry.object = link;
+    entry.previous = ObjectChain::ChainTail;
+    entry.next = NoEntry;
+    entry.type = link->getObjectType();
+    if (ObjectChain::ChainTail != NoEntry) {
+        ObjectChain::Entries[ObjectChain::ChainTail].next = index;
+    }
+    else {
+        ObjectChain::ChainHead = index;
+    }
+    ObjectChain::ChainTail = index;
+    link->m_ChainIndex = index;
+    ObjectChain::LiveCounts[entry.type]++;
+    ObjectChain::ByteTotals[entry.type] += link->m_ByteSize;
+
+    if (ObjectChain::LoggingEnabled && Logger::IsEnabled(Logger::LOG_DEBUG)) {
+        LogObject("Linking in: ", link);
     }
-    ObjectChain::Logger.Log("Linking in: " + GetPointerString(link), Logger::LOG_DEBUG);
-    link->m_Previous = ObjectChain::ChainTail;
-    ObjectChain::ChainTail->m_Next = link;
-    ObjectChain::ChainTail = link;
 }
 
 void ObjectChain::UnLink(Object* link) {
-    if (!ObjectChain::Initialized) {
-        ObjectChain::Logger.Log("Chain is not Initialized! (UnLink)", Logger::LOG_WARNING);
+    uint32_t index = link->m_ChainIndex;
+    if (index >= ObjectChain::Entries.size() || ObjectChain::Entries[index].object != link) {
+        ObjectChain::Logger.Log("Object is not in the chain! (UnLink)", Logger::LOG_WARNING);
         return;
     }
-    ObjectChain::Logger.Log("Unlinking: " + GetPointerString(link), Logger::LOG_DEBUG);
-    if (link->m_Previous != nullptr) {
-        link->m_Previous->m_Next = link->m_Next;
+
+    Entry& entry = ObjectChain::Entries[index];
+    if (entry.previous != NoEntry) {
+        ObjectChain::Entries[entry.previous].next = entry.next;
+    }
+    else {
+        ObjectChain::ChainHead = entry.next;
     }
-    if (link->m_Next != nullptr) {
-        link->m_Next->m_Previous = link->m_Previous;
+    if (entry.next != NoEntry) {
+        ObjectChain::Entries[entry.next].previous = entry.previous;
     }
+    else {
+        ObjectChain::ChainTail = entry.previous;
+    }
+    ObjectChain::LiveCounts[entry.type]--;
+    ObjectChain::ByteTotals[entry.type] -= link->m_ByteSize;
+    entry.object = nullptr;
+    ObjectChain::FreeEntries.push_back(index);
+
+    if (ObjectChain::LoggingEnabled && Logger::IsEnabled(Logger::LOG_DEBUG)) {
+        LogObject("Unlinking: ", link);
+    }
+}
+
+unsigned int ObjectChain::GetLiveCount() {
+    return ObjectChain::Entries.size() - ObjectChain::FreeEntries.size();
+}
+
+unsigned int ObjectChain::GetLiveCount(Object::ObjectType type) {
+    return ObjectChain::LiveCounts[type];
+}
+
+unsigned long long ObjectChain::GetByteEstimate(Object::ObjectType type) {
+    return ObjectChain::ByteTotals[type];
+}
+
+unsigned long long ObjectChain::GetByteEstimate() {
+    unsigned long long bytes = 0;
+    for (unsigned int type = 0; type < Object::OBJECT_TYPE_COUNT; type++) {
+        bytes += ObjectChain::ByteTotals[type];
+    }
+    return bytes;
+}
+
+void ObjectChain::SetLoggingEnabled(bool enabled) {
+    ObjectChain::LoggingEnabled = enabled;
+}
+
+void ObjectChain::TrackBytes(Object* object, size_t byteSize) {
+    uint32_t index = object->m_ChainIndex;
+    if (index >= ObjectChain::Entries.size() || ObjectChain::Entries[index].object != object) {
+        return;
+    }
+    unsigned long long& total = ObjectChain::ByteTotals[ObjectChain::Entries[index].type];
+    total = total - object->m_ByteSize + byteSize;
+}
+
+void ObjectChain::LogObject(const char* action, Object* object) {
+    ObjectChain::Logger.Log(action + GetPointerString(object), Logger::LOG_DEBUG);
 }
@@ -1,158 +1,310 @@
 #include "Mantaray/OpenGL/ObjectLibrary.hpp"
+#include "Mantaray/OpenGL/RenderThread.hpp"
 #include "Mantaray/OpenGL/Object.hpp"
 #include "Mantaray/OpenGL/Objects/Shader.hpp"
 #include "Mantaray/OpenGL/Objects/Texture.hpp"
 #include "Mantaray/OpenGL/Objects/RenderTexture.hpp"
 #include "Mantaray/OpenGL/Objects/VertexArray.hpp"
+#include "Mantaray/OpenGL/Objects/SpriteBatch.hpp"
 #include "Mantaray/Core/Logger.hpp"
 
 using namespace MR;
 
-std::unordered_map<std::string, Object*> ObjectLibrary::Library = std::unordered_map<std::string, Object*>();
+std::vector<ObjectLibrary::Slot> ObjectLibrary::Slots = std::vector<ObjectLibrary::Slot>();
+std::vector<uint32_t> ObjectLibrary::FreeSlots = std::vector<uint32_t>();
+std::unordered_map<std::string, uint32_t> ObjectLibrary::NameIDs = std::unordered_map<std::string, uint32_t>();
+std::vector<std::string> ObjectLibrary::Names = std::vector<std::string>();
+std::vector<uint32_t> ObjectLibrary::NameSlots = std::vector<uint32_t>();
 Logger ObjectLibrary::Logger("ObjectLibrary");
 
-Shader* ObjectLibrary::CreateShader(std::string name, std::string vertexShaderPath, std::string fragmentShaderPath) {
+Shader* ObjectLibrary::CreateShader(std::string name, std::string vertexShaderPath, std::string fragmentShaderPath, Shader* fallback) {
     Shader* entry = nullptr;
-    bool alreadyExistent = ObjectLibrary::FindObject(name, entry);
-    if (alreadyExistent) {
+    if (ObjectLibrary::HasObject(name)) {
+        ObjectLibrary::FindObject(name, entry);
         ObjectLibrary::Logger.Log("Object " + name + " is already in library!", Logger::LOG_WARNING);
     }
     else {
+        RenderThread::ScopedContext context;
         entry = new Shader(vertexShaderPath, fragmentShaderPath);
-        ObjectLibrary::Library[name] = entry;
-        ObjectLibrary::Logger.Log("Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
+        entry->setFallback(fallback);
+        ObjectLibrary::AddEntry(name, entry);
+        MR_LOG("ObjectLibrary", "Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
     }
     return entry;
 }
 
-Shader* ObjectLibrary::CreateShader(std::string name, const char* vertexShaderSource, const char* fragmentShaderSource) {
+Shader* ObjectLibrary::CreateShader(std::string name, const char* vertexShaderSource, const char* fragmentShaderSource, Shader* fallback) {
     Shader* entry = nullptr;
-    bool alreadyExistent = ObjectLibrary::FindObject(name, entry);
-    if (alreadyExistent) {
+    if (ObjectLibrary::HasObject(name)) {
+        ObjectLibrary::FindObject(name, entry);
         ObjectLibrary::Logger.Log("Object " + name + " is already in library!", Logger::LOG_WARNING);
     }
     else {
+        RenderThread::ScopedContext context;
         entry = new Shader(vertexShaderSource, fragmentShaderSource);
-        ObjectLibrary::Library[name] = entry;
-        ObjectLibrary::Logger.Log("Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
+        entry->setFallback(fallback);
+        ObjectLibrary::AddEntry(name, entry);
+        MR_LOG("ObjectLibrary", "Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
     }
     return entry;    
 }
 
-Texture* ObjectLibrary::CreateTexture(std::string name, std::string imagePath) {
+Texture* ObjectLibrary::CreateTexture(std::string name, std::string imagePath, const TextureDescriptor& descriptor) {
     Texture* entry = nullptr;
-    bool alreadyExistent = ObjectLibrary::FindObject(name, entry);
-    if (alreadyExistent) {
+    if (ObjectLibrary::HasObject(name)) {
+        ObjectLibrary::FindObject(name, entry);
         ObjectLibrary::Logger.Log("Object " + name + " is already in library!", Logger::LOG_WARNING);
     }
     else {
-        entry = new Texture(imagePath);
-        ObjectLibrary::Library[name] = entry;
-        ObjectLibrary::Logger.Log("Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
+        RenderThread::ScopedContext context;
+        entry = new Texture(imagePath, descriptor);
+        ObjectLibrary::AddEntry(name, entry);
+        MR_LOG("ObjectLibrary", "Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
     }
     return entry;
 }
 
-Texture* ObjectLibrary::CreateTexture(std::string name, Image &image) {
+Texture* ObjectLibrary::CreateTexture(std::string name, Image &image, const TextureDescriptor& descriptor) {
     Texture* entry = nullptr;
-    bool alreadyExistent = ObjectLibrary::FindObject(name, entry);
-    if (alreadyExistent) {
+    if (ObjectLibrary::HasObject(name)) {
+        ObjectLibrary::FindObject(name, entry);
         ObjectLibrary::Logger.Log("Object " + name + " is already in library!", Logger::LOG_WARNING);
     }
     else {
-        entry = new Texture(image);
-        ObjectLibrary::Library[name] = entry;
-        ObjectLibrary::Logger.Log("Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
+        RenderThread::ScopedContext context;
+        entry = new Texture(image, descriptor);
+        ObjectLibrary::AddEntry(name, entry);
+        MR_LOG("ObjectLibrary", "Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
     }
     return entry;
 }
 
-Texture* ObjectLibrary::CreateTexture(std::string name, Vector2u resolution, int nrChannels) {
+Texture* ObjectLibrary::CreateTexture(std::string name, TextureSource &source, const TextureDescriptor& descriptor) {
     Texture* entry = nullptr;
-    bool alreadyExistent = ObjectLibrary::FindObject(name, entry);
-    if (alreadyExistent) {
+    if (ObjectLibrary::HasObject(name)) {
+        ObjectLibrary::FindObject(name, entry);
         ObjectLibrary::Logger.Log("Object " + name + " is already in library!", Logger::LOG_WARNING);
     }
     else {
-        entry = new Texture(resolution, nrChannels);
-        ObjectLibrary::Library[name] = entry;
-        ObjectLibrary::Logger.Log("Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
+        RenderThread::ScopedContext context;
+        entry = new Texture(source, descriptor);
+        ObjectLibrary::AddEntry(name, entry);
+        MR_LOG("ObjectLibrary", "Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
+    }
+    return entry;
+}
+
+Texture* ObjectLibrary::CreateTexture(std::string name, Vector2u resolution, int nrChannels, const TextureDescriptor& descriptor) {
+    Texture* entry = nullptr;
+    if (ObjectLibrary::HasObject(name)) {
+        ObjectLibrary::FindObject(name, entry);
+        ObjectLibrary::Logger.Log("Object " + name + " is already in library!", Logger::LOG_WARNING);
+    }
+    else {
+        RenderThread::ScopedContext context;
+        entry = new Texture(resolution, nrChannels, descriptor);
+        ObjectLibrary::AddEntry(name, entry);
+        MR_LOG("ObjectLibrary", "Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
     }
     return entry;
 }
 
 RenderTexture* ObjectLibrary::CreateRenderTexture(std::string name, Vector2u resolution) {
     RenderTexture* entry = nullptr;
-    bool alreadyExistent = ObjectLibrary::FindObject(name, entry);
-    if (alreadyExistent) {
+    if (ObjectLibrary::HasObject(name)) {
+        ObjectLibrary::FindObject(name, entry);
         ObjectLibrary::Logger.Log("Object " + name + " is already in library!", Logger::LOG_WARNING);
     }
     else {
+        RenderThread::ScopedContext context;
         entry = new RenderTexture(resolution);
-        ObjectLibrary::Library[name] = entry;
-        ObjectLibrary::Logger.Log("Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
+        ObjectLibrary::AddEntry(name, entry);
+        MR_LOG("ObjectLibrary", "Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
     }
     return entry;
 }
 
 RenderTexture* ObjectLibrary::CreateRenderTexture(std::string name, Vector2u resolution, Vector2f coordinateScale) {
     RenderTexture* entry = nullptr;
-    bool alreadyExistent = ObjectLibrary::FindObject(name, entry);
-    if (alreadyExistent) {
+    if (ObjectLibrary::HasObject(name)) {
+        ObjectLibrary::FindObject(name, entry);
         ObjectLibrary::Logger.Log("Object " + name + " is already in library!", Logger::LOG_WARNING);
     }
     else {
+        RenderThread::ScopedContext context;
         entry = new RenderTexture(resolution, coordinateScale);
-        ObjectLibrary::Library[name] = entry;
-        ObjectLibrary::Logger.Log("Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
+        ObjectLibrary::AddEntry(name, entry);
+        MR_LOG("ObjectLibrary", "Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
     }
     return entry;
 }
 
 VertexArray* ObjectLibrary::CreateVertexArray(std::string name) {
     VertexArray* entry = nullptr;
-    bool alreadyExistent = ObjectLibrary::FindObject(name, entry);
-    if (alreadyExistent) {
+    if (ObjectLibrary::HasObject(name)) {
+        ObjectLibrary::FindObject(name, entry);
         ObjectLibrary::Logger.Log("Object " + name + " is already in library!", Logger::LOG_WARNING);
     }
     else {
+        RenderThread::ScopedContext context;
         entry = new VertexArray();
-        ObjectLibrary::Library[name] = entry;
-        ObjectLibrary::Logger.Log("Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
+        ObjectLibrary::AddEntry(name, entry);
+        MR_LOG("ObjectLibrary", "Object " + name + " has been added to the library!", Logger::LOG_DEBUG);
     }
     return entry;
 }
 
 template<typename T>
 bool ObjectLibrary::FindObject(std::string name, T*& outObject) {
-    std::unordered_map<std::string, Object*>::const_iterator foundIterator = ObjectLibrary::Library.find(name);
-    if (foundIterator == ObjectLibrary::Library.end()) {
+    uint32_t nameID = LookupName(name);
+    if (nameID == NameIDs.size() || NameSlots[nameID] == 0) {
         ObjectLibrary::Logger.Log("Object " + name + " could not be found in the library!", Logger::LOG_WARNING);
         return false;
     }
-    T* foundEntry = dynamic_cast<T*>(foundIterator->second);
+    return FindObject(nameID, outObject);
+}
+
+template<typename T>
+bool ObjectLibrary::FindObject(uint32_t nameID, T*& outObject) {
+    uint32_t slotIndex;
+    Object* entry = FindEntry(nameID, slotIndex);
+    if (entry == nullptr) {
+        ObjectLibrary::Logger.Log("Object " + GetName(nameID) + " could not be found in the library!", Logger::LOG_WARNING);
+        return false;
+    }
+    T* foundEntry = dynamic_cast<T*>(entry);
     if (foundEntry == nullptr) {
-        ObjectLibrary::Logger.Log("Object " + name + " is not of the requested type!", Logger::LOG_WARNING);
+        ObjectLibrary::Logger.Log("Object " + GetName(nameID) + " is not of the requested type!", Logger::LOG_WARNING);
         return false;
     }
     outObject = foundEntry;
     return true;
 }
 
+bool ObjectLibrary::HasObject(std::string name) {
+    uint32_t slotIndex;
+    return FindEntry(LookupName(name), slotIndex) != nullptr;
+}
+
 bool ObjectLibrary::DeleteObject(std::string name) {
-    Object* entry;
-    bool existsInLibray = ObjectLibrary::FindObject(name, entry);
-    if (!existsInLibray) {
+    uint32_t slotIndex;
+    Object* entry = FindEntry(LookupName(name), slotIndex);
+    if (entry == nullptr) {
         ObjectLibrary::Logger.Log("Object " + name + " could not be found in the library!", Logger::LOG_WARNING);
         return false;
     }
+    RenderThread::ScopedContext context;
+    delete entry;
+    RemoveEntry(slotIndex);
+    MR_LOG("ObjectLibrary", "Object " + name + " has been removed from the library!", Logger::LOG_DEBUG);
+    return true;
+}
+
+template<typename T>
+bool ObjectLibrary::DeleteObject(Handle<T> handle) {
+    T* entry = Get(handle);
+    if (entry == nullptr) {
+        ObjectLibrary::Logger.Log("Cannot delete through a stale handle!", Logger::LOG_WARNING);
+        return false;
+    }
+    std::string name = GetName(Slots[handle.index].nameID);
+    RenderThread::ScopedContext context;
     delete entry;
-    entry = nullptr;
-    ObjectLibrary::Library.erase(name);
-    ObjectLibrary::Logger.Log("Object " + name + " has been removed from the library!", Logger::LOG_DEBUG);
+    RemoveEntry(handle.index);
+    MR_LOG("ObjectLibrary", "Object " + name + " has been removed from the library!", Logger::LOG_DEBUG);
     return true;
 }
 
+uint32_t ObjectLibrary::InternName(std::string name) {
+    std::unordered_map<std::string, uint32_t>::iterator it = NameIDs.find(name);
+    if (it != NameIDs.end()) {
+        return it->second;
+    }
+    uint32_t nameID = Names.size();
+    NameIDs[name] = nameID;
+    Names.push_back(name);
+    NameSlots.push_back(0);
+    return nameID;
+}
+
+std::string ObjectLibrary::GetName(uint32_t nameID) {
+    return (nameID < Names.size()) ? Names[nameID] : "";
+}
+
+template<typename T>
+Handle<T> ObjectLibrary::GetHandle(std::string name) {
+    return GetHandle<T>(LookupName(name));
+}
+
+template<typename T>
+Handle<T> ObjectLibrary::GetHandle(uint32_t nameID) {
+    uint32_t slotIndex;
+    Object* entry = FindEntry(nameID, slotIndex);
+    if (entry == nullptr || dynamic_cast<T*>(entry) == nullptr) {
+        return Handle<T>();
+    }
+    return Handle<T>(slotIndex, Slots[slotIndex].generation);
+}
+
+Object* ObjectLibrary::FindEntry(uint32_t nameID, uint32_t& slotIndex) {
+    if (nameID >= NameSlots.size() || NameSlots[nameID] == 0) {
+        return nullptr;
+    }
+    slotIndex = NameSlots[nameID] - 1;
+    return Slots[slotIndex].object;
+}
+
+void ObjectLibrary::AddEntry(std::string name, Object* object) {
+    uint32_t nameID = InternName(name);
+    uint32_t slotIndex;
+    if (!FreeSlots.empty()) {
+        slotIndex = FreeSlots.back();
+        FreeSlots.pop_back();
+    }
+    else {
+        slotIndex = Slots.size();
+        Slot slot;
+        slot.generation = 1;
+        Slots.push_back(slot);
+    }
+    Slots[slotIndex].object = object;
+    Slots[slotIndex].nameID = nameID;
+    NameSlots[nameID] = slotIndex + 1;
+}
+
+void ObjectLibrary::RemoveEntry(uint32_t slotIndex) {
+    Slot& slot = Slots[slotIndex];
+    NameSlots[slot.nameID] = 0;
+    slot.object = nullptr;
+    // Outstanding handles keep the old generation and stop resolving, 0 stays reserved for null handles
+    slot.generation++;
+    if (slot.generation == 0) {
+        slot.generation = 1;
+    }
+    FreeSlots.push_back(slotIndex);
+}
+
+// Looking a name up does not intern it, unknown names map to one past the last ID
+uint32_t ObjectLibrary::LookupName(const std::string& name) {
+    std::unordered_map<std::string, uint32_t>::const_iterator it = NameIDs.find(name);
+    return (it != NameIDs.end()) ? it->second : NameIDs.size();
+}
+
+// The library types are instantiated here so the template definitions can stay out of the header
+#define MR_INSTANTIATE_LIBRARY_TYPE(T) \
+    template bool ObjectLibrary::FindObject<T>(std::string, T*&); \
+    template bool ObjectLibrary::FindObject<T>(uint32_t, T*&); \
+    template bool ObjectLibrary::DeleteObject<T>(Handle<T>); \
+    template Handle<T> ObjectLibrary::GetHandle<T>(std::string); \
+    template Handle<T> ObjectLibrary::GetHandle<T>(uint32_t);
+
+MR_INSTANTIATE_LIBRARY_TYPE(Object)
+MR_INSTANTIATE_LIBRARY_TYPE(Shader)
+MR_INSTANTIATE_LIBRARY_TYPE(Texture)
+MR_INSTANTIATE_LIBRARY_TYPE(RenderTexture)
+MR_INSTANTIATE_LIBRARY_TYPE(VertexArray)
+#undef MR_INSTANTIATE_LIBRARY_TYPE
+
 const char* defaultTexturedVertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec2 vertexPosition;
@@ -185,6 +337,44 @@ void main() {
 }
 )";
 
+const char* defaultSpriteVertexShaderSource = R"(
+#version 330 core
+layout (location = 0) in vec2 vertexPosition;
+layout (location = 1) in vec4 instanceTransform;
+layout (location = 2) in vec3 instanceRotation;
+layout (location = 3) in vec4 instanceSource;
+layout (location = 4) in vec4 instanceColor;
+
+uniform mat4 u_projectionMatrix;
+
+out vec2 TexCoord;
+out vec4 Color;
+
+void main(){
+    vec2 size = instanceTransform.zw;
+    vec2 center = instanceRotation.yz * size;
+    vec2 local = vertexPosition * size - center;
+    float s = sin(instanceRotation.x);
+    float c = cos(instanceRotation.x);
+    local = vec2(local.x * c - local.y * s, local.x * s + local.y * c) + center;
+    gl_Position = u_projectionMatrix * vec4(instanceTransform.xy + local, 0.0, 1.0);
+    TexCoord = vertexPosition * instanceSource.zw + instanceSource.xy;
+    Color = instanceColor;
+}
+)";
+
+const char* defaultSpriteFragmentShaderSource = R"(
+#version 330 core
+out vec4 FragColor;
+in vec2 TexCoord;
+in vec4 Color;
+uniform sampler2D u_texture0;
+
+void main() {
+    FragColor = texture(u_texture0, TexCoord) * Color;
+}
+)";
+
 const char* defaultColoredVertexShaderSource = R"(
 #version 330 core
 layout (location = 0) in vec2 vertexPosition;
@@ -229,6 +419,8 @@ std::vector<int> defaultIndices = std::vector<int>({
 VertexArray* ObjectLibrary::DefaultVertexArray = nullptr;
 Shader* ObjectLibrary::DefaultTexturedShader = nullptr;
 Shader* ObjectLibrary::DefaultColoredShader = nullptr;
+SpriteBatch* ObjectLibrary::DefaultSpriteBatch = nullptr;
+Shader* ObjectLibrary::DefaultSpriteShader = nullptr;
 
 void ObjectLibrary::InitializeDefaultEntries() {
     if (ObjectLibrary::DefaultVertexArray == nullptr) {
@@ -244,4 +436,10 @@ void ObjectLibrary::InitializeDefaultEntries() {
     if (ObjectLibrary::DefaultColoredShader == nullptr) {
         ObjectLibrary::DefaultColoredShader = CreateShader("DefaultColoredShader", defaultColoredVertexShaderSource, defaultColoredFragmentShaderSource);
     }
+    if (ObjectLibrary::DefaultSpriteBatch == nullptr) {
+        ObjectLibrary::DefaultSpriteBatch = new SpriteBatch();
+    }
+    if (ObjectLibrary::DefaultSpriteShader == nullptr) {
+        ObjectLibrary::DefaultSpriteShader = CreateShader("DefaultSpriteShader", defaultSpriteVertexShaderSource, defaultSpriteFragmentShaderSource);
+    }
 }
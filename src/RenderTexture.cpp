@@ -9,9 +9,12 @@
 #include "Mantaray/OpenGL/Objects/Shader.hpp"
 #include "Mantaray/OpenGL/Objects/VertexArray.hpp"
 #include "Mantaray/OpenGL/Objects/Canvas.hpp"
+#include "Mantaray/OpenGL/Objects/SpriteBatch.hpp"
 #include "Mantaray/Core/Logger.hpp"
 #include "Mantaray/OpenGL/Drawables.hpp"
 #include "Mantaray/OpenGL/ObjectLibrary.hpp"
+#include "Mantaray/OpenGL/RenderThread.hpp"
+#include "Mantaray/OpenGL/FrameStatistics.hpp"
 #include "Mantaray/Core/Window.hpp"
 
 using namespace MR;
@@ -19,6 +22,8 @@ using namespace MR;
 VertexArray* RenderTexture::DefaultVertexArray = nullptr;
 Shader* RenderTexture::DefaultTexturedShader = nullptr;
 Shader* RenderTexture::DefaultColoredShader = nullptr;
+SpriteBatch* RenderTexture::DefaultSpriteBatch = nullptr;
+Shader* RenderTexture::DefaultSpriteShader = nullptr;
 
 RenderTexture::RenderTexture(Vector2u resolution) {
     m_Resolution = resolution;
@@ -42,20 +47,26 @@ RenderTexture::~RenderTexture() {
 
 void RenderTexture::setDefaults() {
     if (RenderTexture::DefaultVertexArray == nullptr) {
-        ObjectLibrary::FindObject("DefaultVertexArray", RenderTexture::DefaultVertexArray);
+        RenderTexture::DefaultVertexArray = ObjectLibrary::DefaultVertexArray;
     }
     if (RenderTexture::DefaultTexturedShader == nullptr) {
-        ObjectLibrary::FindObject("DefaultTexturedShader", RenderTexture::DefaultTexturedShader);
+        RenderTexture::DefaultTexturedShader = ObjectLibrary::DefaultTexturedShader;
     }
     if (RenderTexture::DefaultColoredShader == nullptr) {
-        ObjectLibrary::FindObject("DefaultColoredShader", RenderTexture::DefaultColoredShader);
+        RenderTexture::DefaultColoredShader = ObjectLibrary::DefaultColoredShader;
+    }
+    if (RenderTexture::DefaultSpriteBatch == nullptr) {
+        RenderTexture::DefaultSpriteBatch = ObjectLibrary::DefaultSpriteBatch;
+    }
+    if (RenderTexture::DefaultSpriteShader == nullptr) {
+        RenderTexture::DefaultSpriteShader = ObjectLibrary::DefaultSpriteShader;
     }
 }
 
 void RenderTexture::allocate() {
     glGenFramebuffers(1, &m_FBO);
     bind();
-    m_RenderTexture = new Texture(m_Resolution);
+    m_RenderTexture = new Texture(m_Resolution, Object::OBJECT_RENDER_ATTACHMENT);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_RenderTexture->m_TextureID, 0);
     unbind();
 }
@@ -73,7 +84,18 @@ void RenderTexture::unbind() {
     Context::BindFramebuffer(0);
 }
 
+Object::ObjectType RenderTexture::getObjectType() {
+    return Object::OBJECT_RENDER_TEXTURE;
+}
+
 void RenderTexture::clear(Color color) {
+    DrawCommand command;
+    command.type = DrawCommand::COMMAND_CLEAR;
+    command.color = color;
+    submit(command);
+}
+
+void RenderTexture::clearNow(Color color) {
     bind();
     glClearColor(
         color.r / 255.f,
@@ -128,6 +150,17 @@ void RenderTexture::setScaleCenter(Vector2f scaleCenter) {
     m_ScaleCenter = scaleCenter;
 }
 
+Rectanglef RenderTexture::getVisibleArea() {
+    // Inverse of the projection, screen = scale * (world - offset - center) + center
+    Vector2f center = Vector2f(m_ScaleCenter.x * m_CoordinateScale.x, m_ScaleCenter.y * m_CoordinateScale.y);
+    float scale = m_Scale != 0.f ? m_Scale : 1.f;
+    float x1 = m_Offset.x + center.x - center.x / scale;
+    float y1 = m_Offset.y + center.y - center.y / scale;
+    float x2 = m_Offset.x + center.x + (m_CoordinateScale.x - center.x) / scale;
+    float y2 = m_Offset.y + center.y + (m_CoordinateScale.y - center.y) / scale;
+    return Rectanglef(std::min(x1, x2), std::min(y1, y2), std::abs(x2 - x1), std::abs(y2 - y1));
+}
+
 void RenderTexture::draw(Sprite& sprite) {
     draw(
         sprite.texture,
@@ -142,16 +175,37 @@ void RenderTexture::draw(Sprite& sprite) {
     );
 }
 
+Shader* RenderTexture::resolveShader(Shader* shader) {
+    // Shaders still compiling in the background are replaced instead of stalling the draw on them
+    if (shader == nullptr || shader->isReady()) {
+        return shader;
+    }
+    return shader->getFallback();
+}
+
+RenderView RenderTexture::getView() {
+    RenderView view;
+    view.coordinateScale = m_CoordinateScale;
+    view.offset = m_Offset;
+    view.scale = m_Scale;
+    view.scaleCenter = m_ScaleCenter;
+    return view;
+}
+
 glm::mat4 RenderTexture::createProjectionMatrix(bool scaled, bool shifted) {
-    glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(m_CoordinateScale.x), 0.0f, static_cast<float>(m_CoordinateScale.y), -1.0f, 1.0f);
+    return RenderTexture::CreateProjectionMatrix(getView(), scaled, shifted);
+}
+
+glm::mat4 RenderTexture::CreateProjectionMatrix(RenderView view, bool scaled, bool shifted) {
+    glm::mat4 projection = glm::ortho(0.0f, static_cast<float>(view.coordinateScale.x), 0.0f, static_cast<float>(view.coordinateScale.y), -1.0f, 1.0f);
 
-    if (scaled && m_Scale != 0.f) {
-        projection = glm::translate(projection, glm::vec3(m_ScaleCenter.x * m_CoordinateScale.x, m_ScaleCenter.y * m_CoordinateScale.y, 0.0f));
-        projection = glm::scale(projection, glm::vec3(m_Scale));
-        projection = glm::translate(projection, -glm::vec3(m_ScaleCenter.x * m_CoordinateScale.x, m_ScaleCenter.y * m_CoordinateScale.y, 0.0f));
+    if (scaled && view.scale != 0.f) {
+        projection = glm::translate(projection, glm::vec3(view.scaleCenter.x * view.coordinateScale.x, view.scaleCenter.y * view.coordinateScale.y, 0.0f));
+        projection = glm::scale(projection, glm::vec3(view.scale));
+        projection = glm::translate(projection, -glm::vec3(view.scaleCenter.x * view.coordinateScale.x, view.scaleCenter.y * view.coordinateScale.y, 0.0f));
     }
-    if (shifted && m_Offset != Vector2f(0, 0)) {
-        projection = glm::translate(projection, glm::vec3(-m_Offset.x, -m_Offset.y, 0));
+    if (shifted && view.offset != Vector2f(0, 0)) {
+        projection = glm::translate(projection, glm::vec3(-view.offset.x, -view.offset.y, 0));
     }
 
     return projection;
@@ -185,36 +239,18 @@ void RenderTexture::draw(
         return;
     }
 
-    Shader* shaderToUse = shader;
-    if (shaderToUse == nullptr) {
-        shaderToUse = RenderTexture::DefaultTexturedShader;
-    }
-    shaderToUse->setTexture("u_texture0", 0, *texture);
-    
-    glm::mat4 projection = createProjectionMatrix();
-    shaderToUse->setUniformMatrix4("u_projectionMatrix", projection);
-
-    glm::mat4 model;
-    if (absoluteSize) {
-        model = createModelMatrix(position, size, rotation, rotationCenter);
-    }
-    else {
-        Vector2f trueSize = Vector2f(
-            size.x * texture->getWidth() * sourceRectangle.width(), 
-            size.y * texture->getHeight() * sourceRectangle.height()
-        );
-        Vector2f trueRotationCenter = Vector2f(
-            rotationCenter.x * size.x * texture->getWidth() * sourceRectangle.width(), 
-            rotationCenter.y * size.y * texture->getHeight() * sourceRectangle.height()
-        );
-        model = createModelMatrix(position, trueSize, rotation, trueRotationCenter);
-    }
-
-    shaderToUse->setUniformMatrix4("u_modelMatrix", model);
-    shaderToUse->setUniformVector4f("u_textureSource", Vector4f(sourceRectangle.x(), sourceRectangle.y(), sourceRectangle.width(), sourceRectangle.height()));
-    shaderToUse->setUniformVector4f("u_color", Vector4f(color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f));
-    shaderToUse->setupForDraw();
-    RenderTexture::DefaultVertexArray->draw();
+    DrawCommand command;
+    command.type = DrawCommand::COMMAND_TEXTURE;
+    command.texture = texture;
+    command.position = position;
+    command.size = size;
+    command.absoluteSize = absoluteSize;
+    command.rotation = rotation;
+    command.rotationCenter = rotationCenter;
+    command.sourceRectangle = sourceRectangle;
+    command.color = color;
+    command.shader = shader;
+    submit(command);
 }
 
 void RenderTexture::draw(Polygon& polygon) {
@@ -248,7 +284,143 @@ void RenderTexture::draw(
         return;
     }
 
-    Shader* shaderToUse = shader;
+    DrawCommand command;
+    command.type = DrawCommand::COMMAND_VERTEX_ARRAY;
+    command.vertexArray = vertexArray;
+    command.position = position;
+    command.size = size;
+    command.absoluteSize = absoluteSize;
+    command.rotation = rotation;
+    command.rotationCenter = rotationCenter;
+    command.color = color;
+    command.shader = shader;
+    command.texture = texture;
+    command.sourceRectangle = sourceRectangle;
+    submit(command);
+}
+
+void RenderTexture::draw(Canvas* canvas) {
+    Window* windowInstance = Window::GetInstance();
+    if (windowInstance == nullptr) {
+        return;
+    }
+
+    DrawCommand command;
+    command.type = DrawCommand::COMMAND_CANVAS;
+    command.canvas = canvas;
+    command.position = Vector2f(
+        canvas->getDisplaySpace().x() * windowInstance->getCoordinateScale().x,
+        canvas->getDisplaySpace().y() * windowInstance->getCoordinateScale().y
+    );
+    command.size = Vector2f(
+        canvas->getDisplaySpace().width() * windowInstance->getCoordinateScale().x,
+        canvas->getDisplaySpace().height() * windowInstance->getCoordinateScale().y
+    );
+    command.shader = canvas->m_DisplayShader;
+    command.color = canvas->m_Color;
+    submit(command);
+}
+
+void RenderTexture::draw(const SpriteInstance* instances, unsigned int count, Texture* texture, Shader* shader) {
+    if (texture == nullptr || count == 0) {
+        return;
+    }
+
+    DrawCommand command;
+    command.type = DrawCommand::COMMAND_SPRITE_INSTANCES;
+    command.texture = texture;
+    command.shader = shader;
+    command.instances = instances;
+    command.instanceCount = count;
+    submit(command);
+}
+
+void RenderTexture::submit(DrawCommand& command) {
+    command.target = this;
+    command.view = getView();
+    if (RenderThread::IsRecording()) {
+        FramePacket& packet = RenderThread::GetRecordingPacket();
+        if (command.type == DrawCommand::COMMAND_SPRITE_INSTANCES) {
+            // The caller may reuse its array as soon as this returns
+            command.instanceOffset = packet.instances.size();
+            packet.instances.insert(packet.instances.end(), command.instances, command.instances + command.instanceCount);
+            command.instances = nullptr;
+        }
+        packet.commands.push_back(command);
+        return;
+    }
+    execute(command);
+}
+
+void RenderTexture::execute(const DrawCommand& command) {
+    switch (command.type) {
+        case DrawCommand::COMMAND_CLEAR:
+            clearNow(command.color);
+            break;
+        case DrawCommand::COMMAND_TEXTURE:
+            drawTexture(command);
+            break;
+        case DrawCommand::COMMAND_VERTEX_ARRAY:
+            drawVertexArray(command);
+            break;
+        case DrawCommand::COMMAND_CANVAS:
+            drawCanvas(command);
+            break;
+        case DrawCommand::COMMAND_SPRITE_INSTANCES:
+            drawSpriteInstances(command);
+            break;
+        case DrawCommand::COMMAND_UNIFORM:
+            break;
+    }
+}
+
+void RenderTexture::drawTexture(const DrawCommand& command) {
+    Texture* texture = command.texture;
+    Vector2f size = command.size;
+    Vector2f rotationCenter = command.rotationCenter;
+    Rectanglef sourceRectangle = command.sourceRectangle;
+    Color color = command.color;
+
+    Shader* shaderToUse = resolveShader(command.shader);
+    if (shaderToUse == nullptr) {
+        shaderToUse = RenderTexture::DefaultTexturedShader;
+    }
+    shaderToUse->setTexture("u_texture0", 0, *texture);
+    
+    glm::mat4 projection = RenderTexture::CreateProjectionMatrix(command.view);
+    shaderToUse->setUniformMatrix4("u_projectionMatrix", projection);
+
+    glm::mat4 model;
+    if (command.absoluteSize) {
+        model = createModelMatrix(command.position, size, command.rotation, rotationCenter);
+    }
+    else {
+        Vector2f trueSize = Vector2f(
+            size.x * texture->getWidth() * sourceRectangle.width(), 
+            size.y * texture->getHeight() * sourceRectangle.height()
+        );
+        Vector2f trueRotationCenter = Vector2f(
+            rotationCenter.x * size.x * texture->getWidth() * sourceRectangle.width(), 
+            rotationCenter.y * size.y * texture->getHeight() * sourceRectangle.height()
+        );
+        model = createModelMatrix(command.position, trueSize, command.rotation, trueRotationCenter);
+    }
+
+    shaderToUse->setUniformMatrix4("u_modelMatrix", model);
+    shaderToUse->setUniformVector4f("u_textureSource", Vector4f(sourceRectangle.x(), sourceRectangle.y(), sourceRectangle.width(), sourceRectangle.height()));
+    shaderToUse->setUniformVector4f("u_color", Vector4f(color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f));
+    shaderToUse->setupForDraw();
+    RenderTexture::DefaultVertexArray->draw();
+}
+
+void RenderTexture::drawVertexArray(const DrawCommand& command) {
+    Texture* texture = command.texture;
+    Vector2f size = command.size;
+    Vector2f rotationCenter = command.rotationCenter;
+    Rectanglef sourceRectangle = command.sourceRectangle;
+    Color color = command.color;
+
+    Shader* shaderToUse = resolveShader(command.shader);
     if (shaderToUse == nullptr) {
         if (texture != nullptr) {
             shaderToUse = RenderTexture::DefaultTexturedShader;
@@ -263,12 +435,12 @@ void RenderTexture::draw(
         }
     }
     
-    glm::mat4 projection = createProjectionMatrix();
+    glm::mat4 projection = RenderTexture::CreateProjectionMatrix(command.view);
     shaderToUse->setUniformMatrix4("u_projectionMatrix", projection);
 
     glm::mat4 model;
-    if (absoluteSize) {
-        model = createModelMatrix(position, size, rotation, rotationCenter);
+    if (command.absoluteSize) {
+        model = createModelMatrix(command.position, size, command.rotation, rotationCenter);
     }
     else {
         Vector2f trueSize = Vector2f(
@@ -279,45 +451,37 @@ void RenderTexture::draw(
             rotationCenter.x * size.x * texture->getWidth() * sourceRectangle.width(), 
             rotationCenter.y * size.y * texture->getHeight() * sourceRectangle.height()
         );
-        model = createModelMatrix(position, trueSize, rotation, trueRotationCenter);
+        model = createModelMatrix(command.position, trueSize, command.rotation, trueRotationCenter);
     }
 
     shaderToUse->setUniformMatrix4("u_modelMatrix", model);
     shaderToUse->setUniformVector4f("u_color", Vector4f(color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f));
     shaderToUse->setupForDraw();
-    vertexArray->draw();    
+    command.vertexArray->draw();    
 }
 
-void RenderTexture::draw(Canvas* canvas) {
-    Window* windowInstance = Window::GetInstance();
-    if (windowInstance == nullptr) {
-        return;
-    }
-    glm::mat4 projection = createProjectionMatrix(false, false);
-    Rectanglef displayRect = Rectanglef(
-        canvas->getDisplaySpace().x() * windowInstance->getCoordinateScale().x,
-        canvas->getDisplaySpace().y() * windowInstance->getCoordinateScale().y,
-        canvas->getDisplaySpace().width() * windowInstance->getCoordinateScale().x,
-        canvas->getDisplaySpace().height() * windowInstance->getCoordinateScale().y
-    );
-    
+void RenderTexture::drawCanvas(const DrawCommand& command) {
+    Canvas* canvas = command.canvas;
+    glm::mat4 projection = RenderTexture::CreateProjectionMatrix(command.view, false, false);
     glm::mat4 model = createModelMatrix(
-        displayRect.position,
-        displayRect.size,
+        command.position,
+        command.size,
         0, Vector2f(0, 0)
     );
     
-
-    Shader* shaderToUse = canvas->m_DisplayShader;
+    Shader* shaderToUse = resolveShader(command.shader);
+    if (shaderToUse == nullptr) {
+        shaderToUse = RenderTexture::DefaultTexturedShader;
+    }
     shaderToUse->setUniformMatrix4("u_projectionMatrix", projection);
     shaderToUse->setUniformMatrix4("u_modelMatrix", model);
     shaderToUse->setUniformVector4f(
         "u_color", 
         Vector4f(
-            canvas->m_Color.r / 255.f, 
-            canvas->m_Color.g / 255.f, 
-            canvas->m_Color.b / 255.f, 
-            canvas->m_Color.a / 255.f
+            command.color.r / 255.f, 
+            command.color.g / 255.f, 
+            command.color.b / 255.f, 
+            command.color.a / 255.f
         )
     );
     shaderToUse->setRenderTexture("u_texture0", 0, *canvas);
@@ -326,6 +490,17 @@ void RenderTexture::draw(Canvas* canvas) {
     RenderTexture::DefaultVertexArray->draw();    
 }
 
+void RenderTexture::drawSpriteInstances(const DrawCommand& command) {
+    Shader* shaderToUse = resolveShader(command.shader);
+    if (shaderToUse == nullptr) {
+        shaderToUse = RenderTexture::DefaultSpriteShader;
+    }
+    shaderToUse->setTexture("u_texture0", 0, *command.texture);
+    shaderToUse->setUniformMatrix4("u_projectionMatrix", RenderTexture::CreateProjectionMatrix(command.view));
+    shaderToUse->setupForDraw();
+    RenderTexture::DefaultSpriteBatch->draw(command.instances, command.instanceCount);
+}
+
 void RenderTexture::drawLine(Vector2f p1, Vector2f p2, float thickness, Color color) {
     Vector2f direction = Vector2f(p2.x - p1.x, p2.y - p1.y);
     float angle = -std::atan2(direction.x, direction.y);
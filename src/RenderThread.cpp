@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/matrix.hpp>
+
+#include "Mantaray/OpenGL/RenderThread.hpp"
+#include "Mantaray/OpenGL/FrameStatistics.hpp"
+#include "Mantaray/OpenGL/Objects/RenderTexture.hpp"
+#include "Mantaray/OpenGL/Objects/Shader.hpp"
+#include "Mantaray/OpenGL/Objects/Texture.hpp"
+#include "Mantaray/Core/Window.hpp"
+#include "Mantaray/Core/Logger.hpp"
+
+using namespace MR;
+
+GLFWwindow* RenderThread::WindowHandle = nullptr;
+std::thread RenderThread::Thread;
+std::mutex RenderThread::Mutex;
+std::condition_variable RenderThread::Condition;
+std::vector<FramePacket> RenderThread::Packets = std::vector<FramePacket>();
+unsigned long long RenderThread::SubmittedCount = 0;
+unsigned long long RenderThread::RenderedCount = 0;
+bool RenderThread::Running = false;
+bool RenderThread::StopRequested = false;
+bool RenderThread::ContextRequested = false;
+bool RenderThread::ContextReleased = false;
+thread_local unsigned int RenderThread::ContextDepth = 0;
+
+void RenderThread::Start(GLFWwindow* window, unsigned int packetCount) {
+    if (RenderThread::Running) {
+        Logger::Log("RenderThread", "Render thread is already running", Logger::LOG_WARNING);
+        return;
+    }
+    RenderThread::WindowHandle = window;
+    RenderThread::Packets = std::vector<FramePacket>(std::min(std::max(packetCount, 2u), 3u));
+    RenderThread::SubmittedCount = 0;
+    RenderThread::RenderedCount = 0;
+    RenderThread::StopRequested = false;
+    RenderThread::ContextRequested = false;
+    RenderThread::ContextReleased = false;
+
+    // The context can only be current on one thread at a time
+    glFlush();
+    glfwMakeContextCurrent(nullptr);
+    RenderThread::Running = true;
+    RenderThread::Thread = std::thread(RenderThread::Run);
+
+    // A thread still joinable when its std::thread is destroyed terminates the program
+    static bool registeredExitHandler = false;
+    if (!registeredExitHandler) {
+        atexit(RenderThread::Stop);
+        registeredExitHandler = true;
+    }
+}
+
+void RenderThread::Stop() {
+    if (!RenderThread::Running) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(RenderThread::Mutex);
+        RenderThread::StopRequested = true;
+    }
+    RenderThread::Condition.notify_all();
+    RenderThread::Thread.join();
+    RenderThread::Running = false;
+    glfwMakeContextCurrent(RenderThread::WindowHandle);
+    RenderThread::Packets.clear();
+}
+
+FramePacket& RenderThread::GetRecordingPacket() {
+    return RenderThread::Packets[RenderThread::SubmittedCount % RenderThread::Packets.size()];
+}
+
+UniformCommand& RenderThread::RecordUniform(Shader* shader, const std::string& name, UniformCommand::Type type) {
+    FramePacket& packet = RenderThread::GetRecordingPacket();
+    DrawCommand command;
+    command.type = DrawCommand::COMMAND_UNIFORM;
+    command.shader = shader;
+    command.uniform = packet.uniformCount;
+    packet.commands.push_back(command);
+    return packet.addUniform(name, type);
+}
+
+void RenderThread::Submit(const PresentInfo& present) {
+    RenderThread::GetRecordingPacket().present = present;
+    std::unique_lock<std::mutex> lock(RenderThread::Mutex);
+    RenderThread::SubmittedCount++;
+    RenderThread::Condition.notify_all();
+    RenderThread::Condition.wait(lock, [] {
+        return RenderThread::SubmittedCount - RenderThread::RenderedCount < RenderThread::Packets.size();
+    });
+    // The render thread is done with the packet that gets recorded next
+    RenderThread::GetRecordingPacket().clear();
+}
+
+void RenderThread::Synchronize() {
+    if (!RenderThread::Running) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(RenderThread::Mutex);
+    RenderThread::Condition.wait(lock, [] {
+        return RenderThread::RenderedCount == RenderThread::SubmittedCount;
+    });
+}
+
+void RenderThread::AcquireContext() {
+    if (!RenderThread::Running || RenderThread::ContextDepth++ > 0) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(RenderThread::Mutex);
+    RenderThread::ContextRequested = true;
+    RenderThread::Condition.notify_all();
+    RenderThread::Condition.wait(lock, [] {
+        return RenderThread::ContextReleased;
+    });
+    lock.unlock();
+    glfwMakeContextCurrent(RenderThread::WindowHandle);
+}
+
+void RenderThread::ReleaseContext() {
+    if (!RenderThread::Running || RenderThread::ContextDepth == 0 || --RenderThread::ContextDepth > 0) {
+        return;
+    }
+    glFlush();
+    glfwMakeContextCurrent(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(RenderThread::Mutex);
+        RenderThread::ContextRequested = false;
+    }
+    RenderThread::Condition.notify_all();
+}
+
+void RenderThread::Run() {
+    RenderThread::ContextDepth = 1;
+    glfwMakeContextCurrent(RenderThread::WindowHandle);
+
+    std::unique_lock<std::mutex> lock(RenderThread::Mutex);
+    while (true) {
+        RenderThread::Condition.wait(lock, [] {
+            return RenderThread::RenderedCount < RenderThread::SubmittedCount || RenderThread::ContextRequested || RenderThread::StopRequested;
+        });
+        // Queued packets are always rendered first, so the context is handed over and the thread stops
+        // with nothing left that could reference a deleted object
+        if (RenderThread::RenderedCount < RenderThread::SubmittedCount) {
+            FramePacket& packet = RenderThread::Packets[RenderThread::RenderedCount % RenderThread::Packets.size()];
+            lock.unlock();
+            RenderThread::Execute(packet);
+            lock.lock();
+            RenderThread::RenderedCount++;
+            RenderThread::Condition.notify_all();
+        }
+        else if (RenderThread::ContextRequested) {
+            glFlush();
+            glfwMakeContextCurrent(nullptr);
+            RenderThread::ContextReleased = true;
+            RenderThread::Condition.notify_all();
+            RenderThread::Condition.wait(lock, [] {
+                return !RenderThread::ContextRequested;
+            });
+            RenderThread::ContextReleased = false;
+            glfwMakeContextCurrent(RenderThread::WindowHandle);
+        }
+        else if (RenderThread::StopRequested) {
+            break;
+        }
+    }
+    glFlush();
+    glfwMakeContextCurrent(nullptr);
+}
+
+void RenderThread::Execute(FramePacket& packet) {
+    FrameStatistics::AddCulledObjects(packet.culledObjects);
+    for (const DrawCommand& command : packet.commands) {
+        if (command.type == DrawCommand::COMMAND_SPRITE_INSTANCES) {
+            DrawCommand resolved = command;
+            resolved.instances = packet.instances.data() + command.instanceOffset;
+            command.target->execute(resolved);
+            continue;
+        }
+        if (command.type != DrawCommand::COMMAND_UNIFORM) {
+            command.target->execute(command);
+            continue;
+        }
+        UniformCommand& uniform = packet.uniforms[command.uniform];
+        switch (uniform.type) {
+            case UniformCommand::UNIFORM_INTEGER:
+                command.shader->setUniformInteger(uniform.name, uniform.integer);
+                break;
+            case UniformCommand::UNIFORM_FLOAT:
+                command.shader->setUniformFloat(uniform.name, uniform.values[0]);
+                break;
+            case UniformCommand::UNIFORM_VECTOR2F:
+                command.shader->setUniformVector2f(uniform.name, Vector2f(uniform.values[0], uniform.values[1]));
+                break;
+            case UniformCommand::UNIFORM_VECTOR3F:
+                command.shader->setUniformVector3f(uniform.name, Vector3f(uniform.values[0], uniform.values[1], uniform.values[2]));
+                break;
+            case UniformCommand::UNIFORM_VECTOR4F:
+                command.shader->setUniformVector4f(uniform.name, Vector4f(uniform.values[0], uniform.values[1], uniform.values[2], uniform.values[3]));
+                break;
+            case UniformCommand::UNIFORM_MATRIX4:
+                command.shader->setUniformMatrix4(uniform.name, glm::make_mat4(uniform.values));
+                break;
+            case UniformCommand::UNIFORM_TEXTURE:
+                command.shader->setTexture(uniform.name, uniform.integer, *uniform.texture);
+                break;
+            case UniformCommand::UNIFORM_RENDER_TEXTURE:
+                command.shader->setRenderTexture(uniform.name, uniform.integer, *uniform.renderTexture);
+                break;
+        }
+    }
+
+    MR::Window* window = MR::Window::GetInstance();
+    if (window != nullptr) {
+        window->presentFrame(packet.present);
+        window->finishFrame(packet.present);
+    }
+}
@@ -0,0 +1,551 @@
+#include <cmath>
+
+#include "Mantaray/Core/SceneGraph.hpp"
+#include "Mantaray/Core/Logger.hpp"
+#include "Mantaray/OpenGL/Drawables.hpp"
+#include "Mantaray/OpenGL/Objects/RenderTexture.hpp"
+
+using namespace MR;
+
+SceneGraph::SceneGraph() {
+    clear();
+}
+
+void SceneGraph::clear() {
+    if (m_Records.empty()) {
+        m_Records.push_back(NodeRecord());
+    }
+    // Generations survive the clear so nodes from before it stay stale
+    m_FreeRecords.clear();
+    for (uint32_t index = m_Records.size() - 1; index > 0; index--) {
+        NodeRecord& record = m_Records[index];
+        uint32_t generation = record.generation;
+        if (record.alive) {
+            generation = generation + 1 == 0 ? 1 : generation + 1;
+        }
+        record = NodeRecord();
+        record.generation = generation;
+        m_FreeRecords.push_back(index);
+    }
+    m_Records[0] = NodeRecord();
+    m_Records[0].alive = true;
+    m_NodeCount = 0;
+    m_OrderDirty = false;
+    m_UpdatedCount = 0;
+
+    m_Indices.assign(1, 0);
+    m_ParentPositions.assign(1, 0);
+    m_SubtreeSizes.assign(1, 1);
+    m_LocalTransforms.assign(1, NodeTransform());
+    m_WorldTransforms.assign(1, WorldTransform());
+    m_Flags.assign(1, FLAG_VISIBLE);
+    m_Drawables.assign(1, nullptr);
+    m_DrawableTypes.assign(1, DRAWABLE_NONE);
+}
+
+SceneNode SceneGraph::createNode(SceneNode parent) {
+    return attachNode(parent, nullptr, DRAWABLE_NONE);
+}
+
+SceneNode SceneGraph::createNode(Sprite* sprite, SceneNode parent) {
+    return attachNode(parent, sprite, DRAWABLE_SPRITE);
+}
+
+SceneNode SceneGraph::createNode(Polygon* polygon, SceneNode parent) {
+    return attachNode(parent, polygon, DRAWABLE_POLYGON);
+}
+
+SceneNode SceneGraph::attachNode(SceneNode parent, Drawable* drawable, DrawableType type) {
+    uint32_t parentIndex = 0;
+    if (!parent.isNull()) {
+        if (findRecord(parent) == nullptr) {
+            Logger::Log("SceneGraph", "Cannot attach a node to a stale parent!", Logger::LOG_WARNING);
+            return SceneNode();
+        }
+        parentIndex = parent.index;
+    }
+
+    uint32_t index;
+    if (!m_FreeRecords.empty()) {
+        index = m_FreeRecords.back();
+        m_FreeRecords.pop_back();
+    }
+    else {
+        index = m_Records.size();
+        m_Records.push_back(NodeRecord());
+    }
+
+    // Appended out of order, rebuildOrder moves the node into place
+    NodeRecord& record = m_Records[index];
+    record.alive = true;
+    record.position = m_Indices.size();
+    m_Indices.push_back(index);
+    m_ParentPositions.push_back(0);
+    m_SubtreeSizes.push_back(1);
+    m_LocalTransforms.push_back(NodeTransform());
+    m_WorldTransforms.push_back(WorldTransform());
+    m_Flags.push_back(FLAG_DIRTY | FLAG_VISIBLE);
+    m_Drawables.push_back(drawable);
+    m_DrawableTypes.push_back(type);
+
+    link(index, parentIndex);
+    m_OrderDirty = true;
+    m_NodeCount++;
+
+    SceneNode node;
+    node.index = index;
+    node.generation = record.generation;
+    return node;
+}
+
+void SceneGraph::destroyNode(SceneNode node) {
+    if (findRecord(node) == nullptr) {
+        Logger::Log("SceneGraph", "Cannot destroy a stale node!", Logger::LOG_WARNING);
+        return;
+    }
+    unlink(node.index);
+
+    m_Stack.clear();
+    m_Stack.push_back(node.index);
+    while (!m_Stack.empty()) {
+        uint32_t index = m_Stack.back();
+        m_Stack.pop_back();
+        NodeRecord& record = m_Records[index];
+        for (uint32_t child = record.firstChild; child != 0; child = m_Records[child].nextSibling) {
+            m_Stack.push_back(child);
+        }
+        uint32_t generation = record.generation + 1 == 0 ? 1 : record.generation + 1;
+        record = NodeRecord();
+        record.generation = generation;
+        m_FreeRecords.push_back(index);
+        m_NodeCount--;
+    }
+    m_OrderDirty = true;
+}
+
+bool SceneGraph::isAlive(SceneNode node) {
+    return findRecord(node) != nullptr;
+}
+
+unsigned int SceneGraph::getNodeCount() {
+    return m_NodeCount;
+}
+
+void SceneGraph::setParent(SceneNode node, SceneNode parent) {
+    NodeRecord* record = findRecord(node);
+    if (record == nullptr || (!parent.isNull() && findRecord(parent) == nullptr)) {
+        Logger::Log("SceneGraph", "Cannot reparent stale nodes!", Logger::LOG_WARNING);
+        return;
+    }
+    uint32_t parentIndex = parent.isNull() ? 0 : parent.index;
+    for (uint32_t ancestor = parentIndex; ancestor != 0; ancestor = m_Records[ancestor].parent) {
+        if (ancestor == node.index) {
+            Logger::Log("SceneGraph", "Cannot make a node a child of itself or of its descendants!", Logger::LOG_WARNING);
+            return;
+        }
+    }
+    unlink(node.index);
+    link(node.index, parentIndex);
+    m_Flags[record->position] |= FLAG_DIRTY;
+    m_OrderDirty = true;
+}
+
+SceneNode SceneGraph::getParent(SceneNode node) {
+    SceneNode parent;
+    NodeRecord* record = findRecord(node);
+    if (record != nullptr && record->parent != 0) {
+        parent.index = record->parent;
+        parent.generation = m_Records[record->parent].generation;
+    }
+    return parent;
+}
+
+void SceneGraph::setSprite(SceneNode node, Sprite* sprite) {
+    NodeRecord* record = findRecord(node);
+    if (record == nullptr) {
+        return;
+    }
+    m_Drawables[record->position] = sprite;
+    m_DrawableTypes[record->position] = sprite != nullptr ? DRAWABLE_SPRITE : DRAWABLE_NONE;
+}
+
+void SceneGraph::setPolygon(SceneNode node, Polygon* polygon) {
+    NodeRecord* record = findRecord(node);
+    if (record == nullptr) {
+        return;
+    }
+    m_Drawables[record->position] = polygon;
+    m_DrawableTypes[record->position] = polygon != nullptr ? DRAWABLE_POLYGON : DRAWABLE_NONE;
+}
+
+void SceneGraph::clearDrawable(SceneNode node) {
+    setSprite(node, nullptr);
+}
+
+void SceneGraph::setVisible(SceneNode node, bool visible) {
+    NodeRecord* record = findRecord(node);
+    if (record == nullptr) {
+        return;
+    }
+    if (visible) {
+        m_Flags[record->position] |= FLAG_VISIBLE;
+    }
+    else {
+        m_Flags[record->position] &= ~FLAG_VISIBLE;
+    }
+}
+
+bool SceneGraph::getVisible(SceneNode node) {
+    NodeRecord* record = findRecord(node);
+    return record != nullptr && (m_Flags[record->position] & FLAG_VISIBLE);
+}
+
+NodeTransform SceneGraph::getLocalTransform(SceneNode node) {
+    NodeRecord* record = findRecord(node);
+    if (record == nullptr) {
+        return NodeTransform();
+    }
+    return m_LocalTransforms[record->position];
+}
+
+void SceneGraph::setLocalTransform(SceneNode node, NodeTransform transform) {
+    NodeRecord* record = findRecord(node);
+    if (record == nullptr) {
+        return;
+    }
+    m_LocalTransforms[record->position] = transform;
+    markDirty(record->position);
+}
+
+void SceneGraph::setPosition(SceneNode node, Vector2f position) {
+    NodeRecord* record = findRecord(node);
+    if (record == nullptr) {
+        return;
+    }
+    m_LocalTransforms[record->position].position = position;
+    markDirty(record->position);
+}
+
+void SceneGraph::setRotation(SceneNode node, float rotation) {
+    NodeRecord* record = findRecord(node);
+    if (record == nullptr) {
+        return;
+    }
+    m_LocalTransforms[record->position].rotation = rotation;
+    markDirty(record->position);
+}
+
+void SceneGraph::setScale(SceneNode node, Vector2f scale) {
+    NodeRecord* record = findRecord(node);
+    if (record == nullptr) {
+        return;
+    }
+    m_LocalTransforms[record->position].scale = scale;
+    markDirty(record->position);
+}
+
+Vector2f SceneGraph::getWorldPosition(SceneNode node) {
+    WorldTransform& world = getWorldTransform(node);
+    return Vector2f(world.x, world.y);
+}
+
+float SceneGraph::getWorldRotation(SceneNode node) {
+    WorldTransform& world = getWorldTransform(node);
+    return std::atan2(world.b, world.a);
+}
+
+Vector2f SceneGraph::getWorldScale(SceneNode node) {
+    WorldTransform& world = getWorldTransform(node);
+    float scaleY = std::sqrt(world.c * world.c + world.d * world.d);
+    // A mirrored transform keeps its rotation and flips the y axis
+    if (world.a * world.d - world.b * world.c < 0.f) {
+        scaleY = -scaleY;
+    }
+    return Vector2f(std::sqrt(world.a * world.a + world.b * world.b), scaleY);
+}
+
+Vector2f SceneGraph::transformPoint(SceneNode node, Vector2f localPoint) {
+    WorldTransform& world = getWorldTransform(node);
+    return Vector2f(
+        world.a * localPoint.x + world.c * localPoint.y + world.x,
+        world.b * localPoint.x + world.d * localPoint.y + world.y
+    );
+}
+
+SceneGraph::WorldTransform& SceneGraph::getWorldTransform(SceneNode node) {
+    NodeRecord* record = findRecord(node);
+    if (record == nullptr) {
+        Logger::Log("SceneGraph", "Cannot get the world transform of a stale node!", Logger::LOG_WARNING);
+        return m_WorldTransforms[0];
+    }
+    update();
+    return m_WorldTransforms[record->position];
+}
+
+SceneGraph::NodeRecord* SceneGraph::findRecord(SceneNode node) {
+    if (node.index == 0 || node.index >= m_Records.size()) {
+        return nullptr;
+    }
+    NodeRecord& record = m_Records[node.index];
+    if (!record.alive || record.generation != node.generation) {
+        return nullptr;
+    }
+    return &record;
+}
+
+void SceneGraph::link(uint32_t index, uint32_t parent) {
+    NodeRecord& record = m_Records[index];
+    NodeRecord& parentRecord = m_Records[parent];
+    record.parent = parent;
+    record.nextSibling = 0;
+    record.previousSibling = parentRecord.lastChild;
+    if (parentRecord.lastChild != 0) {
+        m_Records[parentRecord.lastChild].nextSibling = index;
+    }
+    else {
+        parentRecord.firstChild = index;
+    }
+    parentRecord.lastChild = index;
+}
+
+void SceneGraph::unlink(uint32_t index) {
+    NodeRecord& record = m_Records[index];
+    NodeRecord& parentRecord = m_Records[record.parent];
+    if (record.previousSibling != 0) {
+        m_Records[record.previousSibling].nextSibling = record.nextSibling;
+    }
+    else {
+        parentRecord.firstChild = record.nextSibling;
+    }
+    if (record.nextSibling != 0) {
+        m_Records[record.nextSibling].previousSibling = record.previousSibling;
+    }
+    else {
+        parentRecord.lastChild = record.previousSibling;
+    }
+    record.parent = 0;
+    record.nextSibling = 0;
+    record.previousSibling = 0;
+}
+
+void SceneGraph::markDirty(uint32_t position) {
+    m_Flags[position] |= FLAG_DIRTY;
+    if (m_OrderDirty) {
+        // rebuildOrder flags the ancestors itself
+        return;
+    }
+    // Stops at the first ancestor that is already flagged, the ones above it are as well
+    while (position != 0) {
+        position = m_ParentPositions[position];
+        if (m_Flags[position] & FLAG_CHILD_DIRTY) {
+            break;
+        }
+        m_Flags[position] |= FLAG_CHILD_DIRTY;
+    }
+}
+
+void SceneGraph::rebuildOrder() {
+    unsigned int count = m_NodeCount + 1;
+    std::vector<uint32_t> indices, parentPositions;
+    std::vector<uint32_t> subtreeSizes = std::vector<uint32_t>(count, 1);
+    std::vector<NodeTransform> localTransforms;
+    std::vector<WorldTransform> worldTransforms;
+    std::vector<uint8_t> flags;
+    std::vector<Drawable*> drawables;
+    std::vector<DrawableType> drawableTypes;
+    indices.reserve(count);
+    parentPositions.reserve(count);
+    localTransforms.reserve(count);
+    worldTransforms.reserve(count);
+    flags.reserve(count);
+    drawables.reserve(count);
+    drawableTypes.reserve(count);
+
+    // Preorder walk, children are pushed last to first so they come out in sibling order
+    m_Stack.clear();
+    m_Stack.push_back(0);
+    while (!m_Stack.empty()) {
+        uint32_t index = m_Stack.back();
+        m_Stack.pop_back();
+        NodeRecord& record = m_Records[index];
+        uint32_t oldPosition = record.position;
+        record.position = indices.size();
+
+        indices.push_back(index);
+        parentPositions.push_back(index == 0 ? 0 : m_Records[record.parent].position);
+        localTransforms.push_back(m_LocalTransforms[oldPosition]);
+        worldTransforms.push_back(m_WorldTransforms[oldPosition]);
+        flags.push_back(m_Flags[oldPosition] & ~FLAG_CHILD_DIRTY);
+        drawables.push_back(m_Drawables[oldPosition]);
+        drawableTypes.push_back(m_DrawableTypes[oldPosition]);
+
+        for (uint32_t child = record.lastChild; child != 0; child = m_Records[child].previousSibling) {
+            m_Stack.push_back(child);
+        }
+    }
+
+    // Children come after their parent, so walking backwards finishes every subtree before its root
+    for (uint32_t position = count - 1; position > 0; position--) {
+        uint32_t parentPosition = parentPositions[position];
+        subtreeSizes[parentPosition] += subtreeSizes[position];
+        if (flags[position] & (FLAG_DIRTY | FLAG_CHILD_DIRTY)) {
+            flags[parentPosition] |= FLAG_CHILD_DIRTY;
+        }
+    }
+
+    m_Indices.swap(indices);
+    m_ParentPositions.swap(parentPositions);
+    m_SubtreeSizes.swap(subtreeSizes);
+    m_LocalTransforms.swap(localTransforms);
+    m_WorldTransforms.swap(worldTransforms);
+    m_Flags.swap(flags);
+    m_Drawables.swap(drawables);
+    m_DrawableTypes.swap(drawableTypes);
+    m_OrderDirty = false;
+}
+
+void SceneGraph::update() {
+    if (m_OrderDirty) {
+        rebuildOrder();
+    }
+    m_UpdatedCount = 0;
+    if (!(m_Flags[0] & FLAG_CHILD_DIRTY)) {
+        return;
+    }
+    m_Flags[0] &= ~FLAG_CHILD_DIRTY;
+
+    uint32_t position = 1;
+    uint32_t end = m_Indices.size();
+    while (position < end) {
+        uint8_t flags = m_Flags[position];
+        if (flags & FLAG_DIRTY) {
+            // Everything below a dirty node depends on it
+            uint32_t subtreeEnd = position + m_SubtreeSizes[position];
+            for (uint32_t i = position; i < subtreeEnd; i++) {
+                const NodeTransform& local = m_LocalTransforms[i];
+                const WorldTransform& parent = m_WorldTransforms[m_ParentPositions[i]];
+                float cosine = 1.f, sine = 0.f;
+                if (local.rotation != 0.f) {
+                    cosine = std::cos(local.rotation);
+                    sine = std::sin(local.rotation);
+                }
+                float a = cosine * local.scale.x;
+                float b = sine * local.scale.x;
+                float c = -sine * local.scale.y;
+                float d = cosine * local.scale.y;
+
+                WorldTransform& world = m_WorldTransforms[i];
+                world.a = parent.a * a + parent.c * b;
+                world.b = parent.b * a + parent.d * b;
+                world.c = parent.a * c + parent.c * d;
+                world.d = parent.b * c + parent.d * d;
+                world.x = parent.a * local.position.x + parent.c * local.position.y + parent.x;
+                world.y = parent.b * local.position.x + parent.d * local.position.y + parent.y;
+                m_Flags[i] &= ~(FLAG_DIRTY | FLAG_CHILD_DIRTY);
+            }
+            m_UpdatedCount += subtreeEnd - position;
+            position = subtreeEnd;
+        }
+        else if (flags & FLAG_CHILD_DIRTY) {
+            m_Flags[position] &= ~FLAG_CHILD_DIRTY;
+            position++;
+        }
+        else {
+            position += m_SubtreeSizes[position];
+        }
+    }
+}
+
+unsigned int SceneGraph::getUpdatedCount() {
+    return m_UpdatedCount;
+}
+
+void SceneGraph::draw(RenderTexture& target) {
+    update();
+    m_Instances.clear();
+    Texture* batchTexture = nullptr;
+
+    uint32_t position = 1;
+    uint32_t end = m_Indices.size();
+    while (position < end) {
+        if (!(m_Flags[position] & FLAG_VISIBLE)) {
+            position += m_SubtreeSizes[position];
+            continue;
+        }
+        DrawableType type = m_DrawableTypes[position];
+        Drawable* drawable = m_Drawables[position];
+        if (type == DRAWABLE_NONE || (type == DRAWABLE_SPRITE && drawable->texture == nullptr)) {
+            position++;
+            continue;
+        }
+
+        const WorldTransform& world = m_WorldTransforms[position];
+        Rectanglef source = drawable->sourceRectangle;
+        Vector2f size = drawable->size;
+        if (!drawable->absoluteSize && drawable->texture != nullptr) {
+            size = Vector2f(
+                size.x * drawable->texture->getWidth() * source.size.x,
+                size.y * drawable->texture->getHeight() * source.size.y
+            );
+        }
+
+        // The pivot is placed exactly, rotation and scale are taken from the world transform
+        // and applied around it
+        float scaleX = std::sqrt(world.a * world.a + world.b * world.b);
+        float scaleY = std::sqrt(world.c * world.c + world.d * world.d);
+        if (world.a * world.d - world.b * world.c < 0.f) {
+            scaleY = -scaleY;
+        }
+        float rotation = std::atan2(world.b, world.a) + drawable->rotation;
+        Vector2f center = drawable->rotationCenter;
+        float pivotX = drawable->position.x + center.x * size.x;
+        float pivotY = drawable->position.y + center.y * size.y;
+        Vector2f worldSize = Vector2f(size.x * scaleX, size.y * scaleY);
+        Vector2f worldPosition = Vector2f(
+            world.a * pivotX + world.c * pivotY + world.x - center.x * worldSize.x,
+            world.b * pivotX + world.d * pivotY + world.y - center.y * worldSize.y
+        );
+
+        if (type == DRAWABLE_SPRITE && drawable->shader == nullptr) {
+            if (drawable->texture != batchTexture) {
+                flushSprites(target, batchTexture);
+                batchTexture = drawable->texture;
+            }
+            m_Instances.push_back(SpriteInstance());
+            SpriteInstance& instance = m_Instances.back();
+            instance.position[0] = worldPosition.x;
+            instance.position[1] = worldPosition.y;
+            instance.size[0] = worldSize.x;
+            instance.size[1] = worldSize.y;
+            instance.rotation = rotation;
+            instance.rotationCenter[0] = center.x;
+            instance.rotationCenter[1] = center.y;
+            instance.sourceRectangle[0] = source.position.x;
+            instance.sourceRectangle[1] = source.position.y;
+            instance.sourceRectangle[2] = source.size.x;
+            instance.sourceRectangle[3] = source.size.y;
+            instance.color = drawable->color;
+        }
+        else {
+            flushSprites(target, batchTexture);
+            batchTexture = nullptr;
+            if (type == DRAWABLE_SPRITE) {
+                target.draw(drawable->texture, worldPosition, worldSize, true, rotation, center, source, drawable->color, drawable->shader);
+            }
+            else {
+                Polygon* polygon = static_cast<Polygon*>(drawable);
+                target.draw(polygon->vertexArray, worldPosition, worldSize, true, rotation, center, drawable->color, drawable->shader, drawable->texture, source);
+            }
+        }
+        position++;
+    }
+    flushSprites(target, batchTexture);
+}
+
+void SceneGraph::flushSprites(RenderTexture& target, Texture* texture) {
+    if (m_Instances.empty()) {
+        return;
+    }
+    target.draw(m_Instances.data(), m_Instances.size(), texture);
+    m_Instances.clear();
+}
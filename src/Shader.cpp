@@ -2,8 +2,13 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <cstring>
 
 #include "Mantaray/OpenGL/Context.hpp"
+#include "Mantaray/OpenGL/FrameStatistics.hpp"
+#include "Mantaray/OpenGL/RenderThread.hpp"
+#include "Mantaray/OpenGL/ShaderCache.hpp"
+#include "Mantaray/OpenGL/TextureResidency.hpp"
 #include "Mantaray/OpenGL/Objects/Shader.hpp"
 #include "Mantaray/OpenGL/Objects/Texture.hpp"
 #include "Mantaray/OpenGL/Objects/RenderTexture.hpp"
@@ -12,26 +17,24 @@
 
 using namespace MR;
 
+bool Shader::AsyncCompilation = false;
+
 Shader::Shader(const char* vertexShaderSource, const char* fragmentShaderSource) {
     link();
-    compileShader(VERTEX_SHADER, vertexShaderSource);
-    compileShader(FRAGMENT_SHADER, fragmentShaderSource);
-    linkShader();
+    buildProgram(vertexShaderSource, -1, fragmentShaderSource, -1);
 }
 
 Shader::Shader(std::string vertexShaderPath, std::string fragmentShaderPath) {
     link();
-    std::string vertexShaderContent;
-    FileSystem::ReadFile(vertexShaderPath, vertexShaderContent);
-    const char* vertexShaderSource = vertexShaderContent.c_str();
-    
-    std::string fragmentShaderContent;
-    FileSystem::ReadFile(fragmentShaderPath, fragmentShaderContent);
-    const char* fragmentShaderSource = fragmentShaderContent.c_str();
+    // Sources are handed to the driver straight from the views, with explicit lengths as they are not null terminated
+    FileView vertexShaderView;
+    FileSystem::MapFile(vertexShaderPath, vertexShaderView);
+    FileView fragmentShaderView;
+    FileSystem::MapFile(fragmentShaderPath, fragmentShaderView);
 
-    compileShader(VERTEX_SHADER, vertexShaderSource);
-    compileShader(FRAGMENT_SHADER, fragmentShaderSource);
-    linkShader();
+    const char* vertexShaderSource = vertexShaderView.isValid() ? (const char*)vertexShaderView.getData() : "";
+    const char* fragmentShaderSource = fragmentShaderView.isValid() ? (const char*)fragmentShaderView.getData() : "";
+    buildProgram(vertexShaderSource, vertexShaderView.getSize(), fragmentShaderSource, fragmentShaderView.getSize());
 }
 
 Shader::~Shader() {
@@ -51,6 +54,9 @@ void Shader::release() {
 }
 
 void Shader::bind() {
+    if (m_BuildState == BUILD_PENDING) {
+        finishBuild();
+    }
     Context::UseProgram(m_ShaderProgramID);
 }
 
@@ -58,8 +64,18 @@ void Shader::unbind() {
     Context::UseProgram(0);
 }
 
+Object::ObjectType Shader::getObjectType() {
+    return Object::OBJECT_SHADER;
+}
+
 void Shader::setupForDraw() {
     bind();
+    // Reloading an evicted texture uses the active unit, so it has to happen before the slots are bound
+    if (TextureResidency::IsEnabled()) {
+        for (auto& texture_slot: m_TextureSlots) {
+            TextureResidency::Touch(texture_slot.second);
+        }
+    }
     for (auto& texture_slot: m_TextureSlots) {
         glActiveTexture(0x84C0 + texture_slot.first);
         Context::BindTexture2D(texture_slot.second);
@@ -67,39 +83,81 @@ void Shader::setupForDraw() {
 }
 
 void Shader::setUniformInteger(std::string uniformName, int value) {
+    if (RenderThread::IsRecording()) {
+        UniformCommand& uniform = RenderThread::RecordUniform(this, uniformName, UniformCommand::UNIFORM_INTEGER);
+        uniform.integer = value;
+        return;
+    }
     bind();
     int uniformLocation = getUniformLocation(uniformName);
     glUniform1i(uniformLocation, value);
+    FrameStatistics::AddUniformUpload();
 }
 
 void Shader::setUniformFloat(std::string uniformName, float value) {
+    if (RenderThread::IsRecording()) {
+        UniformCommand& uniform = RenderThread::RecordUniform(this, uniformName, UniformCommand::UNIFORM_FLOAT);
+        uniform.values[0] = value;
+        return;
+    }
     bind();
     int uniformLocation = getUniformLocation(uniformName);
     glUniform1f(uniformLocation, value);
+    FrameStatistics::AddUniformUpload();
 }
 
 void Shader::setUniformVector2f(std::string uniformName, Vector2f value) {
+    if (RenderThread::IsRecording()) {
+        UniformCommand& uniform = RenderThread::RecordUniform(this, uniformName, UniformCommand::UNIFORM_VECTOR2F);
+        uniform.values[0] = value.x;
+        uniform.values[1] = value.y;
+        return;
+    }
     bind();
     int uniformLocation = getUniformLocation(uniformName);
     glUniform2f(uniformLocation, value.x, value.y);
+    FrameStatistics::AddUniformUpload();
 }
 
 void Shader::setUniformVector3f(std::string uniformName, Vector3f value) {
+    if (RenderThread::IsRecording()) {
+        UniformCommand& uniform = RenderThread::RecordUniform(this, uniformName, UniformCommand::UNIFORM_VECTOR3F);
+        uniform.values[0] = value.x;
+        uniform.values[1] = value.y;
+        uniform.values[2] = value.z;
+        return;
+    }
     bind();
     int uniformLocation = getUniformLocation(uniformName);
     glUniform3f(uniformLocation, value.x, value.y, value.z);
+    FrameStatistics::AddUniformUpload();
 }
 
 void Shader::setUniformVector4f(std::string uniformName, Vector4f value) {
+    if (RenderThread::IsRecording()) {
+        UniformCommand& uniform = RenderThread::RecordUniform(this, uniformName, UniformCommand::UNIFORM_VECTOR4F);
+        uniform.values[0] = value.x;
+        uniform.values[1] = value.y;
+        uniform.values[2] = value.z;
+        uniform.values[3] = value.w;
+        return;
+    }
     bind();
     int uniformLocation = getUniformLocation(uniformName);
     glUniform4f(uniformLocation, value.x, value.y, value.z, value.w);
+    FrameStatistics::AddUniformUpload();
 }
 
 void Shader::setUniformMatrix4(std::string uniformName, glm::mat4 value) {
+    if (RenderThread::IsRecording()) {
+        UniformCommand& uniform = RenderThread::RecordUniform(this, uniformName, UniformCommand::UNIFORM_MATRIX4);
+        memcpy(uniform.values, glm::value_ptr(value), sizeof(uniform.values));
+        return;
+    }
     bind();
     int uniformLocation = getUniformLocation(uniformName);
     glUniformMatrix4fv(uniformLocation, 1, GL_FALSE, glm::value_ptr(value));
+    FrameStatistics::AddUniformUpload();
 }
 
 void Shader::setTexture(std::string textureUniformName, int slot, Texture &texture) {
@@ -110,6 +168,12 @@ void Shader::setTexture(std::string textureUniformName, int slot, Texture &textu
         );
         return;
     }
+    if (RenderThread::IsRecording()) {
+        UniformCommand& uniform = RenderThread::RecordUniform(this, textureUniformName, UniformCommand::UNIFORM_TEXTURE);
+        uniform.integer = slot;
+        uniform.texture = &texture;
+        return;
+    }
     bind();
     glActiveTexture(0x84C0 + slot);
     Context::BindTexture2D(texture.getTextureID());
@@ -125,6 +189,12 @@ void Shader::setRenderTexture(std::string textureUniformName, int slot, RenderTe
         );
         return;
     }
+    if (RenderThread::IsRecording()) {
+        UniformCommand& uniform = RenderThread::RecordUniform(this, textureUniformName, UniformCommand::UNIFORM_RENDER_TEXTURE);
+        uniform.integer = slot;
+        uniform.renderTexture = &texture;
+        return;
+    }
     bind();
     glActiveTexture(0x84C0 + slot);
     Context::BindTexture2D(texture.m_RenderTexture->getTextureID());
@@ -132,6 +202,52 @@ void Shader::setRenderTexture(std::string textureUniformName, int slot, RenderTe
     m_TextureSlots[slot] = texture.m_RenderTexture->getTextureID();
 }
 
+bool Shader::isReady() {
+    if (m_BuildState == BUILD_PENDING) {
+        // Without the extension there is no way to ask without blocking, so the build is finished right away
+        if (HasParallelCompile()) {
+            int completed = GL_FALSE;
+            glGetProgramiv(m_ShaderProgramID, GL_COMPLETION_STATUS_KHR, &completed);
+            if (completed == GL_FALSE) {
+                return false;
+            }
+        }
+        finishBuild();
+    }
+    return m_BuildState == BUILD_READY;
+}
+
+bool Shader::hasFailed() {
+    return m_BuildState == BUILD_FAILED;
+}
+
+bool Shader::waitUntilReady() {
+    if (m_BuildState == BUILD_PENDING) {
+        finishBuild();
+    }
+    return m_BuildState == BUILD_READY;
+}
+
+void Shader::setFallback(Shader* fallback) {
+    m_Fallback = (fallback == this) ? nullptr : fallback;
+}
+
+Shader* Shader::getFallback() {
+    return m_Fallback;
+}
+
+void Shader::SetAsyncCompilation(bool enabled) {
+    AsyncCompilation = enabled;
+}
+
+bool Shader::IsAsyncCompilation() {
+    return AsyncCompilation;
+}
+
+bool Shader::HasParallelCompile() {
+    return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+}
+
 int Shader::getUniformLocation(std::string uniformName) {
     int uniformLocation = -1;
 
@@ -150,24 +266,75 @@ int Shader::getUniformLocation(std::string uniformName) {
     return uniformLocation;
 }
 
-void Shader::compileShader(Shader::ShaderType shaderType, const char* source) {
-    unsigned int shaderID;
+void Shader::buildProgram(const char* vertexSource, int vertexLength, const char* fragmentSource, int fragmentLength) {
+    if (ShaderCache::Load(m_ShaderProgramID, vertexSource, vertexLength, fragmentSource, fragmentLength)) {
+        m_BuildState = BUILD_READY;
+        return;
+    }
+
+    static bool compilerThreadsRequested = false;
+    if (AsyncCompilation && !compilerThreadsRequested && HasParallelCompile()) {
+        // Let the driver pick as many compiler threads as it wants
+        if (GLAD_GL_KHR_parallel_shader_compile) {
+            glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+        }
+        else {
+            glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+        }
+        compilerThreadsRequested = true;
+    }
+
+    // Querying any status right after issuing the work would force the driver to finish it synchronously
+    compileShader(VERTEX_SHADER, vertexSource, vertexLength);
+    compileShader(FRAGMENT_SHADER, fragmentSource, fragmentLength);
+    linkShader();
+    m_BuildState = BUILD_PENDING;
+
+    if (!AsyncCompilation) {
+        finishBuild();
+        if (m_BuildState == BUILD_READY) {
+            ShaderCache::Store(m_ShaderProgramID, vertexSource, vertexLength, fragmentSource, fragmentLength);
+        }
+        return;
+    }
+    if (ShaderCache::IsAvailable()) {
+        m_VertexSource = (vertexLength >= 0) ? std::string(vertexSource, vertexLength) : std::string(vertexSource);
+        m_FragmentSource = (fragmentLength >= 0) ? std::string(fragmentSource, fragmentLength) : std::string(fragmentSource);
+    }
+}
+
+void Shader::finishBuild() {
+    bool compiled = checkCompileStatus(VERTEX_SHADER);
+    compiled = checkCompileStatus(FRAGMENT_SHADER) && compiled;
+    bool linked = checkLinkStatus();
+    m_BuildState = (compiled && linked) ? BUILD_READY : BUILD_FAILED;
+    if (m_BuildState == BUILD_READY && !m_VertexSource.empty()) {
+        ShaderCache::Store(m_ShaderProgramID, m_VertexSource.c_str(), m_VertexSource.size(), m_FragmentSource.c_str(), m_FragmentSource.size());
+    }
+    std::string().swap(m_VertexSource);
+    std::string().swap(m_FragmentSource);
+}
+
+void Shader::compileShader(Shader::ShaderType shaderType, const char* source, int length) {
+    const int* lengths = (length >= 0) ? &length : NULL;
     switch (shaderType)
     {
     case Shader::VERTEX_SHADER:
-        shaderID = m_VertexShaderID;
-        glShaderSource(m_VertexShaderID, 1, &source, NULL);
+        glShaderSource(m_VertexShaderID, 1, &source, lengths);
         glCompileShader(m_VertexShaderID);
         break;
     case Shader::FRAGMENT_SHADER:
-        shaderID = m_FragmentShaderID;
-        glShaderSource(m_FragmentShaderID, 1, &source, NULL);
+        glShaderSource(m_FragmentShaderID, 1, &source, lengths);
         glCompileShader(m_FragmentShaderID);
         break;
     
     default:
-        return;
+        break;
     }
+}
+
+bool Shader::checkCompileStatus(Shader::ShaderType shaderType) {
+    unsigned int shaderID = (shaderType == VERTEX_SHADER) ? m_VertexShaderID : m_FragmentShaderID;
 
     int  success;
     char infoLog[512];
@@ -178,15 +345,21 @@ void Shader::compileShader(Shader::ShaderType shaderType, const char* source) {
         std::string message = s_ShaderType + "::COMPILING_SHADER_FAILED\n";
         message.append(infoLog);
         Logger::Log("ShaderCompiler", message, Logger::LOG_ERROR);
-        return;
+        return false;
     }
+    return true;
 }
 
 void MR::Shader::linkShader() {
     glAttachShader(m_ShaderProgramID, m_VertexShaderID);
     glAttachShader(m_ShaderProgramID, m_FragmentShaderID);
+    if (ShaderCache::IsAvailable()) {
+        glProgramParameteri(m_ShaderProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(m_ShaderProgramID);
-    
+}
+
+bool MR::Shader::checkLinkStatus() {
     int  success;
     char infoLog[512];
     glGetProgramiv(m_ShaderProgramID, GL_LINK_STATUS, &success);
@@ -195,8 +368,9 @@ void MR::Shader::linkShader() {
         std::string message = "LINKING_SHADER_FAILED\n";
         message.append(infoLog);
         Logger::Log("ShaderLinker", message, Logger::LOG_ERROR);
-        return;
+        return false;
     }
+    return true;
 }
 
 unsigned int Shader::CompileShader(Shader::ShaderType shaderType, const char* source) {
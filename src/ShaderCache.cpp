@@ -0,0 +1,205 @@
+#include <glad/glad.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Mantaray/OpenGL/ShaderCache.hpp"
+#include "Mantaray/Core/FileSystem.hpp"
+#include "Mantaray/Core/Logger.hpp"
+
+using namespace MR;
+
+struct CacheEntryHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t binaryFormat;
+    uint32_t binaryLength;
+};
+
+static const char CacheMagic[4] = {'M', 'R', 'S', 'B'};
+static const uint32_t CacheVersion = 1;
+
+static void hashBytes(uint64_t& hash, const void* data, size_t length) {
+    // 64 bit FNV-1a
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+static void hashString(uint64_t& hash, const char* string, int length) {
+    if (string == nullptr) {
+        string = "";
+    }
+    size_t size = (length >= 0) ? (size_t)length : strlen(string);
+    // The length separates the fields so moving text between them changes the key
+    uint64_t size64 = size;
+    hashBytes(hash, &size64, sizeof(size64));
+    hashBytes(hash, string, size);
+}
+
+std::string ShaderCache::Directory = "";
+bool ShaderCache::Enabled = true;
+int ShaderCache::Availability = -1;
+unsigned int ShaderCache::HitCount = 0;
+unsigned int ShaderCache::MissCount = 0;
+unsigned int ShaderCache::RejectedCount = 0;
+
+void ShaderCache::SetDirectory(std::string directory, bool absolutePath) {
+    if (!absolutePath) {
+        directory = FileSystem::GetWorkingDirectory() + directory;
+    }
+    if (!directory.empty() && directory.back() != '/' && directory.back() != '\\') {
+        directory += '/';
+    }
+    ShaderCache::Directory = directory;
+}
+
+std::string ShaderCache::GetDirectory() {
+    if (ShaderCache::Directory.empty()) {
+        ShaderCache::Directory = FileSystem::GetWorkingDirectory() + "ShaderCache/";
+    }
+    return ShaderCache::Directory;
+}
+
+void ShaderCache::SetEnabled(bool enabled) {
+    ShaderCache::Enabled = enabled;
+}
+
+bool ShaderCache::IsAvailable() {
+    if (!ShaderCache::Enabled) {
+        return false;
+    }
+    if (ShaderCache::Availability < 0) {
+        int formatCount = 0;
+        if (GLAD_GL_ARB_get_program_binary) {
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+        }
+        ShaderCache::Availability = (formatCount > 0) ? 1 : 0;
+        if (!ShaderCache::Availability) {
+            Logger::Log("ShaderCache", "Driver offers no program binary formats, caching disabled", Logger::LOG_DEBUG);
+        }
+    }
+    return ShaderCache::Availability == 1;
+}
+
+bool ShaderCache::Load(unsigned int program, const char* vertexSource, int vertexLength, const char* fragmentSource, int fragmentLength) {
+    if (!IsAvailable()) {
+        return false;
+    }
+
+    unsigned long long key = ComputeKey(vertexSource, vertexLength, fragmentSource, fragmentLength);
+    FILE* file = fopen(GetEntryPath(key).c_str(), "rb");
+    if (!file) {
+        ShaderCache::MissCount++;
+        return false;
+    }
+    CacheEntryHeader header;
+    std::vector<unsigned char> binary;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+        memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) == 0 &&
+        header.version == CacheVersion && header.key == key && header.binaryLength > 0;
+    if (valid) {
+        binary.resize(header.binaryLength);
+        valid = fread(&binary[0], 1, binary.size(), file) == binary.size();
+    }
+    fclose(file);
+    if (!valid) {
+        ShaderCache::MissCount++;
+        return false;
+    }
+
+    glProgramBinary(program, header.binaryFormat, &binary[0], header.binaryLength);
+    int success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        // Usually a driver update that kept its version string, the entry is rewritten after the source build
+        ShaderCache::RejectedCount++;
+        ShaderCache::MissCount++;
+        return false;
+    }
+    ShaderCache::HitCount++;
+    return true;
+}
+
+void ShaderCache::Store(unsigned int program, const char* vertexSource, int vertexLength, const char* fragmentSource, int fragmentLength) {
+    if (!IsAvailable()) {
+        return;
+    }
+
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+    std::vector<unsigned char> binary = std::vector<unsigned char>(length);
+    unsigned int binaryFormat = 0;
+    int written = 0;
+    glGetProgramBinary(program, length, &written, &binaryFormat, &binary[0]);
+    if (written <= 0) {
+        return;
+    }
+
+    CacheEntryHeader header;
+    memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+    header.version = CacheVersion;
+    header.key = ComputeKey(vertexSource, vertexLength, fragmentSource, fragmentLength);
+    header.binaryFormat = binaryFormat;
+    header.binaryLength = written;
+
+    if (!FileSystem::MakeDirectory(GetDirectory(), true)) {
+        return;
+    }
+    // Written to a temporary file first so a crash never leaves a truncated entry behind
+    std::string path = GetEntryPath(header.key);
+    std::string temporaryPath = path + ".tmp";
+    FILE* file = fopen(temporaryPath.c_str(), "wb");
+    if (!file) {
+        Logger::Log("ShaderCache", "Could not write " + temporaryPath, Logger::LOG_WARNING);
+        return;
+    }
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1 && fwrite(&binary[0], 1, written, file) == (size_t)written;
+    success = (fclose(file) == 0) && success;
+    remove(path.c_str());
+    if (!success || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        Logger::Log("ShaderCache", "Could not write " + path, Logger::LOG_WARNING);
+        remove(temporaryPath.c_str());
+    }
+}
+
+unsigned int ShaderCache::GetHitCount() {
+    return ShaderCache::HitCount;
+}
+
+unsigned int ShaderCache::GetMissCount() {
+    return ShaderCache::MissCount;
+}
+
+unsigned int ShaderCache::GetRejectedCount() {
+    return ShaderCache::RejectedCount;
+}
+
+void ShaderCache::ResetCounters() {
+    ShaderCache::HitCount = 0;
+    ShaderCache::MissCount = 0;
+    ShaderCache::RejectedCount = 0;
+}
+
+unsigned long long ShaderCache::ComputeKey(const char* vertexSource, int vertexLength, const char* fragmentSource, int fragmentLength) {
+    uint64_t hash = 14695981039346656037ull;
+    hashString(hash, (const char*)glGetString(GL_VENDOR), -1);
+    hashString(hash, (const char*)glGetString(GL_RENDERER), -1);
+    hashString(hash, (const char*)glGetString(GL_VERSION), -1);
+    hashString(hash, vertexSource, vertexLength);
+    hashString(hash, fragmentSource, fragmentLength);
+    return hash;
+}
+
+std::string ShaderCache::GetEntryPath(unsigned long long key) {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", key);
+    return GetDirectory() + name;
+}
@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Mantaray/Core/SpriteAnimation.hpp"
+#include "Mantaray/Core/EntityWorld.hpp"
+#include "Mantaray/Core/JobSystem.hpp"
+#include "Mantaray/Core/Logger.hpp"
+
+using namespace MR;
+
+// Animators advanced per job, small pools run on the calling thread only
+static const unsigned int UpdateGrain = 16384;
+// Keeps clips with zero length frames from stepping forever
+static const float MinimumFrameDuration = 1e-4f;
+
+void AnimationClip::addFrame(Rectanglef sourceRectangle, float duration) {
+    frames.push_back(sourceRectangle);
+    durations.push_back(duration);
+}
+
+float AnimationClip::getLength() {
+    float length = 0.f;
+    for (float duration : durations) {
+        length += duration;
+    }
+    return length;
+}
+
+Rectanglef AnimationClip::GetGridCell(Vector2u sheetSize, Vector2u cellSize, unsigned int index) {
+    if (sheetSize.x == 0 || sheetSize.y == 0 || cellSize.x == 0 || cellSize.y == 0) {
+        return Rectanglef(0, 0, 1, 1);
+    }
+    unsigned int columns = std::max(sheetSize.x / cellSize.x, 1u);
+    unsigned int column = index % columns;
+    unsigned int row = index / columns;
+    float width = (float)cellSize.x / sheetSize.x;
+    float height = (float)cellSize.y / sheetSize.y;
+    // Texture rows start at the bottom of the image
+    return Rectanglef(column * width, 1.f - (row + 1) * height, width, height);
+}
+
+AnimationClip AnimationClip::FromGrid(Vector2u sheetSize, Vector2u cellSize, unsigned int firstCell, unsigned int frameCount, float frameDuration, LoopMode loopMode) {
+    AnimationClip clip;
+    clip.loopMode = loopMode;
+    for (unsigned int i = 0; i < frameCount; i++) {
+        clip.addFrame(AnimationClip::GetGridCell(sheetSize, cellSize, firstCell + i), frameDuration);
+    }
+    return clip;
+}
+
+AnimationClip AnimationClip::FromRegions(Vector2u sheetSize, const std::vector<Rectangleu>& regions, float frameDuration, LoopMode loopMode) {
+    AnimationClip clip;
+    clip.loopMode = loopMode;
+    if (sheetSize.x == 0 || sheetSize.y == 0) {
+        return clip;
+    }
+    for (Rectangleu region : regions) {
+        clip.addFrame(
+            Rectanglef(
+                (float)region.x() / sheetSize.x,
+                1.f - (float)(region.y() + region.height()) / sheetSize.y,
+                (float)region.width() / sheetSize.x,
+                (float)region.height() / sheetSize.y
+            ),
+            frameDuration
+        );
+    }
+    return clip;
+}
+
+AnimatorPool::AnimatorPool() {
+
+}
+
+unsigned int AnimatorPool::addClip(const AnimationClip& clip) {
+    if (clip.frames.empty() || clip.frames.size() != clip.durations.size()) {
+        Logger::Log("AnimatorPool", "Clips need at least one frame and a duration for every frame!", Logger::LOG_WARNING);
+        return ~0u;
+    }
+    ClipData data;
+    data.firstFrame = m_Frames.size();
+    data.frameCount = clip.frames.size();
+    data.loopMode = clip.loopMode;
+    data.stepCount = data.frameCount;
+    if (clip.loopMode == AnimationClip::LOOP_PING_PONG && data.frameCount > 1) {
+        data.stepCount = 2 * data.frameCount - 2;
+    }
+
+    for (unsigned int i = 0; i < data.frameCount; i++) {
+        m_Frames.push_back(clip.frames[i]);
+        m_Durations.push_back(std::max(clip.durations[i], MinimumFrameDuration));
+    }
+    data.cycleLength = 0.f;
+    for (unsigned int step = 0; step < data.stepCount; step++) {
+        unsigned int frame = step < data.frameCount ? step : data.stepCount - step;
+        data.cycleLength += m_Durations[data.firstFrame + frame];
+    }
+    m_Clips.push_back(data);
+    return m_Clips.size() - 1;
+}
+
+unsigned int AnimatorPool::getClipCount() {
+    return m_Clips.size();
+}
+
+unsigned int AnimatorPool::getFrameCount(unsigned int clip) {
+    return clip < m_Clips.size() ? m_Clips[clip].frameCount : 0;
+}
+
+Animator AnimatorPool::createAnimator(unsigned int clip, Rectanglef* target, float speed) {
+    uint32_t index;
+    if (!m_FreeRecords.empty()) {
+        index = m_FreeRecords.back();
+        m_FreeRecords.pop_back();
+    }
+    else {
+        index = m_Records.size();
+        AnimatorRecord record;
+        record.generation = 1;
+        m_Records.push_back(record);
+    }
+
+    AnimatorRecord& record = m_Records[index];
+    record.dense = m_States.size();
+    m_States.push_back(AnimationState());
+    m_Targets.push_back(target);
+    m_DenseRecords.push_back(index);
+    play(m_States.back(), clip);
+    m_States.back().speed = speed;
+
+    Animator animator;
+    animator.index = index;
+    animator.generation = record.generation;
+    return animator;
+}
+
+void AnimatorPool::destroyAnimator(Animator animator) {
+    AnimationState* state = getState(animator);
+    if (state == nullptr) {
+        Logger::Log("AnimatorPool", "Cannot destroy a stale animator!", Logger::LOG_WARNING);
+        return;
+    }
+    AnimatorRecord& record = m_Records[animator.index];
+    uint32_t dense = record.dense;
+    uint32_t last = m_States.size() - 1;
+    // The last animator fills the gap so the arrays stay packed
+    if (dense != last) {
+        m_States[dense] = m_States[last];
+        m_Targets[dense] = m_Targets[last];
+        m_DenseRecords[dense] = m_DenseRecords[last];
+        m_Records[m_DenseRecords[dense]].dense = dense;
+    }
+    m_States.pop_back();
+    m_Targets.pop_back();
+    m_DenseRecords.pop_back();
+
+    record.generation = record.generation + 1 == 0 ? 1 : record.generation + 1;
+    record.dense = ~0u;
+    m_FreeRecords.push_back(animator.index);
+}
+
+bool AnimatorPool::isAlive(Animator animator) {
+    return getState(animator) != nullptr;
+}
+
+unsigned int AnimatorPool::getAnimatorCount() {
+    return m_States.size();
+}
+
+void AnimatorPool::setTarget(Animator animator, Rectanglef* target) {
+    AnimationState* state = getState(animator);
+    if (state == nullptr) {
+        return;
+    }
+    m_Targets[m_Records[animator.index].dense] = target;
+    state->flags |= AnimationState::ANIMATION_RESTARTED;
+}
+
+AnimationState* AnimatorPool::getState(Animator animator) {
+    if (animator.index >= m_Records.size()) {
+        return nullptr;
+    }
+    AnimatorRecord& record = m_Records[animator.index];
+    if (record.generation != animator.generation || record.dense == ~0u) {
+        return nullptr;
+    }
+    return &m_States[record.dense];
+}
+
+void AnimatorPool::play(Animator animator, unsigned int clip) {
+    AnimationState* state = getState(animator);
+    if (state != nullptr) {
+        play(*state, clip);
+    }
+}
+
+void AnimatorPool::play(AnimationState& state, unsigned int clip) {
+    if (clip >= m_Clips.size()) {
+        Logger::Log("AnimatorPool", "Cannot play an unknown clip!", Logger::LOG_WARNING);
+        return;
+    }
+    state.clip = clip;
+    state.step = 0;
+    state.remaining = m_Durations[m_Clips[clip].firstFrame];
+    state.flags = AnimationState::ANIMATION_RESTARTED;
+}
+
+void AnimatorPool::setPaused(Animator animator, bool paused) {
+    AnimationState* state = getState(animator);
+    if (state == nullptr) {
+        return;
+    }
+    if (paused) {
+        state->flags |= AnimationState::ANIMATION_PAUSED;
+    }
+    else {
+        state->flags &= ~AnimationState::ANIMATION_PAUSED;
+    }
+}
+
+void AnimatorPool::setSpeed(Animator animator, float speed) {
+    AnimationState* state = getState(animator);
+    if (state != nullptr) {
+        state->speed = speed;
+    }
+}
+
+bool AnimatorPool::isFinished(Animator animator) {
+    AnimationState* state = getState(animator);
+    return state != nullptr && (state->flags & AnimationState::ANIMATION_FINISHED);
+}
+
+unsigned int AnimatorPool::getFrame(Animator animator) {
+    AnimationState* state = getState(animator);
+    return state != nullptr ? getFrame(*state) : 0;
+}
+
+unsigned int AnimatorPool::getFrame(const AnimationState& state) {
+    if (state.clip >= m_Clips.size()) {
+        return 0;
+    }
+    const ClipData& clip = m_Clips[state.clip];
+    return state.step < clip.frameCount ? state.step : clip.stepCount - state.step;
+}
+
+template<typename Write>
+void AnimatorPool::advance(AnimationState* states, unsigned int count, float deltaTime, const Write& write) {
+    const ClipData* clips = m_Clips.data();
+    unsigned int clipCount = m_Clips.size();
+    const Rectanglef* frames = m_Frames.data();
+    const float* durations = m_Durations.data();
+
+    for (unsigned int i = 0; i < count; i++) {
+        AnimationState& state = states[i];
+        if (state.clip >= clipCount) {
+            continue;
+        }
+        const ClipData& clip = clips[state.clip];
+        bool changed = (state.flags & AnimationState::ANIMATION_RESTARTED) != 0;
+        // Default constructed states have not been given their first frame's duration by play yet
+        if (changed && state.remaining <= 0.f && !(state.flags & AnimationState::ANIMATION_FINISHED)) {
+            unsigned int frame = state.step < clip.frameCount ? state.step : clip.stepCount - state.step;
+            state.remaining = durations[clip.firstFrame + frame];
+        }
+
+        if (!(state.flags & (AnimationState::ANIMATION_PAUSED | AnimationState::ANIMATION_FINISHED))) {
+            state.remaining -= deltaTime * state.speed;
+            // Most animators stay on their frame, the rest usually advance by one
+            if (state.remaining <= 0.f) {
+                changed = true;
+                if (clip.loopMode != AnimationClip::LOOP_NONE && -state.remaining > clip.cycleLength) {
+                    state.remaining = -std::fmod(-state.remaining, clip.cycleLength);
+                }
+                while (state.remaining <= 0.f) {
+                    if (++state.step >= clip.stepCount) {
+                        if (clip.loopMode == AnimationClip::LOOP_NONE) {
+                            state.step = clip.stepCount - 1;
+                            state.remaining = 0.f;
+                            state.flags |= AnimationState::ANIMATION_FINISHED;
+                            break;
+                        }
+                        state.step = 0;
+                    }
+                    unsigned int frame = state.step < clip.frameCount ? state.step : clip.stepCount - state.step;
+                    state.remaining += durations[clip.firstFrame + frame];
+                }
+            }
+        }
+
+        if (changed) {
+            unsigned int frame = state.step < clip.frameCount ? state.step : clip.stepCount - state.step;
+            write(i, frames[clip.firstFrame + frame]);
+            state.flags &= ~AnimationState::ANIMATION_RESTARTED;
+        }
+    }
+}
+
+void AnimatorPool::update(float deltaTime) {
+    AnimationState* states = m_States.data();
+    Rectanglef** targets = m_Targets.data();
+    JobSystem::ParallelFor(m_States.size(), UpdateGrain, [&](unsigned int begin, unsigned int end) {
+        Rectanglef** rangeTargets = targets + begin;
+        advance(states + begin, end - begin, deltaTime, [rangeTargets](unsigned int i, const Rectanglef& frame) {
+            if (rangeTargets[i] != nullptr) {
+                *rangeTargets[i] = frame;
+            }
+        });
+    });
+}
+
+void AnimatorPool::update(EntityWorld& world, float deltaTime) {
+    unsigned int required = EntityWorld::COMPONENT_SPRITE | EntityWorld::COMPONENT_ANIMATION;
+    world.parallelForEachChunk(required, [&](EntityChunk& chunk) {
+        SpriteComponent* sprites = chunk.getSprites();
+        advance(chunk.getAnimations(), chunk.size(), deltaTime, [sprites](unsigned int i, const Rectanglef& frame) {
+            sprites[i].sourceRectangle = frame;
+        });
+    });
+}
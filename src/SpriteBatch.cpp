@@ -0,0 +1,102 @@
+#include <cstddef>
+
+#include <glad/glad.h>
+
+#include "Mantaray/OpenGL/Context.hpp"
+#include "Mantaray/OpenGL/FrameStatistics.hpp"
+#include "Mantaray/OpenGL/Objects/SpriteBatch.hpp"
+
+using namespace MR;
+
+static_assert(sizeof(SpriteInstance) == 48, "SpriteInstance has to match the instance attribute layout");
+
+static const float QuadVertices[] = {
+    0, 0,
+    1, 0,
+    0, 1,
+    1, 1
+};
+
+static const unsigned int QuadIndices[] = {
+    0, 1, 2,
+    2, 1, 3
+};
+
+SpriteBatch::SpriteBatch() {
+    link();
+}
+
+SpriteBatch::~SpriteBatch() {
+    unlink();
+}
+
+void SpriteBatch::allocate() {
+    glGenVertexArrays(1, &m_VAO);
+    glGenBuffers(1, &m_QuadVBO);
+    glGenBuffers(1, &m_EBO);
+    glGenBuffers(1, &m_InstanceVBO);
+    m_Capacity = 0;
+
+    bind();
+    glBindBuffer(GL_ARRAY_BUFFER, m_QuadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(QuadVertices), QuadVertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(QuadIndices), QuadIndices, GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+    GLsizei stride = sizeof(SpriteInstance);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(SpriteInstance, position));
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(SpriteInstance, rotation));
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(SpriteInstance, sourceRectangle));
+    glVertexAttribPointer(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)offsetof(SpriteInstance, color));
+    for (unsigned int attribute = 1; attribute <= 4; attribute++) {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+    FrameStatistics::AddBufferUpload(sizeof(QuadVertices) + sizeof(QuadIndices));
+    setByteSize(sizeof(QuadVertices) + sizeof(QuadIndices));
+}
+
+void SpriteBatch::release() {
+    glDeleteVertexArrays(1, &m_VAO);
+    glDeleteBuffers(1, &m_QuadVBO);
+    glDeleteBuffers(1, &m_EBO);
+    glDeleteBuffers(1, &m_InstanceVBO);
+}
+
+void SpriteBatch::bind() {
+    Context::BindVertexArray(m_VAO);
+}
+
+void SpriteBatch::unbind() {
+    Context::BindVertexArray(0);
+}
+
+Object::ObjectType SpriteBatch::getObjectType() {
+    return Object::OBJECT_SPRITE_BATCH;
+}
+
+void SpriteBatch::draw(const SpriteInstance* instances, unsigned int count) {
+    if (count == 0) {
+        return;
+    }
+    bind();
+    glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+    if (count > m_Capacity) {
+        unsigned int capacity = m_Capacity == 0 ? 256 : m_Capacity;
+        while (capacity < count) {
+            capacity *= 2;
+        }
+        m_Capacity = capacity;
+        setByteSize(sizeof(QuadVertices) + sizeof(QuadIndices) + sizeof(SpriteInstance) * m_Capacity);
+    }
+    glBufferData(GL_ARRAY_BUFFER, sizeof(SpriteInstance) * m_Capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(SpriteInstance) * count, instances);
+    FrameStatistics::AddBufferUpload(sizeof(SpriteInstance) * count);
+
+    glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, (void*)0, count);
+    FrameStatistics::AddDrawCall(4 * count, 6 * count);
+}
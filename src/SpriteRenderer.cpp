@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Mantaray/OpenGL/SpriteRenderer.hpp"
+#include "Mantaray/OpenGL/FrameStatistics.hpp"
+#include "Mantaray/OpenGL/RenderThread.hpp"
+#include "Mantaray/OpenGL/Objects/RenderTexture.hpp"
+#include "Mantaray/OpenGL/Objects/Texture.hpp"
+#include "Mantaray/Core/EntityWorld.hpp"
+
+using namespace MR;
+
+bool SpriteRenderer::Culling = true;
+std::vector<SpriteRenderer::Batch> SpriteRenderer::Batches = std::vector<SpriteRenderer::Batch>();
+unsigned int SpriteRenderer::BatchCount = 0;
+std::vector<unsigned int> SpriteRenderer::DrawOrder = std::vector<unsigned int>();
+
+void SpriteRenderer::SetCulling(bool enabled) {
+    SpriteRenderer::Culling = enabled;
+}
+
+bool SpriteRenderer::GetCulling() {
+    return SpriteRenderer::Culling;
+}
+
+unsigned int SpriteRenderer::FindBatch(int layer, Texture* texture, Shader* shader) {
+    for (unsigned int i = 0; i < SpriteRenderer::BatchCount; i++) {
+        Batch& batch = SpriteRenderer::Batches[i];
+        if (batch.layer == layer && batch.texture == texture && batch.shader == shader) {
+            return i;
+        }
+    }
+    if (SpriteRenderer::BatchCount == SpriteRenderer::Batches.size()) {
+        SpriteRenderer::Batches.push_back(Batch());
+    }
+    Batch& batch = SpriteRenderer::Batches[SpriteRenderer::BatchCount];
+    batch.layer = layer;
+    batch.texture = texture;
+    batch.shader = shader;
+    batch.order = SpriteRenderer::BatchCount;
+    batch.instances.clear();
+    return SpriteRenderer::BatchCount++;
+}
+
+void SpriteRenderer::Render(EntityWorld& world, RenderTexture& target) {
+    SpriteRenderer::BatchCount = 0;
+    unsigned int culledObjects = 0;
+    bool culling = SpriteRenderer::Culling;
+    Rectanglef visibleArea = target.getVisibleArea();
+    float visibleLeft = visibleArea.x();
+    float visibleBottom = visibleArea.y();
+    float visibleRight = visibleArea.x() + visibleArea.width();
+    float visibleTop = visibleArea.y() + visibleArea.height();
+
+    unsigned int required = EntityWorld::COMPONENT_TRANSFORM | EntityWorld::COMPONENT_SPRITE;
+    world.forEachChunk(required, [&](EntityChunk& chunk) {
+        const TransformComponent* transforms = chunk.getTransforms();
+        const SpriteComponent* sprites = chunk.getSprites();
+        const Color* colors = chunk.getColors();
+        const int* layers = chunk.getLayers();
+
+        // Neighbouring entities usually share their batch, the lookup only runs when the key changes
+        Batch* batch = nullptr;
+        Texture* texture = nullptr;
+        Shader* shader = nullptr;
+        int layer = 0;
+        float textureWidth = 0, textureHeight = 0;
+
+        for (unsigned int i = 0; i < chunk.size(); i++) {
+            const TransformComponent& transform = transforms[i];
+            const SpriteComponent& sprite = sprites[i];
+            if (sprite.texture == nullptr) {
+                continue;
+            }
+            int entityLayer = layers != nullptr ? layers[i] : 0;
+            if (batch == nullptr || sprite.texture != texture || sprite.shader != shader || entityLayer != layer) {
+                texture = sprite.texture;
+                shader = sprite.shader;
+                layer = entityLayer;
+                textureWidth = texture->getWidth();
+                textureHeight = texture->getHeight();
+                batch = &SpriteRenderer::Batches[SpriteRenderer::FindBatch(layer, texture, shader)];
+            }
+
+            Rectanglef source = sprite.sourceRectangle;
+            float width = transform.size.x;
+            float height = transform.size.y;
+            if (!sprite.absoluteSize) {
+                width *= textureWidth * source.size.x;
+                height *= textureHeight * source.size.y;
+            }
+
+            if (culling) {
+                float left, right, bottom, top;
+                if (transform.rotation == 0.f) {
+                    left = std::min(transform.position.x, transform.position.x + width);
+                    right = std::max(transform.position.x, transform.position.x + width);
+                    bottom = std::min(transform.position.y, transform.position.y + height);
+                    top = std::max(transform.position.y, transform.position.y + height);
+                }
+                else {
+                    // Circle around the rotation center through the farthest corner
+                    float centerX = transform.rotationCenter.x * width;
+                    float centerY = transform.rotationCenter.y * height;
+                    float reachX = std::max(std::abs(centerX), std::abs(width - centerX));
+                    float reachY = std::max(std::abs(centerY), std::abs(height - centerY));
+                    float radius = std::sqrt(reachX * reachX + reachY * reachY);
+                    left = transform.position.x + centerX - radius;
+                    right = transform.position.x + centerX + radius;
+                    bottom = transform.position.y + centerY - radius;
+                    top = transform.position.y + centerY + radius;
+                }
+                if (right < visibleLeft || left > visibleRight || top < visibleBottom || bottom > visibleTop) {
+                    culledObjects++;
+                    continue;
+                }
+            }
+
+            batch->instances.push_back(SpriteInstance());
+            SpriteInstance& instance = batch->instances.back();
+            instance.position[0] = transform.position.x;
+            instance.position[1] = transform.position.y;
+            instance.size[0] = width;
+            instance.size[1] = height;
+            instance.rotation = transform.rotation;
+            instance.rotationCenter[0] = transform.rotationCenter.x;
+            instance.rotationCenter[1] = transform.rotationCenter.y;
+            instance.sourceRectangle[0] = source.position.x;
+            instance.sourceRectangle[1] = source.position.y;
+            instance.sourceRectangle[2] = source.size.x;
+            instance.sourceRectangle[3] = source.size.y;
+            instance.color = colors != nullptr ? colors[i] : Color(0xFF);
+        }
+    });
+
+    std::vector<unsigned int>& drawOrder = SpriteRenderer::DrawOrder;
+    drawOrder.clear();
+    for (unsigned int i = 0; i < SpriteRenderer::BatchCount; i++) {
+        if (!SpriteRenderer::Batches[i].instances.empty()) {
+            drawOrder.push_back(i);
+        }
+    }
+    std::sort(drawOrder.begin(), drawOrder.end(), [](unsigned int a, unsigned int b) {
+        const Batch& batchA = SpriteRenderer::Batches[a];
+        const Batch& batchB = SpriteRenderer::Batches[b];
+        if (batchA.layer != batchB.layer) {
+            return batchA.layer < batchB.layer;
+        }
+        return batchA.order < batchB.order;
+    });
+
+    for (unsigned int index : drawOrder) {
+        Batch& batch = SpriteRenderer::Batches[index];
+        target.draw(batch.instances.data(), batch.instances.size(), batch.texture, batch.shader);
+    }
+
+    // Statistics belong to the thread that renders, a recorded frame carries its count along
+    if (RenderThread::IsRecording()) {
+        RenderThread::GetRecordingPacket().culledObjects += culledObjects;
+    }
+    else {
+        std::lock_guard<std::mutex> lock(FrameStatistics::GetMutex());
+        FrameStatistics::AddCulledObjects(culledObjects);
+    }
+}
@@ -1,40 +1,345 @@
 #include <glad/glad.h>
+#include <algorithm>
 
 #include "Mantaray/OpenGL/Objects/Texture.hpp"
 #include "Mantaray/OpenGL/Context.hpp"
+#include "Mantaray/OpenGL/RenderThread.hpp"
+#include "Mantaray/OpenGL/TextureResidency.hpp"
 #include "Mantaray/Core/Image.hpp"
+#include "Mantaray/Core/TextureContainer.hpp"
+#include "Mantaray/Core/TextureSource.hpp"
+#include "Mantaray/Core/FileSystem.hpp"
 #include "Mantaray/Core/Logger.hpp"
 
 using namespace MR;
 
+static unsigned int pixelFormat(int nrChannels) {
+    switch (nrChannels) {
+        case 1:
+            return GL_RED;
+        case 2:
+            return GL_RG;
+        case 3:
+            return GL_RGB;
+        case 4:
+            return GL_RGBA;
+        default:
+            return 0;
+    }
+}
+
+static unsigned int internalFormat(TextureDescriptor::Format format, int nrChannels) {
+    switch (format) {
+        case TextureDescriptor::FORMAT_R8:
+            return GL_R8;
+        case TextureDescriptor::FORMAT_RG8:
+            return GL_RG8;
+        case TextureDescriptor::FORMAT_RGB8:
+            return GL_RGB8;
+        case TextureDescriptor::FORMAT_RGBA8:
+            return GL_RGBA8;
+        case TextureDescriptor::FORMAT_RGB565:
+            return GL_RGB565;
+        case TextureDescriptor::FORMAT_RGBA4:
+            return GL_RGBA4;
+        default:
+            break;
+    }
+    // Sampling an 8 bit format with fewer channels returns the same values as RGBA8 would,
+    // missing color channels read as 0 and missing alpha as 1
+    switch (nrChannels) {
+        case 1:
+            return GL_R8;
+        case 2:
+            return GL_RG8;
+        case 3:
+            return GL_RGB8;
+        default:
+            return GL_RGBA8;
+    }
+}
+
+// Drivers pad 3 byte texels to 4, so RGB8 is counted as 4 bytes
+static size_t internalFormatSize(unsigned int internalFormat) {
+    switch (internalFormat) {
+        case GL_R8:
+            return 1;
+        case GL_RG8:
+        case GL_RGB565:
+        case GL_RGBA4:
+            return 2;
+        default:
+            return 4;
+    }
+}
+
+static unsigned int compressedFormat(BlockFormat format) {
+    switch (format) {
+        case BLOCK_FORMAT_BC1:
+            return GLAD_GL_EXT_texture_compression_s3tc ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : 0;
+        case BLOCK_FORMAT_BC3:
+            return GLAD_GL_EXT_texture_compression_s3tc ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : 0;
+        case BLOCK_FORMAT_BC4:
+            // RGTC is core since OpenGL 3.0
+            return GL_COMPRESSED_RED_RGTC1;
+        default:
+            return 0;
+    }
+}
+
+static int wrapMode(TextureDescriptor::Wrap wrap) {
+    switch (wrap) {
+        case TextureDescriptor::WRAP_REPEAT:
+            return GL_REPEAT;
+        case TextureDescriptor::WRAP_MIRRORED_REPEAT:
+            return GL_MIRRORED_REPEAT;
+        default:
+            return GL_CLAMP_TO_EDGE;
+    }
+}
+
+static int minificationFilter(const TextureDescriptor& descriptor, bool mipmapped) {
+    bool linear = descriptor.minFilter == TextureDescriptor::FILTER_LINEAR;
+    if (!mipmapped) {
+        return linear ? GL_LINEAR : GL_NEAREST;
+    }
+    if (descriptor.mipFilter == TextureDescriptor::FILTER_LINEAR) {
+        return linear ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR;
+    }
+    return linear ? GL_LINEAR_MIPMAP_NEAREST : GL_NEAREST_MIPMAP_NEAREST;
+}
+
+static unsigned int fullChainLevels(Vector2u size) {
+    unsigned int levels = 1;
+    unsigned int largest = std::max(size.x, size.y);
+    while (largest > 1) {
+        largest >>= 1;
+        levels++;
+    }
+    return levels;
+}
+
+TextureDescriptor::TextureDescriptor(Format format, Filter filter, Wrap wrap)
+    : format(format), minFilter(filter), magFilter(filter), wrapS(wrap), wrapT(wrap) {
+}
+
+TextureDescriptor TextureDescriptor::Mask() {
+    TextureDescriptor descriptor = TextureDescriptor(FORMAT_R8, FILTER_LINEAR);
+    descriptor.swizzle = SWIZZLE_WHITE_ALPHA;
+    return descriptor;
+}
+
 Texture::Texture() {
     link();
 }
 
-Texture::Texture(std::string pathToTexture) {
+Texture::Texture(std::string pathToTexture, const TextureDescriptor& descriptor) : m_Descriptor(descriptor) {
     link();
-    Image i = Image(pathToTexture);
-    uploadTextureData(i.m_ImageData, i.getWidth(), i.getHeight(), i.m_NrChannels);
+    loadFromFile(pathToTexture);
 }
 
-Texture::Texture(Image &image) {
+Texture::Texture(Image &image, const TextureDescriptor& descriptor) : m_Descriptor(descriptor) {
     link();
     uploadTextureData(image.m_ImageData, image.getWidth(), image.getHeight(), image.m_NrChannels);
 }
 
-Texture::Texture(Vector2u resolution, int channels) {
+Texture::Texture(TextureSource &source, const TextureDescriptor& descriptor) : m_Descriptor(descriptor) {
+    link();
+    setFromSource(source);
+}
+
+Texture::Texture(Vector2u resolution, int channels, const TextureDescriptor& descriptor) : m_Descriptor(descriptor) {
     link();
     uploadTextureData(nullptr, resolution.x, resolution.y, channels);
 }
 
+Texture::Texture(Vector2u resolution, ObjectType objectType) : m_ObjectType(objectType) {
+    link();
+    uploadTextureData(nullptr, resolution.x, resolution.y, 4);
+}
+
 Texture::~Texture() {
     unlink();
 }
 
+void Texture::setDescriptor(const TextureDescriptor& descriptor) {
+    RenderThread::ScopedContext context;
+    m_Descriptor = descriptor;
+    bind();
+    applySamplerState();
+    unbind();
+}
+
+const TextureDescriptor& Texture::getDescriptor() {
+    return m_Descriptor;
+}
+
+void Texture::loadFromFile(std::string pathToTexture) {
+    TextureSource source(pathToTexture);
+    setFromSource(source);
+}
+
+bool Texture::setFromSource(TextureSource &source) {
+    RenderThread::ScopedContext context;
+    forgetSource();
+    if (!uploadSource(source)) {
+        return false;
+    }
+    m_SourcePath = source.m_Path;
+    TextureResidency::Register(this);
+    return true;
+}
+
+bool Texture::setFromContainer(TextureContainer &container) {
+    RenderThread::ScopedContext context;
+    forgetSource();
+    return uploadContainer(container);
+}
+
+bool Texture::uploadSource(TextureSource &source) {
+    if (source.m_Container.isOpen()) {
+        if (uploadContainer(source.m_Container)) {
+            return true;
+        }
+        Logger::Log("Texture", "Falling back to source image for " + source.m_Path, Logger::LOG_WARNING);
+        source.decodeImage();
+    }
+    Image& image = source.m_Image;
+    uploadTextureData(image.m_ImageData, image.getWidth(), image.getHeight(), image.m_NrChannels);
+    return image.m_ImageData != nullptr;
+}
+
+bool Texture::uploadContainer(TextureContainer &container) {
+    if (!container.isOpen()) {
+        return false;
+    }
+    Vector2u size = container.getSize();
+    bool compressed = TextureContainer::IsBlockCompressed(container.getPixelFormat());
+    BlockFormat blockFormat = TextureContainer::GetBlockFormat(container.getPixelFormat());
+    if (compressed && compressedFormat(blockFormat) == 0) {
+        Logger::Log("Texture", "Block compressed format is not supported by the driver", Logger::LOG_WARNING);
+        return false;
+    }
+    if (!compressed && container.getLevelCount() == 1) {
+        uploadTextureData(container.getLevelData(0), size.x, size.y, container.getNrChannels());
+        return true;
+    }
+
+    // Levels are uploaded straight from the mapping, the driver does the only copy
+    bind();
+    for (unsigned int level = 0; level < container.getLevelCount(); level++) {
+        Vector2u levelSize = container.getLevelSize(level);
+        bool uploaded = compressed ?
+            uploadCompressedLevel(container.getLevelData(level), levelSize.x, levelSize.y, blockFormat, level) :
+            uploadLevel(container.getLevelData(level), levelSize.x, levelSize.y, container.getNrChannels(), level);
+        if (!uploaded) {
+            unbind();
+            return false;
+        }
+    }
+    m_Size = size;
+    m_LevelCount = container.getLevelCount();
+    applySamplerState();
+    unbind();
+    return true;
+}
+
 void Texture::setFromImage(Image &image) {
+    RenderThread::ScopedContext context;
+    forgetSource();
     uploadTextureData(image.m_ImageData, image.getWidth(), image.getHeight(), image.m_NrChannels);
 }
 
+void Texture::setFromImage(Image &image, BlockFormat format) {
+    std::vector<unsigned char> blocks;
+    if (compressedFormat(format) == 0 || !BlockCompressor::Compress(image.m_ImageData, image.m_Size, image.m_NrChannels, format, blocks)) {
+        Logger::Log("Texture", "Block compression unavailable, uploading uncompressed", Logger::LOG_WARNING);
+        setFromImage(image);
+        return;
+    }
+    setCompressed(&blocks[0], image.m_Size, format);
+}
+
+bool Texture::setCompressed(const unsigned char* blockData, Vector2u size, BlockFormat format) {
+    RenderThread::ScopedContext context;
+    forgetSource();
+    bind();
+    if (!uploadCompressedLevel(blockData, size.x, size.y, format, 0)) {
+        unbind();
+        return false;
+    }
+    m_Size = size;
+    m_LevelCount = 1;
+    applySamplerState();
+    unbind();
+    return true;
+}
+
+void Texture::setFromMipChain(std::vector<Image> &mipChain) {
+    if (mipChain.empty()) {
+        return;
+    }
+    RenderThread::ScopedContext context;
+    forgetSource();
+    bind();
+    for (unsigned int level = 0; level < mipChain.size(); level++) {
+        Image& image = mipChain[level];
+        if (!uploadLevel(image.m_ImageData, image.getWidth(), image.getHeight(), image.m_NrChannels, level)) {
+            unbind();
+            return;
+        }
+    }
+    m_Size = mipChain[0].m_Size;
+    m_LevelCount = mipChain.size();
+    applySamplerState();
+    unbind();
+}
+
+void Texture::updateRegion(Image &image, Rectangleu region) {
+    updateRegion(image, region, region.position);
+}
+
+void Texture::updateRegion(Image &image, Rectangleu sourceRegion, Vector2u destination) {
+    RenderThread::ScopedContext context;
+    unsigned int width = std::min(sourceRegion.width(), std::min(image.m_Size.x - std::min(sourceRegion.x(), image.m_Size.x), m_Size.x - std::min(destination.x, m_Size.x)));
+    unsigned int height = std::min(sourceRegion.height(), std::min(image.m_Size.y - std::min(sourceRegion.y(), image.m_Size.y), m_Size.y - std::min(destination.y, m_Size.y)));
+    if (width == 0 || height == 0) {
+        return;
+    }
+
+    unsigned int format = pixelFormat(image.m_NrChannels);
+    if (format == 0) {
+        Logger::Log("Texture", "Unsupported number of channels", Logger::LOG_WARNING);
+        return;
+    }
+    // The region is patched into the reloaded contents, which then only exist on the GPU
+    if (m_Evicted) {
+        reload();
+    }
+    forgetSource();
+
+    // Image and texture rows are both stored bottom up, regions are given top down
+    bind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, image.m_Size.x);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, sourceRegion.x());
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, image.m_Size.y - sourceRegion.y() - height);
+    glTexSubImage2D(
+        GL_TEXTURE_2D, 0,
+        destination.x, m_Size.y - destination.y - height,
+        width, height,
+        format, GL_UNSIGNED_BYTE, image.m_ImageData
+    );
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (m_Descriptor.generateMipmaps && m_LevelCount > 1) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    unbind();
+}
+
 int Texture::getWidth() {
     return m_Size.x;
 }
@@ -47,11 +352,16 @@ unsigned int Texture::getTextureID() {
     return m_TextureID;
 }
 
+bool Texture::isResident() {
+    return !m_Evicted;
+}
+
 void Texture::allocate() {
     glGenTextures(1, &m_TextureID);
 }
 
 void Texture::release() {
+    forgetSource();
     glDeleteTextures(1, &m_TextureID);
 }
 
@@ -63,30 +373,119 @@ void Texture::unbind() {
     Context::BindTexture2D(0);
 }
 
-void Texture::uploadTextureData(unsigned char* textureData, int width, int height, int nrChannels) {
+Object::ObjectType Texture::getObjectType() {
+    return m_ObjectType;
+}
+
+void Texture::evict() {
     bind();
-    m_Size = Vector2u(width, height);
+    for (unsigned int level = 0; level < m_LevelCount; level++) {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_R8, 0, 0, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+    }
+    unbind();
+    setByteSize(0);
+    m_Evicted = true;
+}
 
-    unsigned int format = 0;
-    switch (nrChannels) {
-        case 1:
-            format = GL_RED;
-            break;
-        case 3:
-            format = GL_RGB;
-            break;
-        case 4:
-            format = GL_RGBA;
-            break;
-        default:
-            Logger::Log("Texture", "Unsupported number of channels", Logger::LOG_WARNING);
-            return;
+void Texture::reload() {
+    m_Evicted = false;
+    TextureSource source(m_SourcePath);
+    if (!uploadSource(source)) {
+        Logger::Log("Texture", "Could not reload evicted texture " + m_SourcePath, Logger::LOG_WARNING);
     }
+}
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, format, GL_UNSIGNED_BYTE, textureData);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST); 
+void Texture::forgetSource() {
+    if (!m_SourcePath.empty()) {
+        TextureResidency::Unregister(this);
+        m_SourcePath = "";
+    }
+    m_Evicted = false;
+}
+
+void Texture::uploadTextureData(const unsigned char* textureData, int width, int height, int nrChannels) {
+    bind();
+    if (!uploadLevel(textureData, width, height, nrChannels, 0)) {
+        unbind();
+        return;
+    }
+    m_Size = Vector2u(width, height);
+    m_LevelCount = 1;
+
+    if (m_Descriptor.generateMipmaps && textureData != nullptr) {
+        unsigned int levels = fullChainLevels(m_Size);
+        // The default of 1 level would make generating pointless, so it asks for the full chain too
+        if (m_Descriptor.mipLevels > 1) {
+            levels = std::min(levels, m_Descriptor.mipLevels);
+        }
+        if (levels > 1) {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+            glGenerateMipmap(GL_TEXTURE_2D);
+            m_LevelCount = levels;
+            size_t texelSize = internalFormatSize(internalFormat(m_Descriptor.format, nrChannels));
+            for (unsigned int level = 1; level < levels; level++) {
+                trackLevelBytes((size_t)std::max(m_Size.x >> level, 1u) * std::max(m_Size.y >> level, 1u) * texelSize, level);
+            }
+        }
+    }
+    applySamplerState();
     unbind();
 }
+
+bool Texture::uploadLevel(const unsigned char* textureData, int width, int height, int nrChannels, int level) {
+    unsigned int format = pixelFormat(nrChannels);
+    if (format == 0) {
+        Logger::Log("Texture", "Unsupported number of channels", Logger::LOG_WARNING);
+        return false;
+    }
+
+    // Image rows are tightly packed, which matters for 1 and 3 channel data with odd widths
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    unsigned int storageFormat = internalFormat(m_Descriptor.format, nrChannels);
+    glTexImage2D(GL_TEXTURE_2D, level, storageFormat, width, height, 0, format, GL_UNSIGNED_BYTE, textureData);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    trackLevelBytes((size_t)width * height * internalFormatSize(storageFormat), level);
+    return true;
+}
+
+bool Texture::uploadCompressedLevel(const unsigned char* blockData, int width, int height, BlockFormat format, int level) {
+    unsigned int internalFormat = compressedFormat(format);
+    if (internalFormat == 0) {
+        Logger::Log("Texture", "Block compressed format is not supported by the driver", Logger::LOG_WARNING);
+        return false;
+    }
+    size_t byteSize = BlockCompressor::GetCompressedSize(Vector2u(width, height), format);
+    glCompressedTexImage2D(GL_TEXTURE_2D, level, internalFormat, width, height, 0, byteSize, blockData);
+    trackLevelBytes(byteSize, level);
+    return true;
+}
+
+// Uploading level 0 redefines the texture, so the count starts over there
+void Texture::trackLevelBytes(size_t byteSize, int level) {
+    setByteSize((level == 0) ? byteSize : getByteEstimate() + byteSize);
+}
+
+void Texture::applySamplerState() {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_LevelCount - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode(m_Descriptor.wrapS));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode(m_Descriptor.wrapT));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minificationFilter(m_Descriptor, m_LevelCount > 1));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (m_Descriptor.magFilter == TextureDescriptor::FILTER_LINEAR) ? GL_LINEAR : GL_NEAREST);
+
+    int swizzle[4] = {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA};
+    if (m_Descriptor.swizzle == TextureDescriptor::SWIZZLE_WHITE_ALPHA) {
+        swizzle[0] = GL_ONE;
+        swizzle[1] = GL_ONE;
+        swizzle[2] = GL_ONE;
+        swizzle[3] = GL_RED;
+    }
+    else if (m_Descriptor.swizzle == TextureDescriptor::SWIZZLE_GREY) {
+        swizzle[0] = GL_RED;
+        swizzle[1] = GL_RED;
+        swizzle[2] = GL_RED;
+        swizzle[3] = GL_ONE;
+    }
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+}
@@ -0,0 +1,218 @@
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+#include "Mantaray/Core/TextureContainer.hpp"
+#include "Mantaray/Core/Image.hpp"
+#include "Mantaray/Core/Logger.hpp"
+
+using namespace MR;
+
+static const char ContainerMagic[4] = {'M', 'R', 'T', 'X'};
+static const uint32_t MaxLevelCount = 32;
+static const uint64_t DataAlignment = 16;
+
+static uint64_t alignOffset(uint64_t offset) {
+    return (offset + DataAlignment - 1) & ~(DataAlignment - 1);
+}
+
+static uint64_t levelByteSize(TextureContainer::PixelFormat pixelFormat, uint32_t width, uint32_t height, uint32_t nrChannels) {
+    if (TextureContainer::IsBlockCompressed(pixelFormat)) {
+        return BlockCompressor::GetCompressedSize(Vector2u(width, height), TextureContainer::GetBlockFormat(pixelFormat));
+    }
+    return (uint64_t)width * height * nrChannels;
+}
+
+std::string TextureContainer::GetCookedPath(std::string sourcePath) {
+    return sourcePath + ".mrtex";
+}
+
+bool TextureContainer::IsFresh(std::string sourcePath, std::string cookedPath) {
+    struct stat cookedStatus;
+    if (stat(cookedPath.c_str(), &cookedStatus) != 0) {
+        return false;
+    }
+    // A cooked file shipped without its source is always used
+    struct stat sourceStatus;
+    if (stat(sourcePath.c_str(), &sourceStatus) != 0) {
+        return true;
+    }
+    return cookedStatus.st_mtime >= sourceStatus.st_mtime;
+}
+
+bool TextureContainer::IsBlockCompressed(PixelFormat pixelFormat) {
+    return pixelFormat == PIXEL_FORMAT_BC1 || pixelFormat == PIXEL_FORMAT_BC3 || pixelFormat == PIXEL_FORMAT_BC4;
+}
+
+BlockFormat TextureContainer::GetBlockFormat(PixelFormat pixelFormat) {
+    switch (pixelFormat) {
+        case PIXEL_FORMAT_BC3:
+            return BLOCK_FORMAT_BC3;
+        case PIXEL_FORMAT_BC4:
+            return BLOCK_FORMAT_BC4;
+        default:
+            return BLOCK_FORMAT_BC1;
+    }
+}
+
+bool TextureContainer::Write(std::string path, std::vector<Image>& mipChain, PixelFormat pixelFormat, unsigned int threadCount) {
+    if (mipChain.empty() || mipChain.size() > MaxLevelCount || mipChain[0].m_ImageData == nullptr) {
+        Logger::Log("TextureContainer", "Nothing to write to " + path, Logger::LOG_ERROR);
+        return false;
+    }
+
+    Header header;
+    memcpy(header.magic, ContainerMagic, sizeof(ContainerMagic));
+    header.version = Version;
+    header.width = mipChain[0].m_Size.x;
+    header.height = mipChain[0].m_Size.y;
+    header.pixelFormat = pixelFormat;
+    header.nrChannels = mipChain[0].m_NrChannels;
+    // Compressed data is described by the channels the format can represent
+    if (pixelFormat == PIXEL_FORMAT_BC1) header.nrChannels = 3;
+    if (pixelFormat == PIXEL_FORMAT_BC3) header.nrChannels = 4;
+    if (pixelFormat == PIXEL_FORMAT_BC4) header.nrChannels = 1;
+    header.levelCount = mipChain.size();
+    header.reserved = 0;
+
+    std::vector<Level> levels = std::vector<Level>(mipChain.size());
+    std::vector<std::vector<unsigned char>> compressedLevels = std::vector<std::vector<unsigned char>>(IsBlockCompressed(pixelFormat) ? mipChain.size() : 0);
+    uint64_t offset = sizeof(Header) + sizeof(Level) * levels.size();
+    for (unsigned int i = 0; i < mipChain.size(); i++) {
+        Image& image = mipChain[i];
+        if (image.m_NrChannels != mipChain[0].m_NrChannels || image.m_ImageData == nullptr) {
+            Logger::Log("TextureContainer", "Mip levels do not share one layout: " + path, Logger::LOG_ERROR);
+            return false;
+        }
+        offset = alignOffset(offset);
+        levels[i].offset = offset;
+        levels[i].size = levelByteSize(pixelFormat, image.m_Size.x, image.m_Size.y, image.m_NrChannels);
+        if (IsBlockCompressed(pixelFormat) &&
+            !BlockCompressor::Compress(image.m_ImageData, image.m_Size, image.m_NrChannels, GetBlockFormat(pixelFormat), compressedLevels[i], threadCount)) {
+            return false;
+        }
+        levels[i].width = image.m_Size.x;
+        levels[i].height = image.m_Size.y;
+        offset += levels[i].size;
+    }
+
+    std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file) {
+        Logger::Log("TextureContainer", "Could not open file for writing: " + path, Logger::LOG_ERROR);
+        return false;
+    }
+    file.write((const char*)&header, sizeof(Header));
+    file.write((const char*)&levels[0], sizeof(Level) * levels.size());
+    const char padding[DataAlignment] = {0};
+    uint64_t written = sizeof(Header) + sizeof(Level) * levels.size();
+    for (unsigned int i = 0; i < mipChain.size(); i++) {
+        file.write(padding, levels[i].offset - written);
+        const unsigned char* data = compressedLevels.empty() ? mipChain[i].m_ImageData : &compressedLevels[i][0];
+        file.write((const char*)data, levels[i].size);
+        written = levels[i].offset + levels[i].size;
+    }
+    if (!file) {
+        Logger::Log("TextureContainer", "Could not write file: " + path, Logger::LOG_ERROR);
+        return false;
+    }
+    return true;
+}
+
+TextureContainer::TextureContainer() {
+}
+
+TextureContainer::TextureContainer(std::string path) {
+    open(path);
+}
+
+bool TextureContainer::open(std::string path) {
+    close();
+    if (!m_File.open(path)) {
+        return false;
+    }
+    if (!validate(m_File.getData(), m_File.getSize(), path)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool TextureContainer::open(const unsigned char* data, size_t size, std::string name) {
+    close();
+    return validate(data, size, name);
+}
+
+bool TextureContainer::validate(const unsigned char* data, size_t size, std::string path) {
+    const Header* header = (const Header*)data;
+    if (size < sizeof(Header) || memcmp(header->magic, ContainerMagic, sizeof(ContainerMagic)) != 0) {
+        Logger::Log("TextureContainer", "Not a texture container: " + path, Logger::LOG_ERROR);
+        return false;
+    }
+    if (header->version != Version) {
+        Logger::Log("TextureContainer", "Unsupported texture container version: " + path, Logger::LOG_ERROR);
+        return false;
+    }
+    if (header->pixelFormat != PIXEL_FORMAT_UNORM8 && !IsBlockCompressed((PixelFormat)header->pixelFormat)) {
+        Logger::Log("TextureContainer", "Unsupported texture container pixel format: " + path, Logger::LOG_ERROR);
+        return false;
+    }
+    if (header->levelCount == 0 || header->levelCount > MaxLevelCount || header->nrChannels < 1 || header->nrChannels > 4 ||
+        size < sizeof(Header) + sizeof(Level) * header->levelCount) {
+        Logger::Log("TextureContainer", "Corrupted texture container header: " + path, Logger::LOG_ERROR);
+        return false;
+    }
+
+    const Level* levels = (const Level*)(data + sizeof(Header));
+    for (unsigned int i = 0; i < header->levelCount; i++) {
+        bool validSize = levels[i].size == levelByteSize((PixelFormat)header->pixelFormat, levels[i].width, levels[i].height, header->nrChannels);
+        if (!validSize || levels[i].offset > size || levels[i].size > size - levels[i].offset) {
+            Logger::Log("TextureContainer", "Corrupted texture container level table: " + path, Logger::LOG_ERROR);
+            close();
+            return false;
+        }
+    }
+
+    m_Data = data;
+    m_Header = header;
+    m_Levels = levels;
+    return true;
+}
+
+void TextureContainer::close() {
+    m_File.close();
+    m_Data = nullptr;
+    m_Header = nullptr;
+    m_Levels = nullptr;
+}
+
+bool TextureContainer::isOpen() {
+    return m_Header != nullptr;
+}
+
+Vector2u TextureContainer::getSize() {
+    return Vector2u(m_Header->width, m_Header->height);
+}
+
+int TextureContainer::getNrChannels() {
+    return m_Header->nrChannels;
+}
+
+TextureContainer::PixelFormat TextureContainer::getPixelFormat() {
+    return (PixelFormat)m_Header->pixelFormat;
+}
+
+unsigned int TextureContainer::getLevelCount() {
+    return m_Header->levelCount;
+}
+
+Vector2u TextureContainer::getLevelSize(unsigned int level) {
+    return Vector2u(m_Levels[level].width, m_Levels[level].height);
+}
+
+size_t TextureContainer::getLevelByteSize(unsigned int level) {
+    return m_Levels[level].size;
+}
+
+const unsigned char* TextureContainer::getLevelData(unsigned int level) {
+    return m_Data + m_Levels[level].offset;
+}
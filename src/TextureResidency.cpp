@@ -0,0 +1,133 @@
+#include <algorithm>
+
+#include "Mantaray/OpenGL/TextureResidency.hpp"
+#include "Mantaray/OpenGL/ObjectChain.hpp"
+#include "Mantaray/OpenGL/Objects/Texture.hpp"
+
+using namespace MR;
+
+bool TextureResidency::Enabled = false;
+unsigned long long TextureResidency::Budget = 0;
+uint64_t TextureResidency::CurrentFrame = 1;
+std::vector<TextureResidency::Entry> TextureResidency::Entries = std::vector<TextureResidency::Entry>();
+unsigned int TextureResidency::TrackedCount = 0;
+unsigned int TextureResidency::EvictionCount = 0;
+unsigned int TextureResidency::ReloadCount = 0;
+
+void TextureResidency::SetEnabled(bool enabled) {
+    if (!enabled) {
+        for (Entry& entry : TextureResidency::Entries) {
+            if (entry.texture != nullptr && entry.texture->m_Evicted) {
+                entry.texture->reload();
+                TextureResidency::ReloadCount++;
+            }
+        }
+    }
+    TextureResidency::Enabled = enabled;
+}
+
+void TextureResidency::SetBudget(unsigned long long bytes) {
+    TextureResidency::Budget = bytes;
+}
+
+unsigned long long TextureResidency::GetBudget() {
+    return TextureResidency::Budget;
+}
+
+unsigned long long TextureResidency::GetResidentBytes() {
+    return ObjectChain::GetByteEstimate(Object::OBJECT_TEXTURE);
+}
+
+void TextureResidency::EndFrame() {
+    uint64_t frame = TextureResidency::CurrentFrame++;
+    if (!TextureResidency::Enabled || TextureResidency::Budget == 0) {
+        return;
+    }
+    unsigned long long residentBytes = GetResidentBytes();
+    if (residentBytes <= TextureResidency::Budget) {
+        return;
+    }
+
+    std::vector<Entry> candidates;
+    for (Entry& entry : TextureResidency::Entries) {
+        if (entry.texture != nullptr && !entry.texture->m_Evicted && entry.lastUsedFrame < frame) {
+            candidates.push_back(entry);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Entry& a, const Entry& b) {
+        return a.lastUsedFrame < b.lastUsedFrame;
+    });
+    for (Entry& candidate : candidates) {
+        if (residentBytes <= TextureResidency::Budget) {
+            break;
+        }
+        residentBytes -= candidate.texture->getByteEstimate();
+        candidate.texture->evict();
+        TextureResidency::EvictionCount++;
+    }
+}
+
+unsigned int TextureResidency::GetTrackedCount() {
+    return TextureResidency::TrackedCount;
+}
+
+unsigned int TextureResidency::GetEvictedCount() {
+    unsigned int count = 0;
+    for (Entry& entry : TextureResidency::Entries) {
+        if (entry.texture != nullptr && entry.texture->m_Evicted) {
+            count++;
+        }
+    }
+    return count;
+}
+
+unsigned int TextureResidency::GetEvictionCount() {
+    return TextureResidency::EvictionCount;
+}
+
+unsigned int TextureResidency::GetReloadCount() {
+    return TextureResidency::ReloadCount;
+}
+
+void TextureResidency::ResetCounters() {
+    TextureResidency::EvictionCount = 0;
+    TextureResidency::ReloadCount = 0;
+}
+
+void TextureResidency::Register(Texture* texture) {
+    unsigned int textureID = texture->m_TextureID;
+    if (textureID >= TextureResidency::Entries.size()) {
+        Entry empty = {nullptr, 0};
+        TextureResidency::Entries.resize(textureID + 1, empty);
+    }
+    Entry& entry = TextureResidency::Entries[textureID];
+    if (entry.texture == nullptr) {
+        TextureResidency::TrackedCount++;
+    }
+    entry.texture = texture;
+    // A texture that was just loaded counts as used, otherwise it would be the first one evicted
+    entry.lastUsedFrame = TextureResidency::CurrentFrame;
+}
+
+void TextureResidency::Unregister(Texture* texture) {
+    unsigned int textureID = texture->m_TextureID;
+    if (textureID < TextureResidency::Entries.size() && TextureResidency::Entries[textureID].texture == texture) {
+        TextureResidency::Entries[textureID].texture = nullptr;
+        TextureResidency::TrackedCount--;
+    }
+}
+
+void TextureResidency::MarkUsed(unsigned int textureID) {
+    if (textureID >= TextureResidency::Entries.size()) {
+        return;
+    }
+    Entry& entry = TextureResidency::Entries[textureID];
+    if (entry.texture == nullptr) {
+        return;
+    }
+    if (entry.texture->m_Evicted) {
+        entry.texture->reload();
+        TextureResidency::ReloadCount++;
+    }
+    entry.lastUsedFrame = TextureResidency::CurrentFrame;
+}
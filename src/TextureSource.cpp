@@ -0,0 +1,66 @@
+#include "Mantaray/Core/TextureSource.hpp"
+#include "Mantaray/Core/FileSystem.hpp"
+#include "Mantaray/Core/Logger.hpp"
+
+using namespace MR;
+
+static const size_t PageSize = 4096;
+
+// Reads one byte of every page so the disk reads happen on the loading thread instead of during upload
+static void touchPages(TextureContainer& container) {
+    volatile unsigned char sink = 0;
+    for (unsigned int level = 0; level < container.getLevelCount(); level++) {
+        const unsigned char* data = container.getLevelData(level);
+        size_t size = container.getLevelByteSize(level);
+        for (size_t offset = 0; offset < size; offset += PageSize) {
+            sink = sink + data[offset];
+        }
+    }
+}
+
+TextureSource::TextureSource() {
+}
+
+TextureSource::TextureSource(std::string pathToTexture) {
+    load(pathToTexture);
+}
+
+bool TextureSource::load(std::string pathToTexture) {
+    m_Path = pathToTexture;
+    m_Container.close();
+    m_Image.unloadData();
+    m_PackStorage.clear();
+
+    // Packs are build outputs, a cooked texture inside one is always current
+    const unsigned char* packedData = nullptr;
+    size_t packedSize = 0;
+    std::string cookedName = TextureContainer::GetCookedPath(pathToTexture);
+    if (FileSystem::ReadPackedFile(cookedName, packedData, packedSize, m_PackStorage) &&
+        m_Container.open(packedData, packedSize, cookedName)) {
+        return true;
+    }
+
+    std::string sourcePath = FileSystem::GetWorkingDirectory() + pathToTexture;
+    std::string cookedPath = TextureContainer::GetCookedPath(sourcePath);
+    if (TextureContainer::IsFresh(sourcePath, cookedPath)) {
+        if (m_Container.open(cookedPath)) {
+            touchPages(m_Container);
+            return true;
+        }
+        Logger::Log("Texture", "Falling back to source image for " + pathToTexture, Logger::LOG_WARNING);
+    }
+    return decodeImage();
+}
+
+bool TextureSource::decodeImage() {
+    m_Image.loadFromFile(m_Path);
+    return m_Image.getWidth() > 0;
+}
+
+bool TextureSource::isLoaded() {
+    return m_Container.isOpen() || m_Image.getWidth() > 0;
+}
+
+std::string TextureSource::getPath() {
+    return m_Path;
+}
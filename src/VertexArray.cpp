@@ -1,6 +1,7 @@
 #include <glad/glad.h>
 
 #include "Mantaray/OpenGL/Context.hpp"
+#include "Mantaray/OpenGL/FrameStatistics.hpp"
 #include "Mantaray/OpenGL/Objects/VertexArray.hpp"
 
 using namespace MR;
@@ -39,25 +40,36 @@ void VertexArray::unbind() {
     Context::BindVertexArray(0);
 }
 
+Object::ObjectType VertexArray::getObjectType() {
+    return Object::OBJECT_VERTEX_ARRAY;
+}
+
 void VertexArray::uploadVertexArrayData() {
     bind();
+    size_t byteSize = sizeof(float) * m_Vertices.size() * 2;
 
     glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(float) * m_Vertices.size() * 2, &m_Vertices[0], GL_STATIC_DRAW);
+    FrameStatistics::AddBufferUpload(sizeof(float) * m_Vertices.size() * 2);
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);
 
     if (m_UsesIndices) {
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * m_Indices.size(), &m_Indices[0], GL_STATIC_DRAW);
+        FrameStatistics::AddBufferUpload(sizeof(unsigned int) * m_Indices.size());
+        byteSize += sizeof(unsigned int) * m_Indices.size();
     }
 
     if(m_UsesTextureCoordinates) {
         glBindBuffer(GL_ARRAY_BUFFER, m_TCBO);
         glBufferData(GL_ARRAY_BUFFER, sizeof(float) * m_TextureCoordinates.size() * 2, &m_TextureCoordinates[0], GL_STATIC_DRAW);
+        FrameStatistics::AddBufferUpload(sizeof(float) * m_TextureCoordinates.size() * 2);
         glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
         glEnableVertexAttribArray(1);
+        byteSize += sizeof(float) * m_TextureCoordinates.size() * 2;
     }
+    setByteSize(byteSize);
 }
 
 void VertexArray::draw() {
@@ -65,9 +77,11 @@ void VertexArray::draw() {
 
     if (m_UsesIndices) {
         glDrawElements(GL_TRIANGLES, m_Indices.size(), GL_UNSIGNED_INT, (void*)0);
+        FrameStatistics::AddDrawCall(m_Vertices.size(), m_Indices.size());
     }
     else {
         glDrawArrays(GL_TRIANGLES, 0, m_Vertices.size());
+        FrameStatistics::AddDrawCall(m_Vertices.size(), 0);
     }
 }
 
@@ -1,17 +1,29 @@
+#include <algorithm>
+
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/matrix.hpp>
 
 #include "Mantaray/Core/Window.hpp"
+#include "Mantaray/Core/FramePacer.hpp"
 #include "Mantaray/Core/InputManager.hpp"
+#include "Mantaray/Core/InputRecording.hpp"
+#include "Mantaray/Core/SceneGraph.hpp"
 #include "Mantaray/OpenGL/Objects/Canvas.hpp"
 #include "Mantaray/OpenGL/ObjectChain.hpp"
 #include "Mantaray/OpenGL/ObjectLibrary.hpp"
 #include "Mantaray/OpenGL/Context.hpp"
+#include "Mantaray/OpenGL/RenderThread.hpp"
+#include "Mantaray/OpenGL/TextureResidency.hpp"
+#include "Mantaray/OpenGL/SpriteRenderer.hpp"
 
 using namespace MR;
 
+// Without low latency mode fences are only polled, older frames are forgotten past this many
+static const unsigned int MaxTrackedFrames = 4;
+static const GLuint64 FenceTimeout = 100000000;
+
 Window* Window::Instance = nullptr;
 
 Window::Window() {}
@@ -47,8 +59,9 @@ void Window::initialize(std::string title, Vector2u size, Vector2u resolution, V
     m_lastWindowedPosition = getPosition();
     calculateViewDestination(size.x, size.y);
     m_DisplayBuffer = new Canvas(resolution, coordinateScale);
-    ObjectLibrary::FindObject("DefaultTexturedShader", m_DisplayShader);
+    m_DisplayShader = ObjectLibrary::DefaultTexturedShader;
     m_Timer.start();
+    m_FrameTimer.start();
 }
 
 Window*& Window::GetInstance() {
@@ -56,6 +69,11 @@ Window*& Window::GetInstance() {
 }
 
 Window::~Window() {
+    RenderThread::Stop();
+    InputRecording::StopRecording();
+    for (InFlightFrame& frame : m_FramesInFlight) {
+        glDeleteSync(frame.fence);
+    }
     delete m_DisplayBuffer;
     if (m_DisplayShader != ObjectLibrary::DefaultTexturedShader) {
         delete m_DisplayShader;
@@ -86,9 +104,30 @@ void Window::restore() {
 }
 
 float Window::update() {
+    // Events are still polled during a replay to keep the window responsive, the InputManager ignores them
     glfwPollEvents();
+    m_InputTime = glfwGetTime();
     float deltaTime = m_Timer.getDelta();
+    if (InputRecording::IsReplaying() && !InputRecording::ReplayFrame(deltaTime)) {
+        InputRecording::StopReplay();
+        if (InputRecording::ShouldCloseWhenDone()) {
+            setShouldClose();
+        }
+    }
+    bool unthrottled = InputRecording::IsUnthrottled();
+    if (unthrottled != m_Unthrottled) {
+        if (unthrottled) {
+            m_SwapIntervalBeforeReplay = Context::GetSwapInterval();
+        }
+        Context::SetSwapInterval(unthrottled ? 0 : m_SwapIntervalBeforeReplay);
+        m_Unthrottled = unthrottled;
+    }
+
     MR::InputManager::Update(deltaTime);
+    FramePacer::Accumulate(deltaTime);
+    if (InputRecording::IsRecording()) {
+        InputRecording::RecordFrame(deltaTime, MR::InputManager::GetEvents(), glfwGetTime());
+    }
     return deltaTime;
 }
 
@@ -97,38 +136,112 @@ void Window::beginFrame() {
 }
 
 void Window::endFrame() {
-    display();
+    PresentInfo present = preparePresent();
+    if (RenderThread::IsRunning()) {
+        // The limiter paces the game thread, the render thread follows the packets it submits
+        if (!m_Unthrottled) {
+            FramePacer::WaitForNextFrame();
+        }
+        present.frameTime = m_FrameTimer.getDelta();
+        RenderThread::Submit(present);
+        return;
+    }
+
+    presentFrame(present);
+    if (!m_Unthrottled) {
+        FramePacer::WaitForNextFrame();
+    }
+    present.frameTime = m_FrameTimer.getDelta();
+    finishFrame(present);
+}
+
+// Everything read from the window happens on the calling thread, GLFW only allows it on the main thread
+PresentInfo Window::preparePresent() {
+    if (m_LowLatency) {
+        InputManager::LatchMousePosition();
+    }
+    if (m_CursorSprite != nullptr) {
+        m_CursorSprite->position = m_DisplayBuffer->getMousePosition();
+        m_DisplayBuffer->draw(*m_CursorSprite);
+    }
+    PresentInfo present;
+    present.windowSize = getSize();
+    present.viewportRect = m_ViewportRect;
+    present.displayShader = m_DisplayShader;
+    present.inputTime = m_InputTime;
+    return present;
+}
+
+void Window::presentFrame(const PresentInfo& present) {
+    display(present);
+    Context::ApplyPendingSwapInterval();
     glfwSwapBuffers(m_Window);
+    limitFramesInFlight(present.inputTime);
 }
 
-void Window::display() {    
+void Window::finishFrame(const PresentInfo& present) {
+    {
+        std::lock_guard<std::mutex> lock(FrameStatistics::GetMutex());
+        FrameStatistics::EndFrame(present.frameTime);
+    }
+    TextureResidency::EndFrame();
+}
+
+void Window::display(const PresentInfo& present) {
+    Shader* displayShader = present.displayShader;
+    Rectanglei viewportRect = present.viewportRect;
     m_DisplayBuffer->unbind();
-    glViewport(0, 0, getSize().x, getSize().y);
+    glViewport(0, 0, present.windowSize.x, present.windowSize.y);
     glClearColor(0.f, 0.f, 0.f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 
     glm::mat4 projection = glm::ortho(
         static_cast<float>(0),
-        static_cast<float>(getSize().x),
+        static_cast<float>(present.windowSize.x),
         static_cast<float>(0),
-        static_cast<float>(getSize().y),
+        static_cast<float>(present.windowSize.y),
         -1.0f, 1.0f
     );
-    m_DisplayShader->setUniformMatrix4("u_projectionMatrix", projection);
+    displayShader->setUniformMatrix4("u_projectionMatrix", projection);
 
     glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(m_ViewportRect.x(), m_ViewportRect.y(), 0.0f));
+    model = glm::translate(model, glm::vec3(viewportRect.x(), viewportRect.y(), 0.0f));
 
-    model = glm::scale(model, glm::vec3(m_ViewportRect.width(), m_ViewportRect.height(), 1.0f));
+    model = glm::scale(model, glm::vec3(viewportRect.width(), viewportRect.height(), 1.0f));
 
-    m_DisplayShader->setUniformMatrix4("u_modelMatrix", model);
-    m_DisplayShader->setUniformVector4f("u_textureSource", Vector4f(0, 0, 1, 1));
-    m_DisplayShader->setRenderTexture("u_texture0", 0, *m_DisplayBuffer);
-    m_DisplayShader->setUniformVector4f("u_color", Vector4f(1, 1, 1, 1));
-    m_DisplayShader->setupForDraw();
+    displayShader->setUniformMatrix4("u_modelMatrix", model);
+    displayShader->setUniformVector4f("u_textureSource", Vector4f(0, 0, 1, 1));
+    displayShader->setRenderTexture("u_texture0", 0, *m_DisplayBuffer);
+    displayShader->setUniformVector4f("u_color", Vector4f(1, 1, 1, 1));
+    displayShader->setupForDraw();
     RenderTexture::DefaultVertexArray->draw();
 }
 
+void Window::limitFramesInFlight(double inputTime) {
+    InFlightFrame frame;
+    frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frame.inputTime = inputTime;
+    m_FramesInFlight.push_back(frame);
+
+    while (!m_FramesInFlight.empty()) {
+        InFlightFrame& oldest = m_FramesInFlight.front();
+        bool mustWait = m_LowLatency && m_FramesInFlight.size() > m_MaxFramesInFlight;
+        GLenum status = glClientWaitSync(oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, mustWait ? FenceTimeout : 0);
+        bool completed = (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED);
+        if (!completed && !mustWait && m_FramesInFlight.size() <= MaxTrackedFrames) {
+            break;
+        }
+        if (completed) {
+            FrameStatistics::GetCurrent().inputLatency = (float)(glfwGetTime() - oldest.inputTime);
+        }
+        else if (mustWait) {
+            m_Logger.Log("Timed out waiting for a frame in flight", Logger::LOG_WARNING);
+        }
+        glDeleteSync(oldest.fence);
+        m_FramesInFlight.pop_front();
+    }
+}
+
 void Window::draw(Sprite& sprite) {
     m_DisplayBuffer->draw(sprite);
 }
@@ -141,6 +254,14 @@ void Window::draw(Canvas*& canvas) {
     m_DisplayBuffer->draw(canvas);
 }
 
+void Window::draw(EntityWorld& world) {
+    SpriteRenderer::Render(world, *m_DisplayBuffer);
+}
+
+void Window::draw(SceneGraph& sceneGraph) {
+    sceneGraph.draw(*m_DisplayBuffer);
+}
+
 void Window::drawLine(Vector2f p1, Vector2f p2, float thickness, Color color) {
     m_DisplayBuffer->drawLine(p1, p2, thickness, color);
 }
@@ -226,10 +347,12 @@ void Window::setScreenShader(class Shader* screenShader) {
         m_Logger.Log("nullptr cannot be set as screenshader", Logger::LOG_WARNING);
         return;
     }
+    RenderThread::AcquireContext();
     if (m_DisplayShader != ObjectLibrary::DefaultTexturedShader) {
         delete m_DisplayShader;
     }
     m_DisplayShader = screenShader;
+    RenderThread::ReleaseContext();
 }
 
 Color Window::getClearColor() {
@@ -248,6 +371,52 @@ Rectanglei Window::getViewportRect() {
     return m_ViewportRect;
 }
 
+FrameStats Window::getFrameStats() {
+    std::lock_guard<std::mutex> lock(FrameStatistics::GetMutex());
+    return FrameStatistics::GetLastFrame();
+}
+
+FrameStats Window::getAverageFrameStats() {
+    std::lock_guard<std::mutex> lock(FrameStatistics::GetMutex());
+    return FrameStatistics::GetAverage();
+}
+
+FrameStats Window::getFrameStatsPercentile(float percentile) {
+    std::lock_guard<std::mutex> lock(FrameStatistics::GetMutex());
+    return FrameStatistics::GetPercentile(percentile);
+}
+
+void Window::setFrameStatsHistorySize(unsigned int frameCount) {
+    std::lock_guard<std::mutex> lock(FrameStatistics::GetMutex());
+    FrameStatistics::SetHistorySize(frameCount);
+}
+
+void Window::setLowLatencyMode(bool enabled, unsigned int maxFramesInFlight) {
+    m_LowLatency = enabled;
+    m_MaxFramesInFlight = std::min(std::max(maxFramesInFlight, 1u), MaxTrackedFrames);
+}
+
+bool Window::getLowLatencyMode() {
+    return m_LowLatency;
+}
+
+void Window::setCursorSprite(Sprite* cursorSprite) {
+    m_CursorSprite = cursorSprite;
+}
+
+void Window::setThreadedRendering(bool enabled, unsigned int packetCount) {
+    if (enabled && !RenderThread::IsRunning()) {
+        RenderThread::Start(m_Window, packetCount);
+    }
+    else if (!enabled) {
+        RenderThread::Stop();
+    }
+}
+
+bool Window::getThreadedRendering() {
+    return RenderThread::IsRunning();
+}
+
 void Window::OnWindowResized(GLFWwindow* window, int width, int height) {
     Window::Instance->calculateViewDestination(width, height);
 }
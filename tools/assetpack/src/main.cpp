@@ -0,0 +1,120 @@
+#include "Mantaray/Core/AssetPack.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+using namespace MR;
+
+void PrintUsage() {
+    std::cout << "Usage: assetpack [options] -o <pack> <directory>..." << std::endl;
+    std::cout << "Packs every file below the given directories, entry names are relative to their directory." << std::endl;
+    std::cout << std::endl;
+    std::cout << "  --store             Do not LZ4 compress entries" << std::endl;
+}
+
+void CollectFiles(std::string directory, std::string prefix, std::vector<AssetPack::Source>& sources) {
+#ifdef _WIN32
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((directory + "\\*").c_str(), &data);
+    if (find == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    do {
+        std::string name = data.cFileName;
+        if (name == "." || name == "..") {
+            continue;
+        }
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            CollectFiles(directory + "\\" + name, prefix + name + "/", sources);
+        }
+        else {
+            sources.push_back({prefix + name, directory + "\\" + name});
+        }
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    while (dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") {
+            continue;
+        }
+        std::string path = directory + "/" + name;
+        struct stat status;
+        if (stat(path.c_str(), &status) != 0) {
+            continue;
+        }
+        if (S_ISDIR(status.st_mode)) {
+            CollectFiles(path, prefix + name + "/", sources);
+        }
+        else if (S_ISREG(status.st_mode)) {
+            sources.push_back({prefix + name, path});
+        }
+    }
+    closedir(dir);
+#endif
+}
+
+int main(int argc, char** argv) {
+    bool compress = true;
+    std::string output = "";
+    std::vector<std::string> directories;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--store") == 0) {
+            compress = false;
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            output = argv[++i];
+        }
+        else if (argv[i][0] == '-') {
+            PrintUsage();
+            return 1;
+        }
+        else {
+            directories.push_back(argv[i]);
+        }
+    }
+    if (output.empty() || directories.empty()) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::vector<AssetPack::Source> sources;
+    for (std::string& directory : directories) {
+        CollectFiles(directory, "", sources);
+    }
+    // Keeps packs reproducible regardless of directory iteration order
+    std::sort(sources.begin(), sources.end(), [](const AssetPack::Source& a, const AssetPack::Source& b) {
+        return a.name < b.name;
+    });
+
+    if (!AssetPack::Write(output, sources, compress)) {
+        return 1;
+    }
+
+    AssetPack pack = AssetPack(output);
+    size_t originalSize = 0, storedSize = 0;
+    for (AssetPack::Source& source : sources) {
+        const AssetPack::Entry* entry = pack.findEntry(source.name);
+        if (entry != nullptr) {
+            originalSize += entry->size;
+            storedSize += entry->storedSize;
+        }
+    }
+    std::cout << output << ": " << pack.getEntryCount() << " entries, " << originalSize << " -> " << storedSize << " bytes" << std::endl;
+    return 0;
+}
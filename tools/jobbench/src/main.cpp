@@ -0,0 +1,129 @@
+#include "Mantaray/Core/JobSystem.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace MR;
+
+void PrintUsage() {
+    std::cout << "Usage: jobbench [options]" << std::endl;
+    std::cout << "Runs a fixed ParallelFor workload with 1 to N threads and prints the speedup over one thread." << std::endl;
+    std::cout << std::endl;
+    std::cout << "  --threads <n>       Highest thread count to measure (default: hardware threads)" << std::endl;
+    std::cout << "  --items <n>         Items per pass (default: 1048576)" << std::endl;
+    std::cout << "  --work <n>          Hash rounds per item, higher is more compute bound (default: 64)" << std::endl;
+    std::cout << "  --grain <n>         ParallelFor grain size (default: 1024)" << std::endl;
+    std::cout << "  --repeat <n>        Passes per thread count, the fastest counts (default: 10)" << std::endl;
+}
+
+// Compute bound so the measurement shows scheduling overhead rather than memory bandwidth
+uint32_t HashItem(uint32_t value, unsigned int rounds) {
+    for (unsigned int i = 0; i < rounds; i++) {
+        value ^= value >> 16;
+        value *= 0x7FEB352Du;
+        value ^= value >> 15;
+        value *= 0x846CA68Bu;
+        value ^= value >> 16;
+    }
+    return value;
+}
+
+// One thread runs the loop directly, Initialize(0) would start the default worker count
+double RunPass(std::vector<uint32_t>& output, unsigned int rounds, unsigned int grain, bool serial) {
+    auto hashRange = [&output, rounds](unsigned int begin, unsigned int end) {
+        for (unsigned int i = begin; i < end; i++) {
+            output[i] = HashItem(i, rounds);
+        }
+    };
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (serial) {
+        hashRange(0, output.size());
+    }
+    else {
+        JobSystem::ParallelFor(output.size(), grain, hashRange);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main(int argc, char** argv) {
+    unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int itemCount = 1 << 20;
+    unsigned int rounds = 64;
+    unsigned int grain = 1024;
+    unsigned int repeat = 10;
+
+    for (int i = 1; i < argc; i++) {
+        unsigned int* value = nullptr;
+        if (strcmp(argv[i], "--threads") == 0) {
+            value = &maxThreads;
+        }
+        else if (strcmp(argv[i], "--items") == 0) {
+            value = &itemCount;
+        }
+        else if (strcmp(argv[i], "--work") == 0) {
+            value = &rounds;
+        }
+        else if (strcmp(argv[i], "--grain") == 0) {
+            value = &grain;
+        }
+        else if (strcmp(argv[i], "--repeat") == 0) {
+            value = &repeat;
+        }
+        if (value == nullptr || i + 1 >= argc || atoi(argv[i + 1]) < 1) {
+            PrintUsage();
+            return 1;
+        }
+        *value = atoi(argv[++i]);
+    }
+
+    std::vector<uint32_t> output(itemCount);
+    std::vector<uint32_t> reference(itemCount);
+    for (unsigned int i = 0; i < itemCount; i++) {
+        reference[i] = HashItem(i, rounds);
+    }
+
+    std::cout << "items " << itemCount << ", work " << rounds << ", grain " << grain << ", hardware threads " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "threads      best ms   speedup   efficiency" << std::endl;
+    double singleThread = 0;
+    bool mismatch = false;
+    for (unsigned int threads = 1; threads <= maxThreads; threads++) {
+        bool serial = threads == 1;
+        if (!serial) {
+            JobSystem::Shutdown();
+            JobSystem::Initialize(threads - 1);
+        }
+        std::fill(output.begin(), output.end(), 0);
+        // Warms up the workers and the output pages
+        RunPass(output, rounds, grain, serial);
+
+        double best = 0;
+        for (unsigned int pass = 0; pass < repeat; pass++) {
+            double time = RunPass(output, rounds, grain, serial);
+            best = pass == 0 ? time : std::min(best, time);
+        }
+        mismatch = mismatch || output != reference;
+        if (threads == 1) {
+            singleThread = best;
+        }
+        double speedup = singleThread / best;
+        std::cout << std::setw(7) << threads
+                  << std::fixed << std::setprecision(3) << std::setw(13) << best
+                  << std::setprecision(2) << std::setw(10) << speedup
+                  << std::setprecision(0) << std::setw(12) << speedup / threads * 100 << "%" << std::endl;
+    }
+    JobSystem::Shutdown();
+
+    if (mismatch) {
+        std::cout << "Parallel results differ from the serial reference!" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,212 @@
+#include "Mantaray/Core/BlockCompressor.hpp"
+#include "Mantaray/Core/Image.hpp"
+#include "Mantaray/Core/TextureContainer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace MR;
+
+void PrintUsage() {
+    std::cout << "Usage: texcook [options] <image>..." << std::endl;
+    std::cout << "Writes <image>.mrtex next to every source image." << std::endl;
+    std::cout << std::endl;
+    std::cout << "  --mips              Store a full mip chain" << std::endl;
+    std::cout << "  --filter <name>     Mip filter: box (default), bilinear, mitchell, lanczos" << std::endl;
+    std::cout << "  --linear            Filter mips without gamma correction (data textures)" << std::endl;
+    std::cout << "  --channels <1-4>    Convert to the given channel count before cooking" << std::endl;
+    std::cout << "  --format <name>     Storage format: raw (default), bc1, bc3, bc4" << std::endl;
+    std::cout << "  --threads <n>       Threads used for block compression (default: all)" << std::endl;
+    std::cout << "  --stats             Measure the cooking steps and the block compression PSNR instead of writing files" << std::endl;
+}
+
+bool ParseFilter(const char* name, ResampleFilter& filter) {
+    if (strcmp(name, "box") == 0) filter = FILTER_BOX;
+    else if (strcmp(name, "bilinear") == 0) filter = FILTER_BILINEAR;
+    else if (strcmp(name, "mitchell") == 0) filter = FILTER_MITCHELL;
+    else if (strcmp(name, "lanczos") == 0) filter = FILTER_LANCZOS;
+    else return false;
+    return true;
+}
+
+bool ParseFormat(const char* name, TextureContainer::PixelFormat& format) {
+    if (strcmp(name, "raw") == 0) format = TextureContainer::PIXEL_FORMAT_UNORM8;
+    else if (strcmp(name, "bc1") == 0) format = TextureContainer::PIXEL_FORMAT_BC1;
+    else if (strcmp(name, "bc3") == 0) format = TextureContainer::PIXEL_FORMAT_BC3;
+    else if (strcmp(name, "bc4") == 0) format = TextureContainer::PIXEL_FORMAT_BC4;
+    else return false;
+    return true;
+}
+
+// Fastest of a few runs after a warm up, in milliseconds
+template<typename Function>
+double MeasureBest(const Function& function) {
+    const unsigned int repeat = 5;
+    function();
+    double best = 0;
+    for (unsigned int i = 0; i < repeat; i++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        double time = std::chrono::duration<double, std::milli>(end - start).count();
+        best = i == 0 ? time : std::min(best, time);
+    }
+    return best;
+}
+
+void PrintMeasurement(std::string name, double milliseconds, size_t bytes) {
+    std::cout << "  " << std::left << std::setw(18) << name << std::right
+              << std::fixed << std::setprecision(3) << std::setw(10) << milliseconds << " ms"
+              << std::setprecision(1) << std::setw(10) << bytes / (milliseconds * 1000.) << " MB/s";
+}
+
+// Throughput is given in source bytes per second
+void PrintStats(Image& image, ResampleFilter filter, bool gammaCorrect, unsigned int threadCount) {
+    Vector2u size = Vector2u(image.getWidth(), image.getHeight());
+    int nrChannels = image.getNrChannels();
+    size_t pixelCount = (size_t)size.x * size.y;
+    size_t bytes = pixelCount * nrChannels;
+    std::cout << size.x << "x" << size.y << ", " << nrChannels << " channel" << (nrChannels > 1 ? "s" : "") << std::endl;
+
+    Image target;
+    PrintMeasurement("flip", MeasureBest([&]() { image.flipVertically(target); }), bytes);
+    std::cout << std::endl;
+    for (int channels = 1; channels <= 4; channels++) {
+        if (channels != nrChannels) {
+            PrintMeasurement("convert " + std::to_string(nrChannels) + " -> " + std::to_string(channels), MeasureBest([&]() { image.convertChannels(channels, target); }), bytes);
+            std::cout << std::endl;
+        }
+    }
+    if (nrChannels == 4) {
+        PrintMeasurement("premultiply", MeasureBest([&]() { image.premultiplyAlpha(target); }), bytes);
+        std::cout << std::endl;
+        PrintMeasurement("swizzle bgra", MeasureBest([&]() { image.swizzle(2, 1, 0, 3, target); }), bytes);
+        std::cout << std::endl;
+    }
+
+    Vector2u halfSize = Vector2u(std::max(size.x / 2, 1u), std::max(size.y / 2, 1u));
+    PrintMeasurement("resize to half", MeasureBest([&]() { image.resize(halfSize, filter, target, gammaCorrect); }), bytes);
+    std::cout << std::endl;
+    std::vector<Image> mipChain;
+    PrintMeasurement("mip chain", MeasureBest([&]() { image.generateMipChain(mipChain, filter, gammaCorrect); }), bytes);
+    std::cout << std::endl;
+
+    // Decompressed blocks have 4 channels, the source is compared in the same layout.
+    // Rows are stored bottom up, so the bottom row starts the pixel data.
+    Image reference;
+    image.convertChannels(4, reference);
+    const unsigned char* pixels = image.getRow(size.y - 1);
+    std::vector<unsigned char> blocks;
+    std::vector<unsigned char> decoded(pixelCount * 4);
+    const BlockFormat formats[] = { BLOCK_FORMAT_BC1, BLOCK_FORMAT_BC3, BLOCK_FORMAT_BC4 };
+    const char* formatNames[] = { "bc1", "bc3", "bc4" };
+    const int comparedChannels[] = { 3, 4, 1 };
+    for (int i = 0; i < 3; i++) {
+        double time = MeasureBest([&]() { BlockCompressor::Compress(pixels, size, nrChannels, formats[i], blocks, threadCount); });
+        BlockCompressor::Decompress(&blocks[0], size, formats[i], &decoded[0]);
+        double psnr = BlockCompressor::ComputePSNR(reference.getRow(size.y - 1), &decoded[0], pixelCount, comparedChannels[i]);
+        PrintMeasurement(formatNames[i], time, bytes);
+        std::cout << std::setprecision(2) << std::setw(10) << psnr << " dB PSNR" << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    bool generateMips = false;
+    bool gammaCorrect = true;
+    int nrChannels = 0;
+    unsigned int threadCount = 0;
+    bool stats = false;
+    ResampleFilter filter = FILTER_BOX;
+    TextureContainer::PixelFormat format = TextureContainer::PIXEL_FORMAT_UNORM8;
+    std::vector<std::string> sources;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mips") == 0) {
+            generateMips = true;
+        }
+        else if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        }
+        else if (strcmp(argv[i], "--linear") == 0) {
+            gammaCorrect = false;
+        }
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            if (!ParseFilter(argv[++i], filter)) {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            if (!ParseFormat(argv[++i], format)) {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--channels") == 0 && i + 1 < argc) {
+            nrChannels = atoi(argv[++i]);
+            if (nrChannels < 1 || nrChannels > 4) {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            int value = atoi(argv[++i]);
+            if (value < 1) {
+                PrintUsage();
+                return 1;
+            }
+            threadCount = value;
+        }
+        else if (argv[i][0] == '-') {
+            PrintUsage();
+            return 1;
+        }
+        else {
+            sources.push_back(argv[i]);
+        }
+    }
+    if (sources.empty()) {
+        PrintUsage();
+        return 1;
+    }
+
+    int failed = 0;
+    for (std::string& source : sources) {
+        Image image;
+        image.loadFromFile(source, true, true);
+        if (image.getNrChannels() == 0) {
+            failed++;
+            continue;
+        }
+        if (nrChannels != 0 && nrChannels != image.getNrChannels()) {
+            image.convertChannels(nrChannels);
+        }
+        if (stats) {
+            std::cout << source << ": ";
+            PrintStats(image, filter, gammaCorrect, threadCount);
+            continue;
+        }
+
+        std::vector<Image> mipChain;
+        if (generateMips) {
+            image.generateMipChain(mipChain, filter, gammaCorrect);
+        }
+        else {
+            mipChain.push_back(std::move(image));
+        }
+
+        std::string cookedPath = TextureContainer::GetCookedPath(source);
+        if (!TextureContainer::Write(cookedPath, mipChain, format, threadCount)) {
+            failed++;
+            continue;
+        }
+        std::cout << source << " -> " << cookedPath << " (" << mipChain.size() << " level" << (mipChain.size() > 1 ? "s" : "") << ")" << std::endl;
+    }
+    return failed == 0 ? 0 : 1;
+}